@@ -0,0 +1,208 @@
+#include "pch.h"
+#include "AssetLoader.h"
+#include <filesystem>
+#include <future>
+#include <iomanip>
+#include "AssetRegistry.h"
+#include "Mesh.h"
+#include "Texture.h"
+#include "ThreadPool.h"
+
+AssetLoader::AssetLoader(ThreadPool* pThreadPool, AssetRegistry* pRegistry)
+	: m_pThreadPool{ pThreadPool }
+	, m_pRegistry{ pRegistry }
+	, m_SharedRequests{}
+{
+}
+
+void AssetLoader::AddTexture(std::shared_ptr<Texture>& pTarget, const std::string& filePath, TextureFormat format)
+{
+	AddShared(m_TextureSlots, pTarget, filePath, AssetRegistry::HashTextureParameters(format),
+		[filePath, format]() { return std::make_shared<Texture>(filePath, format); });
+}
+
+void AssetLoader::AddMesh(std::shared_ptr<Mesh>& pTarget, const std::string& filePath, const Elite::FVector3& position, bool isTransparent)
+{
+	AddShared(m_MeshSlots, pTarget, filePath, AssetRegistry::HashMeshParameters(isTransparent),
+		[filePath, position, isTransparent, pThreadPool = m_pThreadPool]() { return std::make_shared<Mesh>(filePath, position, isTransparent, pThreadPool); });
+}
+
+template<typename Type, typename Create>
+void AssetLoader::AddShared(std::unordered_map<std::string, std::shared_ptr<Slot<Type>>>& slots, std::shared_ptr<Type>& pTarget, const std::string& filePath, uint64_t parameterHash, Create create)
+{
+	const std::string key{ AssetRegistry::MakeKey(filePath, parameterHash) };
+	if ((pTarget = m_pRegistry->Find<Type>(key)))
+	{
+		++m_SharedRequests;
+		return;
+	}
+
+	// Requested twice in the same batch, the second request waits on the first one
+	const auto it = slots.find(key);
+	if (it != slots.end())
+	{
+		it->second->pTargets.push_back(&pTarget);
+		++m_SharedRequests;
+		return;
+	}
+
+	std::shared_ptr<Slot<Type>> pSlot{ std::make_shared<Slot<Type>>(Slot<Type>{ key, 0, nullptr, { &pTarget } }) };
+	slots.emplace(key, pSlot);
+
+	std::error_code error;
+	uintmax_t fileSize{ std::filesystem::file_size(filePath, error) };
+	if (error)
+		fileSize = 0;
+
+	AssetRegistry* pRegistry{ m_pRegistry };
+	m_Assets.push_back(Asset{ filePath, fileSize,
+		[pSlot, pRegistry, parameterHash, create]()
+		{
+			// The decoder hashes the bytes it reads, a copy under another name is shared instead of uploaded
+			pSlot->pAsset = create();
+			pSlot->contentHash = AssetRegistry::HashContent(parameterHash, pSlot->pAsset->GetSourceHash());
+			return !pSlot->pAsset->IsLoaded() || !pRegistry->FindByContent<Type>(pSlot->key, pSlot->contentHash);
+		},
+		[pSlot, pRegistry, filePath](ID3D11Device* pDevice)
+		{
+			// Same content decoded twice in this batch, keep the first upload and drop this copy
+			std::shared_ptr<Type> pRegistered{ pRegistry->Find<Type>(pSlot->key) };
+			if (!pRegistered)
+				pRegistered = pRegistry->FindByContent<Type>(pSlot->key, pSlot->contentHash);
+
+			// A failed load is handed out but not registered, so a later load tries again
+			if (pRegistered)
+				pSlot->pAsset = pRegistered;
+			else if (pSlot->pAsset->IsLoaded())
+			{
+				pSlot->pAsset->Upload(pDevice);
+				pSlot->pAsset = pRegistry->Register(pSlot->key, pSlot->contentHash, filePath, pSlot->pAsset);
+			}
+
+			for (std::shared_ptr<Type>* pSlotTarget : pSlot->pTargets)
+				*pSlotTarget = pSlot->pAsset;
+		},
+		nullptr, 0.f, 0.f, false });
+}
+
+void AssetLoader::Load(ID3D11Device* pDevice)
+{
+	const Clock::time_point loadStart{ Clock::now() };
+
+	// Biggest files first, so the longest decode doesn't start last and stretch the wall time
+	std::vector<size_t> order(m_Assets.size());
+	for (size_t i{}; i < order.size(); ++i)
+		order[i] = i;
+	std::sort(order.begin(), order.end(), [this](size_t a, size_t b) { return m_Assets[a].fileSize > m_Assets[b].fileSize; });
+
+	std::vector<std::future<void>> jobs;
+	jobs.reserve(order.size());
+	for (size_t index : order)
+	{
+		jobs.push_back(m_pThreadPool->Enqueue([this, index]()
+			{
+				// The index is always pushed, a throwing decode would otherwise leave the upload loop waiting forever
+				const Clock::time_point decodeStart{ Clock::now() };
+				try
+				{
+					m_Assets[index].isShared = !m_Assets[index].decode();
+				}
+				catch (...)
+				{
+					m_Assets[index].pError = std::current_exception();
+				}
+				m_Assets[index].decodeMs = GetElapsedMs(decodeStart);
+
+				{
+					std::lock_guard lock{ m_Mutex };
+					m_DecodedAssets.push(index);
+				}
+				m_AssetDecoded.notify_one();
+			}));
+	}
+
+	// The device is only touched from this thread, uploads happen as soon as an asset is decoded
+	for (size_t uploaded{}; uploaded < m_Assets.size(); ++uploaded)
+	{
+		size_t index;
+		{
+			std::unique_lock lock{ m_Mutex };
+			m_AssetDecoded.wait(lock, [this]() { return !m_DecodedAssets.empty(); });
+			index = m_DecodedAssets.front();
+			m_DecodedAssets.pop();
+		}
+
+		if (m_Assets[index].pError)
+			continue;
+
+		const Clock::time_point uploadStart{ Clock::now() };
+		m_Assets[index].upload(pDevice);
+		m_Assets[index].uploadMs = GetElapsedMs(uploadStart);
+	}
+
+	for (std::future<void>& job : jobs)
+		job.get();
+
+	PrintTimings(GetElapsedMs(loadStart));
+
+	std::exception_ptr pFirstError;
+	for (const Asset& asset : m_Assets)
+	{
+		if (!asset.pError)
+			continue;
+
+		std::cout << "Error decoding " << asset.filePath << ": " << GetErrorMessage(asset.pError) << std::endl;
+		if (!pFirstError)
+			pFirstError = asset.pError;
+	}
+
+	m_Assets.clear();
+	m_TextureSlots.clear();
+	m_MeshSlots.clear();
+	m_SharedRequests = 0;
+
+	if (pFirstError)
+		std::rethrow_exception(pFirstError);
+}
+
+void AssetLoader::PrintTimings(float wallMs) const
+{
+	float totalDecodeMs{};
+	float totalUploadMs{};
+
+	std::cout << "Asset loading (" << m_pThreadPool->GetThreadCount() << " threads)" << std::endl;
+	std::cout << std::fixed << std::setprecision(2);
+	for (const Asset& asset : m_Assets)
+	{
+		std::cout << "  " << std::left << std::setw(40) << asset.filePath << std::right
+			<< " decode " << std::setw(8) << asset.decodeMs << " ms"
+			<< "  upload " << std::setw(8) << asset.uploadMs << " ms"
+			<< (asset.isShared ? "  (shared by content)" : "") << std::endl;
+		totalDecodeMs += asset.decodeMs;
+		totalUploadMs += asset.uploadMs;
+	}
+	std::cout << "  Sum: decode " << totalDecodeMs << " ms, upload " << totalUploadMs << " ms" << std::endl;
+	std::cout << "  Wall time: " << wallMs << " ms, " << m_SharedRequests << " requests shared" << std::endl;
+	std::cout << std::defaultfloat;
+}
+
+std::string AssetLoader::GetErrorMessage(const std::exception_ptr& pError)
+{
+	try
+	{
+		std::rethrow_exception(pError);
+	}
+	catch (const std::exception& exception)
+	{
+		return exception.what();
+	}
+	catch (...)
+	{
+		return "unknown exception";
+	}
+}
+
+float AssetLoader::GetElapsedMs(Clock::time_point start)
+{
+	return std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+}
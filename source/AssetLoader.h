@@ -0,0 +1,84 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "structs.h"
+
+class AssetRegistry;
+class Mesh;
+class Texture;
+class ThreadPool;
+
+// Decodes images and parses meshes concurrently on the thread pool, the device uploads stay on the calling thread.
+// Assets are uploaded in the order they finish decoding, so the wall time is bound by the slowest asset instead of the sum.
+// Assets already resident in the registry, or requested twice, are shared instead of loaded again.
+class AssetLoader final
+{
+public:
+	AssetLoader(ThreadPool* pThreadPool, AssetRegistry* pRegistry);
+	~AssetLoader() = default;
+
+	AssetLoader(const AssetLoader&) = delete;
+	AssetLoader(AssetLoader&&) noexcept = delete;
+	AssetLoader& operator=(const AssetLoader&) = delete;
+	AssetLoader& operator=(AssetLoader&&) noexcept = delete;
+
+	// The target is only written once Load returns
+	void AddTexture(std::shared_ptr<Texture>& pTarget, const std::string& filePath, TextureFormat format = TextureFormat::rgba8);
+	void AddMesh(std::shared_ptr<Mesh>& pTarget, const std::string& filePath, const Elite::FVector3& position, bool isTransparent = false);
+
+	// Blocks until every asset is decoded and uploaded, then prints the timing breakdown.
+	// An exception thrown while decoding skips that asset, the first one is rethrown once the others are uploaded.
+	void Load(ID3D11Device* pDevice);
+
+private:
+	using Clock = std::chrono::steady_clock;
+
+	struct Asset
+	{
+		std::string filePath;
+		uintmax_t fileSize;
+		// Returns false when the registry already had the same content under another path
+		std::function<bool()> decode;
+		std::function<void(ID3D11Device*)> upload;
+		std::exception_ptr pError;
+		float decodeMs;
+		float uploadMs;
+		bool isShared;
+	};
+
+	// Shared between the decode and upload step of one asset, and every target requesting it
+	template<typename Type>
+	struct Slot
+	{
+		std::string key;
+		uint64_t contentHash;
+		std::shared_ptr<Type> pAsset;
+		std::vector<std::shared_ptr<Type>*> pTargets;
+	};
+
+	ThreadPool* m_pThreadPool;
+	AssetRegistry* m_pRegistry;
+	std::vector<Asset> m_Assets;
+	uint32_t m_SharedRequests;
+	std::unordered_map<std::string, std::shared_ptr<Slot<Texture>>> m_TextureSlots;
+	std::unordered_map<std::string, std::shared_ptr<Slot<Mesh>>> m_MeshSlots;
+
+	std::mutex m_Mutex;
+	std::condition_variable m_AssetDecoded;
+	std::queue<size_t> m_DecodedAssets;
+
+	template<typename Type, typename Create>
+	void AddShared(std::unordered_map<std::string, std::shared_ptr<Slot<Type>>>& slots, std::shared_ptr<Type>& pTarget, const std::string& filePath, uint64_t parameterHash, Create create);
+	void PrintTimings(float wallMs) const;
+
+	[[nodiscard]] static std::string GetErrorMessage(const std::exception_ptr& pError);
+	[[nodiscard]] static float GetElapsedMs(Clock::time_point start);
+};
+
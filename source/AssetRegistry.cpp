@@ -0,0 +1,171 @@
+#include "pch.h"
+#include "AssetRegistry.h"
+#include <filesystem>
+#include "Hash.h"
+#include "Mesh.h"
+#include "Texture.h"
+
+std::shared_ptr<Texture> AssetRegistry::LoadTexture(ID3D11Device* pDevice, const std::string& filePath, TextureFormat format)
+{
+	const uint64_t parameterHash{ HashTextureParameters(format) };
+	const std::string key{ MakeKey(filePath, parameterHash) };
+	if (std::shared_ptr<Texture> pTexture = Find<Texture>(key))
+		return pTexture;
+
+	return UploadAndRegister(pDevice, key, parameterHash, filePath, std::make_shared<Texture>(filePath, format));
+}
+
+std::shared_ptr<Mesh> AssetRegistry::LoadMesh(ID3D11Device* pDevice, const std::string& filePath, const Elite::FVector3& position, bool isTransparent)
+{
+	const uint64_t parameterHash{ HashMeshParameters(isTransparent) };
+	const std::string key{ MakeKey(filePath, parameterHash) };
+	if (std::shared_ptr<Mesh> pMesh = Find<Mesh>(key))
+		return pMesh;
+
+	return UploadAndRegister(pDevice, key, parameterHash, filePath, std::make_shared<Mesh>(filePath, position, isTransparent));
+}
+
+uint64_t AssetRegistry::HashTextureParameters(TextureFormat format)
+{
+	return Hash::Combine(Hash::FnvOffsetBasis, format);
+}
+
+uint64_t AssetRegistry::HashMeshParameters(bool isTransparent)
+{
+	return Hash::Combine(Hash::FnvOffsetBasis, isTransparent);
+}
+
+std::string AssetRegistry::MakeKey(const std::string& filePath, uint64_t parameterHash)
+{
+	// weakly_canonical also resolves files that don't exist (yet), the load reports those
+	std::error_code error;
+	std::filesystem::path canonicalPath{ std::filesystem::weakly_canonical(filePath, error) };
+	if (error)
+		canonicalPath = std::filesystem::path{ filePath }.lexically_normal();
+
+	return canonicalPath.generic_string() + '|' + std::to_string(parameterHash);
+}
+
+uint64_t AssetRegistry::HashContent(uint64_t parameterHash, uint64_t sourceHash)
+{
+	return Hash::Combine(parameterHash, sourceHash);
+}
+
+template<typename Asset>
+std::shared_ptr<Asset> AssetRegistry::UploadAndRegister(ID3D11Device* pDevice, const std::string& key, uint64_t parameterHash, const std::string& filePath, std::shared_ptr<Asset> pAsset)
+{
+	if (!pAsset->IsLoaded())
+		return pAsset;
+
+	// Same content under another name, the decoded copy is dropped before it reaches the GPU
+	const uint64_t contentHash{ HashContent(parameterHash, pAsset->GetSourceHash()) };
+	if (std::shared_ptr<Asset> pShared = FindByContent<Asset>(key, contentHash))
+		return pShared;
+
+	pAsset->Upload(pDevice);
+	return Register(key, contentHash, filePath, std::move(pAsset));
+}
+
+template<typename Asset>
+AssetRegistry::Cache<Asset>& AssetRegistry::GetCache()
+{
+	if constexpr (std::is_same_v<Asset, Texture>)
+		return m_Textures;
+	else
+		return m_Meshes;
+}
+
+template<typename Asset>
+std::shared_ptr<Asset> AssetRegistry::Find(const std::string& key)
+{
+	std::lock_guard lock{ m_Mutex };
+	Cache<Asset>& cache{ GetCache<Asset>() };
+
+	const auto it = cache.byKey.find(key);
+	if (it == cache.byKey.end())
+		return nullptr;
+	return it->second.lock();
+}
+
+template<typename Asset>
+std::shared_ptr<Asset> AssetRegistry::FindByContent(const std::string& key, uint64_t contentHash)
+{
+	std::lock_guard lock{ m_Mutex };
+	Cache<Asset>& cache{ GetCache<Asset>() };
+
+	const auto it = cache.byContent.find(contentHash);
+	if (it == cache.byContent.end())
+		return nullptr;
+
+	std::shared_ptr<Asset> pAsset{ it->second.pAsset.lock() };
+	if (pAsset)
+		cache.byKey[key] = pAsset;
+	return pAsset;
+}
+
+template<typename Asset>
+std::shared_ptr<Asset> AssetRegistry::Register(const std::string& key, uint64_t contentHash, const std::string& filePath, std::shared_ptr<Asset> pAsset)
+{
+	std::lock_guard lock{ m_Mutex };
+	Cache<Asset>& cache{ GetCache<Asset>() };
+
+	std::weak_ptr<Asset>& pRegistered{ cache.byKey[key] };
+	if (std::shared_ptr<Asset> pExisting = pRegistered.lock())
+		return pExisting;
+	pRegistered = pAsset;
+
+	Entry<Asset>& entry{ cache.byContent[contentHash] };
+	if (entry.pAsset.expired())
+		entry = Entry<Asset>{ filePath, pAsset };
+
+	return pAsset;
+}
+
+template std::shared_ptr<Texture> AssetRegistry::Find<Texture>(const std::string&);
+template std::shared_ptr<Mesh> AssetRegistry::Find<Mesh>(const std::string&);
+template std::shared_ptr<Texture> AssetRegistry::FindByContent<Texture>(const std::string&, uint64_t);
+template std::shared_ptr<Mesh> AssetRegistry::FindByContent<Mesh>(const std::string&, uint64_t);
+template std::shared_ptr<Texture> AssetRegistry::Register<Texture>(const std::string&, uint64_t, const std::string&, std::shared_ptr<Texture>);
+template std::shared_ptr<Mesh> AssetRegistry::Register<Mesh>(const std::string&, uint64_t, const std::string&, std::shared_ptr<Mesh>);
+
+void AssetRegistry::PrintResidency()
+{
+	std::lock_guard lock{ m_Mutex };
+
+	size_t gpuBytes{};
+	size_t cpuBytes{ PrintCache<Texture>("Texture", gpuBytes) };
+	cpuBytes += PrintCache<Mesh>("Mesh", gpuBytes);
+
+	std::cout << "Resident assets: " << cpuBytes / 1024 << " KiB CPU, " << gpuBytes / 1024 << " KiB GPU" << std::endl;
+}
+
+template<typename Asset>
+size_t AssetRegistry::PrintCache(const char* pName, size_t& gpuBytes)
+{
+	Cache<Asset>& cache{ GetCache<Asset>() };
+	size_t cpuBytes{};
+
+	// Drop the entries of released assets while walking the cache
+	for (auto it = cache.byContent.begin(); it != cache.byContent.end();)
+	{
+		const std::shared_ptr<Asset> pAsset{ it->second.pAsset.lock() };
+		if (!pAsset)
+		{
+			it = cache.byContent.erase(it);
+			continue;
+		}
+
+		// The registry holds a handle of its own for the duration of the print
+		std::cout << "  " << pName << ' ' << it->second.filePath
+			<< ": " << pAsset->GetCPUBytes() / 1024 << " KiB CPU, " << pAsset->GetGPUBytes() / 1024 << " KiB GPU, "
+			<< pAsset.use_count() - 1 << " handles" << std::endl;
+		cpuBytes += pAsset->GetCPUBytes();
+		gpuBytes += pAsset->GetGPUBytes();
+		++it;
+	}
+
+	for (auto it = cache.byKey.begin(); it != cache.byKey.end();)
+		it = it->second.expired() ? cache.byKey.erase(it) : std::next(it);
+
+	return cpuBytes;
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "structs.h"
+
+class Mesh;
+class Texture;
+
+// Hands out shared handles to textures and meshes so the same asset is only decoded and uploaded once.
+// Assets are found by canonical path first and by content hash second (the same file copied under another name),
+// which is checked after decoding but before the upload.
+// The registry only keeps weak references, an asset is released as soon as the last handle goes away.
+class AssetRegistry final
+{
+public:
+	AssetRegistry() = default;
+	~AssetRegistry() = default;
+
+	AssetRegistry(const AssetRegistry&) = delete;
+	AssetRegistry(AssetRegistry&&) noexcept = delete;
+	AssetRegistry& operator=(const AssetRegistry&) = delete;
+	AssetRegistry& operator=(AssetRegistry&&) noexcept = delete;
+
+	// Loads on the calling thread when the asset isn't resident yet, an asset that failed to load isn't registered
+	[[nodiscard]] std::shared_ptr<Texture> LoadTexture(ID3D11Device* pDevice, const std::string& filePath, TextureFormat format = TextureFormat::rgba8);
+	[[nodiscard]] std::shared_ptr<Mesh> LoadMesh(ID3D11Device* pDevice, const std::string& filePath, const Elite::FVector3& position, bool isTransparent = false);
+
+	// The load parameters are part of the key, the same file loaded with another format is another asset.
+	// A mesh is the same wherever it is placed, the position belongs to the instances drawing it.
+	[[nodiscard]] static uint64_t HashTextureParameters(TextureFormat format);
+	[[nodiscard]] static uint64_t HashMeshParameters(bool isTransparent);
+	[[nodiscard]] static std::string MakeKey(const std::string& filePath, uint64_t parameterHash);
+	// sourceHash is the hash the decoder took of the bytes it read (GetSourceHash), the file isn't read again
+	[[nodiscard]] static uint64_t HashContent(uint64_t parameterHash, uint64_t sourceHash);
+
+	// Thread safe, used by the AssetLoader workers
+	template<typename Asset>
+	[[nodiscard]] std::shared_ptr<Asset> Find(const std::string& key);
+	template<typename Asset>
+	[[nodiscard]] std::shared_ptr<Asset> FindByContent(const std::string& key, uint64_t contentHash);
+	// Returns the asset that ended up registered, which is an earlier one if another thread got there first
+	template<typename Asset>
+	std::shared_ptr<Asset> Register(const std::string& key, uint64_t contentHash, const std::string& filePath, std::shared_ptr<Asset> pAsset);
+
+	void PrintResidency();
+
+private:
+	template<typename Asset>
+	struct Entry
+	{
+		std::string filePath;
+		std::weak_ptr<Asset> pAsset;
+	};
+
+	template<typename Asset>
+	struct Cache
+	{
+		std::unordered_map<std::string, std::weak_ptr<Asset>> byKey;
+		std::unordered_map<uint64_t, Entry<Asset>> byContent;
+	};
+
+	std::mutex m_Mutex;
+	Cache<Texture> m_Textures;
+	Cache<Mesh> m_Meshes;
+
+	template<typename Asset>
+	[[nodiscard]] Cache<Asset>& GetCache();
+	template<typename Asset>
+	[[nodiscard]] std::shared_ptr<Asset> UploadAndRegister(ID3D11Device* pDevice, const std::string& key, uint64_t parameterHash, const std::string& filePath, std::shared_ptr<Asset> pAsset);
+	template<typename Asset>
+	[[nodiscard]] size_t PrintCache(const char* pName, size_t& gpuBytes);
+};
+
@@ -0,0 +1,214 @@
+#include "pch.h"
+#include "AssetStreamer.h"
+#include <iomanip>
+#include "AssetRegistry.h"
+#include "Mesh.h"
+#include "MeshTangents.h"
+#include "ThreadPool.h"
+
+using namespace Elite;
+
+namespace
+{
+	constexpr float g_PlaceholderHalfSize{ 2.5f };
+
+	// Axis aligned box with flat shaded faces. The faces are built counter clockwise like an OBJ file
+	// and then mirrored on z the same way the OBJ parser does, so the winding matches the loaded meshes.
+	unique_ptr<Mesh> CreatePlaceholderBox(float halfSize)
+	{
+		// normal, u, v with u x v = normal
+		const FVector3 faces[6][3]{
+			{ { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 } },
+			{ { -1, 0, 0 }, { 0, 0, 1 }, { 0, 1, 0 } },
+			{ { 0, 1, 0 }, { 0, 0, 1 }, { 1, 0, 0 } },
+			{ { 0, -1, 0 }, { 1, 0, 0 }, { 0, 0, 1 } },
+			{ { 0, 0, 1 }, { 1, 0, 0 }, { 0, 1, 0 } },
+			{ { 0, 0, -1 }, { 0, 1, 0 }, { 1, 0, 0 } } };
+		const float corners[4][2]{ { -1, -1 }, { 1, -1 }, { 1, 1 }, { -1, 1 } };
+
+		std::vector<Vertex_Input> vertices;
+		std::vector<uint32_t> indices;
+		vertices.reserve(24);
+		indices.reserve(36);
+		for (const auto& face : faces)
+		{
+			const uint32_t first{ static_cast<uint32_t>(vertices.size()) };
+			for (const auto& corner : corners)
+			{
+				const FVector3 offset{ (face[0] + face[1] * corner[0] + face[2] * corner[1]) * halfSize };
+
+				Vertex_Input vertex{};
+				vertex.Position = FPoint4{ offset.x, offset.y, -offset.z };
+				vertex.Normal = FVector3{ face[0].x, face[0].y, -face[0].z };
+				vertex.UV = FVector2{ (corner[0] + 1) / 2, 1 - (corner[1] + 1) / 2 };
+				vertices.push_back(vertex);
+			}
+			indices.insert(indices.end(), { first, first + 1, first + 2, first, first + 2, first + 3 });
+		}
+
+		MeshTangents::Compute(vertices, indices);
+		return make_unique<Mesh>(std::move(vertices), std::move(indices), FVector3{});
+	}
+}
+
+MeshHandle::MeshHandle(const std::string& filePath, const Elite::FVector3& position)
+	: m_FilePath{ filePath }
+	, m_Position{ position }
+	, m_IsFailed{ false }
+{
+}
+
+AssetStreamer::AssetStreamer(ThreadPool* pThreadPool, AssetRegistry* pRegistry, ID3D11Device* pDevice)
+	: m_pThreadPool{ pThreadPool }
+	, m_pRegistry{ pRegistry }
+	, m_pDevice{ pDevice }
+	, m_pPlaceholder{ CreatePlaceholderBox(g_PlaceholderHalfSize) }
+{
+	m_pPlaceholder->Upload(pDevice);
+}
+
+AssetStreamer::~AssetStreamer()
+{
+	for (std::future<void>& job : m_Jobs)
+		job.wait();
+}
+
+std::shared_ptr<MeshHandle> AssetStreamer::LoadMeshAsync(const std::string& filePath, const Elite::FVector3& position, bool isTransparent, std::function<void(Mesh&)> onReady)
+{
+	auto pHandle{ std::make_shared<MeshHandle>(filePath, position) };
+
+	const uint64_t parameterHash{ AssetRegistry::HashMeshParameters(isTransparent) };
+	const std::string key{ AssetRegistry::MakeKey(filePath, parameterHash) };
+	if (std::shared_ptr<Mesh> pMesh = m_pRegistry->Find<Mesh>(key))
+	{
+		pHandle->m_pMesh = std::move(pMesh);
+		if (onReady)
+			onReady(*pHandle->m_pMesh);
+		return pHandle;
+	}
+
+	const auto it = m_Pending.find(key);
+	if (it != m_Pending.end())
+	{
+		it->second->targets.push_back(Target{ pHandle, std::move(onReady) });
+		return pHandle;
+	}
+
+	auto pRequest{ std::make_shared<Request>(Request{ filePath, key, 0, isTransparent, { Target{ pHandle, std::move(onReady) } }, nullptr, nullptr, Clock::now(), {}, 0.f }) };
+	m_Pending.emplace(key, pRequest);
+	m_Jobs.push_back(m_pThreadPool->Enqueue([this, pRequest, position, parameterHash]()
+		{
+			const Clock::time_point decodeStart{ Clock::now() };
+
+			// Always handed to Update, a throwing parse would otherwise leave its handles on the placeholder for good.
+			// Publish shares the mesh instead when the same content is already resident under another name.
+			try
+			{
+				pRequest->pMesh = std::make_shared<Mesh>(pRequest->filePath, position, pRequest->isTransparent, m_pThreadPool);
+				pRequest->contentHash = AssetRegistry::HashContent(parameterHash, pRequest->pMesh->GetSourceHash());
+			}
+			catch (...)
+			{
+				pRequest->pError = std::current_exception();
+			}
+
+			pRequest->decodedTime = Clock::now();
+			pRequest->decodeMs = GetElapsedMs(decodeStart, pRequest->decodedTime);
+
+			std::lock_guard lock{ m_Mutex };
+			m_Decoded.push_back(pRequest);
+		}));
+	return pHandle;
+}
+
+void AssetStreamer::Update(uint32_t uploadsPerFrame)
+{
+	std::vector<std::shared_ptr<Request>> decoded;
+	{
+		std::lock_guard lock{ m_Mutex };
+		const size_t count{ std::min<size_t>(uploadsPerFrame, m_Decoded.size()) };
+		decoded.assign(m_Decoded.begin(), m_Decoded.begin() + count);
+		m_Decoded.erase(m_Decoded.begin(), m_Decoded.begin() + count);
+	}
+
+	for (const std::shared_ptr<Request>& pRequest : decoded)
+		Publish(*pRequest);
+
+	// Drop the finished jobs, their requests are in m_Decoded or published already
+	m_Jobs.erase(std::remove_if(m_Jobs.begin(), m_Jobs.end(), [](const std::future<void>& job)
+		{
+			return job.wait_for(std::chrono::seconds{ 0 }) == std::future_status::ready;
+		}), m_Jobs.end());
+}
+
+void AssetStreamer::Publish(Request& request)
+{
+	m_Pending.erase(request.key);
+	if (request.pError || !request.pMesh->IsLoaded())
+	{
+		Fail(request);
+		return;
+	}
+
+	const Clock::time_point uploadStart{ Clock::now() };
+
+	// Another request (or a blocking load) registered the same mesh while this one was parsing
+	std::shared_ptr<Mesh> pRegistered{ m_pRegistry->Find<Mesh>(request.key) };
+	if (!pRegistered)
+		pRegistered = m_pRegistry->FindByContent<Mesh>(request.key, request.contentHash);
+
+	if (pRegistered)
+		request.pMesh = pRegistered;
+	else
+	{
+		request.pMesh->Upload(m_pDevice);
+		request.pMesh = m_pRegistry->Register(request.key, request.contentHash, request.filePath, request.pMesh);
+	}
+
+	const Clock::time_point uploadEnd{ Clock::now() };
+	for (const Target& target : request.targets)
+	{
+		target.pHandle->m_pMesh = request.pMesh;
+		if (target.onReady)
+			target.onReady(*request.pMesh);
+	}
+
+	std::cout << std::fixed << std::setprecision(2) << "Streamed " << request.filePath
+		<< ": decode " << request.decodeMs << " ms"
+		<< ", waited " << GetElapsedMs(request.decodedTime, uploadStart) << " ms"
+		<< ", upload " << GetElapsedMs(uploadStart, uploadEnd) << " ms"
+		<< ", latency " << GetElapsedMs(request.requestTime, uploadEnd) << " ms"
+		<< (request.targets.size() > 1 ? ", " + std::to_string(request.targets.size()) + " handles" : "") << std::defaultfloat << std::endl;
+}
+
+void AssetStreamer::Fail(const Request& request)
+{
+	std::cout << "Error streaming " << request.filePath << ": ";
+	if (!request.pError)
+		std::cout << "the mesh couldn't be loaded";
+	else
+	{
+		try
+		{
+			std::rethrow_exception(request.pError);
+		}
+		catch (const std::exception& exception)
+		{
+			std::cout << exception.what();
+		}
+		catch (...)
+		{
+			std::cout << "unknown exception";
+		}
+	}
+	std::cout << ", keeping the placeholder" << std::endl;
+
+	// Neither uploaded nor registered, a later request parses the file again
+	for (const Target& target : request.targets)
+		target.pHandle->m_IsFailed = true;
+}
+
+float AssetStreamer::GetElapsedMs(Clock::time_point start, Clock::time_point end)
+{
+	return std::chrono::duration<float, std::milli>(end - start).count();
+}
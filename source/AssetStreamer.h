@@ -0,0 +1,110 @@
+#pragma once
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "structs.h"
+
+class AssetRegistry;
+class Mesh;
+class ThreadPool;
+
+// Returned by AssetStreamer::LoadMeshAsync before anything is loaded, the mesh is published into it once uploaded.
+// Only read and written on the main thread.
+class MeshHandle final
+{
+public:
+	MeshHandle(const std::string& filePath, const Elite::FVector3& position);
+	~MeshHandle() = default;
+
+	MeshHandle(const MeshHandle&) = delete;
+	MeshHandle(MeshHandle&&) noexcept = delete;
+	MeshHandle& operator=(const MeshHandle&) = delete;
+	MeshHandle& operator=(MeshHandle&&) noexcept = delete;
+
+	[[nodiscard]] bool IsReady() const { return m_pMesh != nullptr; }
+	// The parse threw or the file couldn't be loaded, the handle stays empty
+	[[nodiscard]] bool IsFailed() const { return m_IsFailed; }
+	[[nodiscard]] Mesh* GetMesh() const { return m_pMesh.get(); }
+	[[nodiscard]] const std::string& GetFilePath() const { return m_FilePath; }
+	[[nodiscard]] const Elite::FVector3& GetPosition() const { return m_Position; }
+
+private:
+	friend class AssetStreamer;
+
+	std::string m_FilePath;
+	Elite::FVector3 m_Position;
+	std::shared_ptr<Mesh> m_pMesh;
+	bool m_IsFailed;
+};
+
+// Loads meshes while the frame loop keeps running: parsing happens on the thread pool, the upload on the main
+// thread in Update, a few meshes per frame. Until then the handle is empty and the placeholder can be drawn instead.
+class AssetStreamer final
+{
+public:
+	AssetStreamer(ThreadPool* pThreadPool, AssetRegistry* pRegistry, ID3D11Device* pDevice);
+	// Waits for the meshes still being parsed, the jobs point back into the streamer
+	~AssetStreamer();
+
+	AssetStreamer(const AssetStreamer&) = delete;
+	AssetStreamer(AssetStreamer&&) noexcept = delete;
+	AssetStreamer& operator=(const AssetStreamer&) = delete;
+	AssetStreamer& operator=(AssetStreamer&&) noexcept = delete;
+
+	// onReady runs on the main thread right after the mesh is published, to set its textures and render state.
+	// Requests for a mesh that is still being parsed wait for that parse instead of starting another one.
+	[[nodiscard]] std::shared_ptr<MeshHandle> LoadMeshAsync(const std::string& filePath, const Elite::FVector3& position, bool isTransparent = false,
+		std::function<void(Mesh&)> onReady = {});
+
+	// Uploads and publishes at most uploadsPerFrame parsed meshes, call once per frame on the main thread
+	void Update(uint32_t uploadsPerFrame = 1);
+
+	// Box drawn in place of meshes that aren't ready yet
+	[[nodiscard]] Mesh* GetPlaceholder() const { return m_pPlaceholder.get(); }
+
+private:
+	using Clock = std::chrono::steady_clock;
+
+	struct Target
+	{
+		std::shared_ptr<MeshHandle> pHandle;
+		std::function<void(Mesh&)> onReady;
+	};
+
+	struct Request
+	{
+		std::string filePath;
+		std::string key;
+		uint64_t contentHash;
+		bool isTransparent;
+		// Only touched on the main thread, the job never reads it
+		std::vector<Target> targets;
+		std::shared_ptr<Mesh> pMesh;
+		std::exception_ptr pError;
+		Clock::time_point requestTime;
+		Clock::time_point decodedTime;
+		float decodeMs;
+	};
+
+	ThreadPool* m_pThreadPool;
+	AssetRegistry* m_pRegistry;
+	ID3D11Device* m_pDevice;
+	unique_ptr<Mesh> m_pPlaceholder;
+
+	std::vector<std::future<void>> m_Jobs;
+	std::mutex m_Mutex;
+	std::vector<std::shared_ptr<Request>> m_Decoded;
+	// Requests being parsed by key, main thread only
+	std::unordered_map<std::string, std::shared_ptr<Request>> m_Pending;
+
+	void Publish(Request& request);
+	void Fail(const Request& request);
+
+	[[nodiscard]] static float GetElapsedMs(Clock::time_point start, Clock::time_point end = Clock::now());
+};
+
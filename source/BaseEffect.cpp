@@ -3,6 +3,8 @@
 #include <sstream>
 
 BaseEffect::BaseEffect(ID3D11Device* pDevice, const std::wstring& assetFile)
+	: m_SampleMode{ SampleMode::point }
+	, m_VertexFormat{ VertexFormat::full }
 {
 	m_pEffect = LoadEffect(pDevice, assetFile);
 }
@@ -12,6 +14,12 @@ BaseEffect::~BaseEffect()
 	m_pEffect->Release();
 }
 
+void BaseEffect::SetVertexFormat(VertexFormat vertexFormat)
+{
+	m_VertexFormat = vertexFormat;
+	SetTechnique(m_SampleMode);
+}
+
 ID3DX11Effect* BaseEffect::GetEffect() const
 {
 	return m_pEffect;
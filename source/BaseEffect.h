@@ -18,11 +18,15 @@ public:
 	[[nodiscard]] ID3DX11EffectVariable* GetVariableByName(LPCSTR name) const;
 
 	virtual void SetTechnique(SampleMode renderTechnique) = 0;
+	// Switches to the techniques compiled against the matching vertex shader input
+	void SetVertexFormat(VertexFormat vertexFormat);
 
 protected:
 	ID3DX11Effect* m_pEffect;
 	ID3DX11EffectShaderResourceVariable* m_pShaderResourceVariable;
 	ID3DX11EffectTechnique* m_pActiveTechnique;
+	SampleMode m_SampleMode;
+	VertexFormat m_VertexFormat;
 
 private:
 	static ID3DX11Effect* LoadEffect(ID3D11Device* pDevice, const std::wstring& assetFile);
@@ -0,0 +1,322 @@
+#include "pch.h"
+#include "BlockCompression.h"
+#include <climits>
+#include <cstring>
+
+namespace
+{
+	uint32_t GetChannel(uint32_t texel, uint32_t channel)
+	{
+		return (texel >> (channel * 8)) & 0xFF;
+	}
+
+	uint32_t PackTexel(uint32_t r, uint32_t g, uint32_t b, uint32_t a)
+	{
+		return r | (g << 8) | (b << 16) | (a << 24);
+	}
+
+	uint16_t To565(uint32_t r, uint32_t g, uint32_t b)
+	{
+		return static_cast<uint16_t>(((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3));
+	}
+
+	void From565(uint16_t color, uint32_t& r, uint32_t& g, uint32_t& b)
+	{
+		const uint32_t r5{ (static_cast<uint32_t>(color) >> 11) & 0x1F };
+		const uint32_t g6{ (static_cast<uint32_t>(color) >> 5) & 0x3F };
+		const uint32_t b5{ static_cast<uint32_t>(color) & 0x1F };
+		r = (r5 << 3) | (r5 >> 2);
+		g = (g6 << 2) | (g6 >> 4);
+		b = (b5 << 3) | (b5 >> 2);
+	}
+
+	// Builds the 4 entry palette of a color block. Only BC1 switches to the 3 color + transparent mode.
+	void BuildColorPalette(uint16_t color0, uint16_t color1, bool allowPunchThrough, uint32_t* pPalette)
+	{
+		uint32_t r0, g0, b0, r1, g1, b1;
+		From565(color0, r0, g0, b0);
+		From565(color1, r1, g1, b1);
+
+		pPalette[0] = PackTexel(r0, g0, b0, 255);
+		pPalette[1] = PackTexel(r1, g1, b1, 255);
+		if (color0 > color1 || !allowPunchThrough)
+		{
+			pPalette[2] = PackTexel((2 * r0 + r1) / 3, (2 * g0 + g1) / 3, (2 * b0 + b1) / 3, 255);
+			pPalette[3] = PackTexel((r0 + 2 * r1) / 3, (g0 + 2 * g1) / 3, (b0 + 2 * b1) / 3, 255);
+		}
+		else
+		{
+			pPalette[2] = PackTexel((r0 + r1) / 2, (g0 + g1) / 2, (b0 + b1) / 2, 255);
+			pPalette[3] = 0;
+		}
+	}
+
+	void BuildChannelPalette(uint32_t value0, uint32_t value1, uint32_t* pPalette)
+	{
+		pPalette[0] = value0;
+		pPalette[1] = value1;
+		if (value0 > value1)
+		{
+			for (uint32_t i{ 1 }; i < 7; ++i)
+				pPalette[i + 1] = ((7 - i) * value0 + i * value1) / 7;
+		}
+		else
+		{
+			for (uint32_t i{ 1 }; i < 5; ++i)
+				pPalette[i + 1] = ((5 - i) * value0 + i * value1) / 5;
+			pPalette[6] = 0;
+			pPalette[7] = 255;
+		}
+	}
+
+	void EncodeColorBlock(const uint32_t* pTexels, uint8_t* pBlock)
+	{
+		uint32_t minColor[3]{ 255, 255, 255 };
+		uint32_t maxColor[3]{ 0, 0, 0 };
+		for (uint32_t i{}; i < BlockCompression::TexelsPerBlock; ++i)
+		{
+			for (uint32_t c{}; c < 3; ++c)
+			{
+				minColor[c] = std::min(minColor[c], GetChannel(pTexels[i], c));
+				maxColor[c] = std::max(maxColor[c], GetChannel(pTexels[i], c));
+			}
+		}
+
+		// Inset the bounding box a bit to reduce the error on the interpolated palette entries
+		for (uint32_t c{}; c < 3; ++c)
+		{
+			const uint32_t inset{ (maxColor[c] - minColor[c]) >> 4 };
+			minColor[c] += inset;
+			maxColor[c] -= inset;
+		}
+
+		uint16_t color0{ To565(maxColor[0], maxColor[1], maxColor[2]) };
+		uint16_t color1{ To565(minColor[0], minColor[1], minColor[2]) };
+		if (color0 < color1)
+			std::swap(color0, color1);
+
+		uint32_t palette[4];
+		BuildColorPalette(color0, color1, false, palette);
+
+		uint32_t indices{};
+		if (color0 != color1)
+		{
+			for (uint32_t i{}; i < BlockCompression::TexelsPerBlock; ++i)
+			{
+				uint32_t bestIndex{};
+				int32_t bestError{ INT_MAX };
+				for (uint32_t p{}; p < 4; ++p)
+				{
+					int32_t error{};
+					for (uint32_t c{}; c < 3; ++c)
+					{
+						const int32_t diff{ static_cast<int32_t>(GetChannel(pTexels[i], c)) - static_cast<int32_t>(GetChannel(palette[p], c)) };
+						error += diff * diff;
+					}
+					if (error < bestError)
+					{
+						bestError = error;
+						bestIndex = p;
+					}
+				}
+				indices |= bestIndex << (2 * i);
+			}
+		}
+
+		std::memcpy(pBlock, &color0, sizeof(uint16_t));
+		std::memcpy(pBlock + 2, &color1, sizeof(uint16_t));
+		std::memcpy(pBlock + 4, &indices, sizeof(uint32_t));
+	}
+
+	void DecodeColorBlock(const uint8_t* pBlock, bool allowPunchThrough, uint32_t* pTexels)
+	{
+		uint16_t color0, color1;
+		uint32_t indices;
+		std::memcpy(&color0, pBlock, sizeof(uint16_t));
+		std::memcpy(&color1, pBlock + 2, sizeof(uint16_t));
+		std::memcpy(&indices, pBlock + 4, sizeof(uint32_t));
+
+		uint32_t palette[4];
+		BuildColorPalette(color0, color1, allowPunchThrough, palette);
+
+		for (uint32_t i{}; i < BlockCompression::TexelsPerBlock; ++i)
+			pTexels[i] = palette[(indices >> (2 * i)) & 0x3];
+	}
+
+	// BC4 style block, used for the BC3 alpha and both BC5 channels
+	void EncodeChannelBlock(const uint32_t* pTexels, uint32_t channel, uint8_t* pBlock)
+	{
+		uint32_t minValue{ 255 };
+		uint32_t maxValue{ 0 };
+		for (uint32_t i{}; i < BlockCompression::TexelsPerBlock; ++i)
+		{
+			minValue = std::min(minValue, GetChannel(pTexels[i], channel));
+			maxValue = std::max(maxValue, GetChannel(pTexels[i], channel));
+		}
+
+		uint32_t palette[8];
+		BuildChannelPalette(maxValue, minValue, palette);
+
+		uint64_t indices{};
+		if (maxValue != minValue)
+		{
+			for (uint32_t i{}; i < BlockCompression::TexelsPerBlock; ++i)
+			{
+				const int32_t value{ static_cast<int32_t>(GetChannel(pTexels[i], channel)) };
+				uint64_t bestIndex{};
+				int32_t bestError{ INT_MAX };
+				for (uint32_t p{}; p < 8; ++p)
+				{
+					const int32_t error{ std::abs(value - static_cast<int32_t>(palette[p])) };
+					if (error < bestError)
+					{
+						bestError = error;
+						bestIndex = p;
+					}
+				}
+				indices |= bestIndex << (3 * i);
+			}
+		}
+
+		pBlock[0] = static_cast<uint8_t>(maxValue);
+		pBlock[1] = static_cast<uint8_t>(minValue);
+		for (uint32_t i{}; i < 6; ++i)
+			pBlock[2 + i] = static_cast<uint8_t>(indices >> (8 * i));
+	}
+
+	void DecodeChannelBlock(const uint8_t* pBlock, uint32_t channel, uint32_t* pTexels)
+	{
+		uint32_t palette[8];
+		BuildChannelPalette(pBlock[0], pBlock[1], palette);
+
+		uint64_t indices{};
+		for (uint32_t i{}; i < 6; ++i)
+			indices |= static_cast<uint64_t>(pBlock[2 + i]) << (8 * i);
+
+		const uint32_t mask{ ~(0xFFu << (channel * 8)) };
+		for (uint32_t i{}; i < BlockCompression::TexelsPerBlock; ++i)
+			pTexels[i] = (pTexels[i] & mask) | (palette[(indices >> (3 * i)) & 0x7] << (channel * 8));
+	}
+}
+
+bool BlockCompression::IsBlockCompressed(TextureFormat format)
+{
+	return format == TextureFormat::bc1 || format == TextureFormat::bc3 || format == TextureFormat::bc5;
+}
+
+uint32_t BlockCompression::GetBlockSize(TextureFormat format)
+{
+	switch (format)
+	{
+	case TextureFormat::bc1:
+		return 8;
+
+	case TextureFormat::bc3:
+	case TextureFormat::bc5:
+		return 16;
+
+	default:
+		return 0;
+	}
+}
+
+DXGI_FORMAT BlockCompression::GetDXGIFormat(TextureFormat format)
+{
+	switch (format)
+	{
+	case TextureFormat::rgba8:
+		return DXGI_FORMAT_R8G8B8A8_UNORM;
+
+	case TextureFormat::bc1:
+		return DXGI_FORMAT_BC1_UNORM;
+
+	case TextureFormat::bc3:
+		return DXGI_FORMAT_BC3_UNORM;
+
+	case TextureFormat::bc5:
+		return DXGI_FORMAT_BC5_UNORM;
+
+	default:
+		return DXGI_FORMAT_UNKNOWN;
+	}
+}
+
+uint32_t BlockCompression::GetBlockCount(uint32_t texels)
+{
+	return (texels + BlockDimension - 1) / BlockDimension;
+}
+
+void BlockCompression::Encode(TextureFormat format, const uint32_t* pTexels, uint32_t width, uint32_t height, uint32_t texelPitch, std::vector<uint8_t>& blocks)
+{
+	const uint32_t blocksWide{ GetBlockCount(width) };
+	const uint32_t blocksHigh{ GetBlockCount(height) };
+	const uint32_t blockSize{ GetBlockSize(format) };
+	blocks.resize(size_t(blocksWide) * blocksHigh * blockSize);
+
+	uint32_t blockTexels[TexelsPerBlock];
+	for (uint32_t by{}; by < blocksHigh; ++by)
+	{
+		for (uint32_t bx{}; bx < blocksWide; ++bx)
+		{
+			for (uint32_t y{}; y < BlockDimension; ++y)
+			{
+				const uint32_t row{ std::min(by * BlockDimension + y, height - 1) };
+				for (uint32_t x{}; x < BlockDimension; ++x)
+				{
+					const uint32_t column{ std::min(bx * BlockDimension + x, width - 1) };
+					blockTexels[y * BlockDimension + x] = pTexels[row * texelPitch + column];
+				}
+			}
+
+			EncodeBlock(format, blockTexels, &blocks[(size_t(by) * blocksWide + bx) * blockSize]);
+		}
+	}
+}
+
+void BlockCompression::EncodeBlock(TextureFormat format, const uint32_t* pTexels, uint8_t* pBlock)
+{
+	switch (format)
+	{
+	case TextureFormat::bc1:
+		EncodeColorBlock(pTexels, pBlock);
+		break;
+
+	case TextureFormat::bc3:
+		EncodeChannelBlock(pTexels, 3, pBlock);
+		EncodeColorBlock(pTexels, pBlock + 8);
+		break;
+
+	case TextureFormat::bc5:
+		EncodeChannelBlock(pTexels, 0, pBlock);
+		EncodeChannelBlock(pTexels, 1, pBlock + 8);
+		break;
+
+	default:
+		break;
+	}
+}
+
+void BlockCompression::DecodeBlock(TextureFormat format, const uint8_t* pBlock, uint32_t* pTexels)
+{
+	switch (format)
+	{
+	case TextureFormat::bc1:
+		DecodeColorBlock(pBlock, true, pTexels);
+		break;
+
+	case TextureFormat::bc3:
+		DecodeColorBlock(pBlock + 8, false, pTexels);
+		DecodeChannelBlock(pBlock, 3, pTexels);
+		break;
+
+	case TextureFormat::bc5:
+		for (uint32_t i{}; i < TexelsPerBlock; ++i)
+			pTexels[i] = PackTexel(0, 0, 0, 255);
+		DecodeChannelBlock(pBlock, 0, pTexels);
+		DecodeChannelBlock(pBlock + 8, 1, pTexels);
+		break;
+
+	default:
+		break;
+	}
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include <vector>
+#include "structs.h"
+
+// Minimal BC1/BC3/BC5 encoder and decoder.
+// Texels are passed around as RGBA8 packed in a uint32_t (r in the lowest byte), the same byte order
+// as SDL_PIXELFORMAT_RGBA32 and DXGI_FORMAT_R8G8B8A8_UNORM.
+namespace BlockCompression
+{
+	constexpr uint32_t BlockDimension{ 4 };
+	constexpr uint32_t TexelsPerBlock{ BlockDimension * BlockDimension };
+
+	[[nodiscard]] bool IsBlockCompressed(TextureFormat format);
+	[[nodiscard]] uint32_t GetBlockSize(TextureFormat format);
+	[[nodiscard]] DXGI_FORMAT GetDXGIFormat(TextureFormat format);
+	[[nodiscard]] uint32_t GetBlockCount(uint32_t texels);
+
+	// Encodes a RGBA8 image into row major blocks, edge blocks are padded by repeating the last texel
+	void Encode(TextureFormat format, const uint32_t* pTexels, uint32_t width, uint32_t height, uint32_t texelPitch, std::vector<uint8_t>& blocks);
+	void EncodeBlock(TextureFormat format, const uint32_t* pTexels, uint8_t* pBlock);
+	void DecodeBlock(TextureFormat format, const uint8_t* pBlock, uint32_t* pTexels);
+}
+
@@ -0,0 +1,240 @@
+#include "pch.h"
+#include "Bvh.h"
+#include <numeric>
+#include <xmmintrin.h>
+
+namespace
+{
+	// A median split halves every level, 64 levels is more items than fit in memory
+	constexpr uint32_t g_MaxDepth{ 64 };
+
+	enum class Containment
+	{
+		outside,
+		intersecting,
+		inside
+	};
+
+	// The six planes as two groups of four, the second group repeats the near and far plane
+	struct SimdPlanes
+	{
+		__m128 x[2];
+		__m128 y[2];
+		__m128 z[2];
+		__m128 w[2];
+		__m128 absX[2];
+		__m128 absY[2];
+		__m128 absZ[2];
+	};
+
+	SimdPlanes LoadPlanes(const Elite::FVector4* pPlanes)
+	{
+		constexpr uint32_t groups[2][4]{ { 0, 1, 2, 3 }, { 4, 5, 4, 5 } };
+		const __m128 signMask{ _mm_set1_ps(-0.f) };
+		SimdPlanes planes;
+		for (uint32_t group{}; group < 2; ++group)
+		{
+			const Elite::FVector4& p0{ pPlanes[groups[group][0]] };
+			const Elite::FVector4& p1{ pPlanes[groups[group][1]] };
+			const Elite::FVector4& p2{ pPlanes[groups[group][2]] };
+			const Elite::FVector4& p3{ pPlanes[groups[group][3]] };
+			planes.x[group] = _mm_setr_ps(p0.x, p1.x, p2.x, p3.x);
+			planes.y[group] = _mm_setr_ps(p0.y, p1.y, p2.y, p3.y);
+			planes.z[group] = _mm_setr_ps(p0.z, p1.z, p2.z, p3.z);
+			planes.w[group] = _mm_setr_ps(p0.w, p1.w, p2.w, p3.w);
+			planes.absX[group] = _mm_andnot_ps(signMask, planes.x[group]);
+			planes.absY[group] = _mm_andnot_ps(signMask, planes.y[group]);
+			planes.absZ[group] = _mm_andnot_ps(signMask, planes.z[group]);
+		}
+		return planes;
+	}
+
+	// Signed distance of the box center to the planes against the reach of the box along their normals, all planes at once
+	Containment Classify(const SimdPlanes& planes, const Bvh::Bounds& bounds)
+	{
+		const __m128 half{ _mm_set1_ps(0.5f) };
+		const __m128 min{ _mm_setr_ps(bounds.min.x, bounds.min.y, bounds.min.z, 0.f) };
+		const __m128 max{ _mm_setr_ps(bounds.max.x, bounds.max.y, bounds.max.z, 0.f) };
+		const __m128 center{ _mm_mul_ps(_mm_add_ps(min, max), half) };
+		const __m128 extent{ _mm_mul_ps(_mm_sub_ps(max, min), half) };
+
+		const __m128 centerX{ _mm_shuffle_ps(center, center, _MM_SHUFFLE(0, 0, 0, 0)) };
+		const __m128 centerY{ _mm_shuffle_ps(center, center, _MM_SHUFFLE(1, 1, 1, 1)) };
+		const __m128 centerZ{ _mm_shuffle_ps(center, center, _MM_SHUFFLE(2, 2, 2, 2)) };
+		const __m128 extentX{ _mm_shuffle_ps(extent, extent, _MM_SHUFFLE(0, 0, 0, 0)) };
+		const __m128 extentY{ _mm_shuffle_ps(extent, extent, _MM_SHUFFLE(1, 1, 1, 1)) };
+		const __m128 extentZ{ _mm_shuffle_ps(extent, extent, _MM_SHUFFLE(2, 2, 2, 2)) };
+
+		const __m128 zero{ _mm_setzero_ps() };
+		__m128 isOutside{ zero };
+		__m128 isCrossing{ zero };
+		for (uint32_t group{}; group < 2; ++group)
+		{
+			const __m128 distance{ _mm_add_ps(_mm_add_ps(_mm_mul_ps(planes.x[group], centerX), _mm_mul_ps(planes.y[group], centerY)),
+				_mm_add_ps(_mm_mul_ps(planes.z[group], centerZ), planes.w[group])) };
+			const __m128 reach{ _mm_add_ps(_mm_add_ps(_mm_mul_ps(planes.absX[group], extentX), _mm_mul_ps(planes.absY[group], extentY)),
+				_mm_mul_ps(planes.absZ[group], extentZ)) };
+			isOutside = _mm_or_ps(isOutside, _mm_cmplt_ps(_mm_add_ps(distance, reach), zero));
+			isCrossing = _mm_or_ps(isCrossing, _mm_cmplt_ps(_mm_sub_ps(distance, reach), zero));
+		}
+
+		if (_mm_movemask_ps(isOutside) != 0)
+			return Containment::outside;
+		return _mm_movemask_ps(isCrossing) != 0 ? Containment::intersecting : Containment::inside;
+	}
+
+	Bvh::Bounds Merge(const Bvh::Bounds& lhs, const Bvh::Bounds& rhs)
+	{
+		return Bvh::Bounds{
+			Elite::FPoint3{ std::min(lhs.min.x, rhs.min.x), std::min(lhs.min.y, rhs.min.y), std::min(lhs.min.z, rhs.min.z) },
+			Elite::FPoint3{ std::max(lhs.max.x, rhs.max.x), std::max(lhs.max.y, rhs.max.y), std::max(lhs.max.z, rhs.max.z) } };
+	}
+
+	bool IsEqual(const Bvh::Bounds& lhs, const Bvh::Bounds& rhs)
+	{
+		return lhs.min.x == rhs.min.x && lhs.min.y == rhs.min.y && lhs.min.z == rhs.min.z
+			&& lhs.max.x == rhs.max.x && lhs.max.y == rhs.max.y && lhs.max.z == rhs.max.z;
+	}
+}
+
+void Bvh::Build(std::span<const Bounds> bounds)
+{
+	const uint32_t itemCount{ static_cast<uint32_t>(bounds.size()) };
+	m_Bounds.assign(bounds.begin(), bounds.end());
+	m_Items.resize(itemCount);
+	std::iota(m_Items.begin(), m_Items.end(), 0u);
+	m_ItemLeaves.assign(itemCount, m_InvalidNode);
+	m_Nodes.clear();
+	m_DirtyLeaves.clear();
+	m_UpdateCount = 0;
+	if (itemCount == 0)
+		return;
+
+	std::vector<Elite::FPoint3> centers(itemCount);
+	for (uint32_t item{}; item < itemCount; ++item)
+	{
+		const Bounds& itemBounds{ m_Bounds[item] };
+		centers[item] = Elite::FPoint3{ (itemBounds.min.x + itemBounds.max.x) * 0.5f, (itemBounds.min.y + itemBounds.max.y) * 0.5f,
+			(itemBounds.min.z + itemBounds.max.z) * 0.5f };
+	}
+
+	m_Nodes.reserve(size_t(itemCount) * 2 / m_MaxLeafItems * 2 + 1);
+	m_Nodes.push_back(Node{ GetItemBounds(0, itemCount), 0, itemCount, 0, m_InvalidNode });
+	std::vector<uint32_t> stack{ 0 };
+	while (!stack.empty())
+	{
+		const uint32_t node{ stack.back() };
+		stack.pop_back();
+		Split(node, centers);
+		if (m_Nodes[node].left != 0)
+		{
+			stack.push_back(m_Nodes[node].left);
+			stack.push_back(m_Nodes[node].left + 1);
+		}
+	}
+}
+
+void Bvh::Split(uint32_t node, const std::vector<Elite::FPoint3>& centers)
+{
+	const uint32_t firstItem{ m_Nodes[node].firstItem };
+	const uint32_t itemCount{ m_Nodes[node].itemCount };
+	if (itemCount <= m_MaxLeafItems)
+	{
+		for (uint32_t i{ firstItem }; i < firstItem + itemCount; ++i)
+			m_ItemLeaves[m_Items[i]] = node;
+		return;
+	}
+
+	Elite::FPoint3 centerMin{ centers[m_Items[firstItem]] };
+	Elite::FPoint3 centerMax{ centerMin };
+	for (uint32_t i{ firstItem }; i < firstItem + itemCount; ++i)
+	{
+		for (uint8_t axis{}; axis < 3; ++axis)
+		{
+			centerMin[axis] = std::min(centerMin[axis], centers[m_Items[i]][axis]);
+			centerMax[axis] = std::max(centerMax[axis], centers[m_Items[i]][axis]);
+		}
+	}
+	const Elite::FVector3 centerExtent{ centerMax - centerMin };
+	const uint8_t axis{ static_cast<uint8_t>(centerExtent.x >= centerExtent.y && centerExtent.x >= centerExtent.z ? 0 : centerExtent.y >= centerExtent.z ? 1 : 2) };
+
+	// Splitting by count keeps the tree balanced even when all centers are the same
+	const uint32_t leftCount{ itemCount / 2 };
+	std::nth_element(m_Items.begin() + firstItem, m_Items.begin() + firstItem + leftCount, m_Items.begin() + firstItem + itemCount,
+		[&](uint32_t lhs, uint32_t rhs) { return centers[lhs][axis] < centers[rhs][axis]; });
+
+	const uint32_t left{ static_cast<uint32_t>(m_Nodes.size()) };
+	m_Nodes[node].left = left;
+	m_Nodes.push_back(Node{ GetItemBounds(firstItem, leftCount), firstItem, leftCount, 0, node });
+	m_Nodes.push_back(Node{ GetItemBounds(firstItem + leftCount, itemCount - leftCount), firstItem + leftCount, itemCount - leftCount, 0, node });
+}
+
+void Bvh::Update(uint32_t item, const Bounds& bounds)
+{
+	m_Bounds[item] = bounds;
+	m_DirtyLeaves.push_back(m_ItemLeaves[item]);
+	++m_UpdateCount;
+}
+
+void Bvh::Refit()
+{
+	for (uint32_t leaf : m_DirtyLeaves)
+	{
+		m_Nodes[leaf].bounds = GetItemBounds(m_Nodes[leaf].firstItem, m_Nodes[leaf].itemCount);
+
+		// Stops where a parent comes out the same, everything above it is too
+		for (uint32_t node{ m_Nodes[leaf].parent }; node != m_InvalidNode; node = m_Nodes[node].parent)
+		{
+			const Bounds bounds{ Merge(m_Nodes[m_Nodes[node].left].bounds, m_Nodes[m_Nodes[node].left + 1].bounds) };
+			if (IsEqual(bounds, m_Nodes[node].bounds))
+				break;
+			m_Nodes[node].bounds = bounds;
+		}
+	}
+	m_DirtyLeaves.clear();
+}
+
+void Bvh::Cull(const Elite::FVector4* pPlanes, std::vector<uint32_t>& items) const
+{
+	if (m_Nodes.empty())
+		return;
+
+	const SimdPlanes planes{ LoadPlanes(pPlanes) };
+	uint32_t stack[g_MaxDepth + 1];
+	uint32_t stackSize{};
+	stack[stackSize++] = 0;
+	while (stackSize > 0)
+	{
+		const Node& node{ m_Nodes[stack[--stackSize]] };
+		const Containment containment{ Classify(planes, node.bounds) };
+		if (containment == Containment::outside)
+			continue;
+
+		if (containment == Containment::inside)
+		{
+			items.insert(items.end(), m_Items.begin() + node.firstItem, m_Items.begin() + node.firstItem + node.itemCount);
+			continue;
+		}
+
+		if (node.left != 0)
+		{
+			stack[stackSize++] = node.left;
+			stack[stackSize++] = node.left + 1;
+			continue;
+		}
+
+		for (uint32_t i{ node.firstItem }; i < node.firstItem + node.itemCount; ++i)
+		{
+			if (Classify(planes, m_Bounds[m_Items[i]]) != Containment::outside)
+				items.push_back(m_Items[i]);
+		}
+	}
+}
+
+Bvh::Bounds Bvh::GetItemBounds(uint32_t firstItem, uint32_t itemCount) const
+{
+	Bounds bounds{ m_Bounds[m_Items[firstItem]] };
+	for (uint32_t i{ firstItem + 1 }; i < firstItem + itemCount; ++i)
+		bounds = Merge(bounds, m_Bounds[m_Items[i]]);
+	return bounds;
+}
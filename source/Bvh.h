@@ -0,0 +1,63 @@
+#pragma once
+#include <span>
+#include <vector>
+#include "structs.h"
+
+// Bounding volume hierarchy over axis aligned boxes, items are the indices of the boxes passed to Build.
+// Moving an item refits the boxes above it instead of rebuilding, the tree gets looser the more items move.
+class Bvh final
+{
+public:
+	struct Bounds
+	{
+		Elite::FPoint3 min;
+		Elite::FPoint3 max;
+	};
+
+	Bvh() = default;
+	~Bvh() = default;
+
+	Bvh(const Bvh&) = delete;
+	Bvh(Bvh&&) noexcept = delete;
+	Bvh& operator=(const Bvh&) = delete;
+	Bvh& operator=(Bvh&&) noexcept = delete;
+
+	// Top down, split at the median of the longest axis of the item centers
+	void Build(std::span<const Bounds> bounds);
+	// The nodes above the item are refit by the next Refit
+	void Update(uint32_t item, const Bounds& bounds);
+	void Refit();
+
+	// Appends the items whose box touches the frustum (normalized planes, inside positive). A node fully inside
+	// emits its items without testing them, a node fully outside skips them, so the cost follows the visible part.
+	void Cull(const Elite::FVector4* pPlanes, std::vector<uint32_t>& items) const;
+
+	[[nodiscard]] uint32_t GetItemCount() const { return static_cast<uint32_t>(m_Bounds.size()); }
+	// Items moved since the last Build
+	[[nodiscard]] uint32_t GetUpdateCount() const { return m_UpdateCount; }
+
+private:
+	static constexpr uint32_t m_MaxLeafItems{ 4 };
+	static constexpr uint32_t m_InvalidNode{ UINT32_MAX };
+
+	struct Node
+	{
+		Bounds bounds;
+		// Items of the whole subtree are m_Items[firstItem, firstItem + itemCount)
+		uint32_t firstItem;
+		uint32_t itemCount;
+		// Children are left and left + 1, 0 for a leaf (the root is never a child)
+		uint32_t left;
+		uint32_t parent;
+	};
+
+	std::vector<Node> m_Nodes;
+	std::vector<uint32_t> m_Items;
+	std::vector<Bounds> m_Bounds;
+	std::vector<uint32_t> m_ItemLeaves;
+	std::vector<uint32_t> m_DirtyLeaves;
+	uint32_t m_UpdateCount{};
+
+	void Split(uint32_t node, const std::vector<Elite::FPoint3>& centers);
+	[[nodiscard]] Bounds GetItemBounds(uint32_t firstItem, uint32_t itemCount) const;
+};
@@ -1,7 +1,14 @@
 #include "pch.h"
 #include "ECamera.h"
+#include <atomic>
 #include <SDL.h>
 
+namespace
+{
+	//Shared by every camera, so a version never means two different view-projections
+	std::atomic<uint32_t> g_ViewProjectionVersion{};
+}
+
 namespace Elite
 {
 	Camera::Camera(float width, float height, const FPoint3& position, const FVector3& viewForward, float fovAngle) :
@@ -11,9 +18,6 @@ namespace Elite
 		m_Position{ position },
 		m_ViewForward{GetNormalized(-viewForward)}
 	{
-		//Calculate initial matrices based on given parameters (position & target)
-		CalculateLookAt();
-
 		// Create ProjectionMatrix
 		const float aspectRatio = m_Width / m_Height;
 
@@ -21,11 +25,15 @@ namespace Elite
 						               0,                       1 / m_Fov, 0,                        0,
 						               0,                       0,         m_Far / (m_Far - m_Near), -(m_Far * m_Near) / (m_Far - m_Near),
 						               0,                       0,         1,                        0 };
+
+		//Calculate initial matrices based on given parameters (position & target)
+		CalculateLookAt();
 	}
 
 	void Camera::Update(float elapsedSec)
 	{
 		constexpr float movementSpeed{ 3.f };
+		const FPoint2 previousRotation{ m_AbsoluteRotation };
 
 		//Capture Input (absolute) Rotation & (relative) Movement
 		//*************
@@ -57,14 +65,22 @@ namespace Elite
 			m_RelativeTranslation.y -= y * m_MouseMoveSensitivity * elapsedSec;
 		}
 
+		//Nothing to rebuild when the camera stands still
+		if (m_RelativeTranslation.x == 0.f && m_RelativeTranslation.y == 0.f && m_RelativeTranslation.z == 0.f
+			&& m_AbsoluteRotation.x == previousRotation.x && m_AbsoluteRotation.y == previousRotation.y)
+		{
+			return;
+		}
+
 		//Update LookAt (view2world & world2view matrices)
 		//*************
 		CalculateLookAt();
 	}
 
-	const FMatrix4& Camera::GetWorldViewProjection() const
+	void Camera::SetWorldMatrix(const FMatrix4& matrix)
 	{
-		return m_ProjectionMatrix * m_WorldToView * m_TransformMatrix;
+		m_TransformMatrix = matrix;
+		m_WorldViewProjection = m_ViewProjection * m_TransformMatrix;
 	}
 
 	void Camera::CalculateLookAt()
@@ -99,7 +115,17 @@ namespace Elite
 			FVector4{m_Position.x, m_Position.y, m_Position.z, 1.f}
 		};
 
-		//Construct World2View Matrix
-		m_WorldToView = Inverse(m_ViewToWorld);
+		//Construct World2View Matrix, the axes are orthonormal so the rigid inverse does
+		m_WorldToView = InverseRigid(m_ViewToWorld);
+
+		CalculateViewProjection();
+	}
+
+	void Camera::CalculateViewProjection()
+	{
+		m_ViewProjection = m_ProjectionMatrix * m_WorldToView;
+		m_WorldViewProjection = m_ViewProjection * m_TransformMatrix;
+		ExtractFrustumPlanes(m_ViewProjection, m_FrustumPlanes);
+		m_Version = ++g_ViewProjectionVersion;
 	}
 }
\ No newline at end of file
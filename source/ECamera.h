@@ -23,13 +23,20 @@ namespace Elite
 		Camera& operator=(const Camera&) = delete;
 		Camera& operator=(Camera&&) noexcept = delete;
 
+		//Reads the input, the matrices are only rebuilt when it moved or turned the camera
 		void Update(float elapsedSec);
 
-		void SetWorldMatrix(const FMatrix4& matrix) { m_TransformMatrix = matrix; }
+		void SetWorldMatrix(const FMatrix4& matrix);
 		[[nodiscard]] const FMatrix4& GetWorldToView() const { return m_WorldToView; }
 		[[nodiscard]] const FMatrix4& GetViewToWorld() const { return m_ViewToWorld; }
-		[[nodiscard]] const FMatrix4& GetWorldViewProjection() const;
+		[[nodiscard]] const FMatrix4& GetViewProjection() const { return m_ViewProjection; }
+		[[nodiscard]] const FMatrix4& GetWorldViewProjection() const { return m_WorldViewProjection; }
 		[[nodiscard]] const FMatrix4& GetProjectionMatrix() const { return m_ProjectionMatrix; }
+		//Normalized world space planes of the view frustum (left, right, bottom, top, near, far), the inside is positive
+		[[nodiscard]] const FVector4* GetFrustumPlanes() const { return m_FrustumPlanes; }
+		//Changes whenever the view-projection does, so whatever was derived from it can tell it is stale.
+		//Unique across cameras, a cache filled through one camera is never taken as current for another.
+		[[nodiscard]] uint32_t GetVersion() const { return m_Version; }
 
 		[[nodiscard]] const float GetFov() const { return m_Fov; }
 
@@ -40,6 +47,7 @@ namespace Elite
 
 	private:
 		void CalculateLookAt();
+		void CalculateViewProjection();
 
 		float m_Fov{};
 
@@ -60,9 +68,13 @@ namespace Elite
 		FPoint3 m_Position{};
 		const FVector3 m_ViewForward{};
 
-		FMatrix4 m_TransformMatrix{};
+		FMatrix4 m_TransformMatrix{ FMatrix4::Identity() };
 		FMatrix4 m_WorldToView{};
 		FMatrix4 m_ViewToWorld{};
 		FMatrix4 m_ProjectionMatrix;
+		FMatrix4 m_ViewProjection{};
+		FMatrix4 m_WorldViewProjection{};
+		FVector4 m_FrustumPlanes[6]{};
+		uint32_t m_Version{};
 	};
 }
@@ -0,0 +1,91 @@
+/*=============================================================================*/
+// EFastMath.h: Approximations for the shading path, opt-in (include it where they are used)
+/*=============================================================================*/
+#ifndef ELITE_MATH_FAST
+#define ELITE_MATH_FAST
+
+//The error bounds below are measured over the whole valid range (--bench-math prints them again).
+//Nothing here handles NaN or infinity, and denormal inputs are treated as if they were 0.
+#include <cstring>
+#include <immintrin.h>
+
+namespace Elite
+{
+	//1 / sqrt(x) for x > 0: the SSE estimate (12 bits) refined by one Newton-Raphson step.
+	//Relative error below 3e-7 (1e-7 for the exact sqrt then divide).
+	inline float FastRsqrt(float x)
+	{
+		const float y = _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(x)));
+		return y * (1.5f - 0.5f * x * y * y);
+	}
+
+	//1 / x for x != 0, the SSE estimate refined by one Newton-Raphson step. Relative error below 2.5e-7.
+	inline float FastReciprocal(float x)
+	{
+		const float y = _mm_cvtss_f32(_mm_rcp_ss(_mm_set_ss(x)));
+		return y * (2.f - x * y);
+	}
+
+	//log2(x) for x > 0: the exponent bits plus a polynomial of the mantissa. Absolute error below 1.5e-5.
+	inline float FastLog2(float x)
+	{
+		uint32_t bits;
+		std::memcpy(&bits, &x, sizeof(float));
+
+		//The biased exponent as the mantissa of 2^23, no int to float conversion
+		const uint32_t exponentBits = (bits >> 23) | 0x4B000000;
+		float exponent;
+		std::memcpy(&exponent, &exponentBits, sizeof(float));
+		exponent -= 8388608.f + 127.f;
+
+		const uint32_t mantissaBits = (bits & 0x007FFFFF) | 0x3F800000;
+		float mantissa;
+		std::memcpy(&mantissa, &mantissaBits, sizeof(float));
+
+		//log2(1 + t) / t on [0, 1), minimax
+		const float t = mantissa - 1.f;
+		const float q = 1.44268491f + t * (-0.720522045f + t * (0.469933745f + t * (-0.30515276f + t * (0.148444206f + t * -0.0353983062f))));
+		return exponent + t * q;
+	}
+
+	//2^x, 0 below -125 and capped at 2^127. Relative error below 2.5e-7.
+	inline float FastExp2(float x)
+	{
+		if (x < -125.f)
+			return 0.f;
+		x = x < 127.f ? x : 127.f;
+
+		//Adding 1.5 * 2^23 rounds to the nearest integer, which lands in the low bits of the mantissa
+		const float shifted = x + 12582912.f;
+		uint32_t integer;
+		std::memcpy(&integer, &shifted, sizeof(float));
+		integer -= 0x4B400000;
+		const float f = x - (shifted - 12582912.f);
+
+		//2^f on [-0.5, 0.5], minimax, then the integer goes into the exponent
+		const float p = 1.00000008f + f * (0.693147225f + f * (0.240221074f + f * (0.055502973f + f * (0.00967603636f + f * 0.00134100054f))));
+		uint32_t bits;
+		std::memcpy(&bits, &p, sizeof(float));
+		bits += integer << 23;
+		float result;
+		std::memcpy(&result, &bits, sizeof(float));
+		return result;
+	}
+
+	//x^y for x > 0, as 2^(y log2(x)). The error of the log grows with y: the relative error is below 1e-5 * |y|
+	//plus 2.5e-7, so 2.5e-4 for the highest specular exponent of the software renderer (25).
+	inline float FastPow(float x, float y)
+	{
+		return FastExp2(y * FastLog2(x));
+	}
+
+	//GetNormalized with FastRsqrt instead of a square root and a divide, the zero vector stays zero
+	inline Vector<3, float> GetNormalizedFast(const Vector<3, float>& v)
+	{
+		const float sqrMagnitude = SqrMagnitude(v);
+		if (sqrMagnitude < std::numeric_limits<float>::min())
+			return Vector<3, float>{ 0.f, 0.f, 0.f };
+		return v * FastRsqrt(sqrMagnitude);
+	}
+}
+#endif
@@ -56,4 +56,42 @@ namespace Elite
 	typedef Matrix<4, 4, float>		FMatrix4;
 	typedef Matrix<4, 4, double>	DMatrix4;
 }
+
+/* --- SIMD --- */
+#include "EMathSIMD.h"
+#include "EMathBatch.h"
+
+/* --- COMPILE TIME CHECKS --- */
+//The constructors, operators and transforms are constexpr, so fixed transforms fold away at compile time.
+//These fail the build as soon as one of them stops being usable in a constant expression (or stops being right).
+namespace Elite
+{
+	namespace Detail
+	{
+		constexpr bool IsNear(float a, float b)
+		{ return a - b < 1e-6f && b - a < 1e-6f; }
+	}
+
+	static_assert(Dot(FVector3{ 1.f, 2.f, 3.f }, FVector3{ 4.f, -5.f, 6.f }) == 12.f);
+	static_assert(Dot(FVector4{ 1.f, 2.f, 3.f, 4.f }, FVector4{ 1.f, 1.f, 1.f, 1.f }) == 10.f);
+	static_assert(Cross(FVector3{ 1.f, 0.f, 0.f }, FVector3{ 0.f, 1.f, 0.f }).z == 1.f);
+	static_assert(Cross(FVector2{ 2.f, 0.f }, FVector2{ 0.f, 3.f }) == 6.f);
+	static_assert((FVector3{ 1.f, 2.f, 3.f } * 2.f - FVector3{ 1.f, 1.f, 1.f }).z == 5.f);
+	static_assert((FPoint3{ 1.f, 2.f, 3.f } - FPoint3{ 0.f, 2.f, 1.f }).x == 1.f);
+	static_assert(SqrMagnitude(FVector4{ 1.f, 2.f, 2.f, 4.f }) == 25.f);
+
+	static_assert(Transpose(MakeTranslation(FVector3{ 1.f, 2.f, 3.f }))(3, 1) == 2.f);
+	static_assert((MakeTranslation(FVector3{ 1.f, 2.f, 3.f }) * FPoint4{ 1.f, 1.f, 1.f }).z == 4.f);
+	static_assert((MakeTranslation(FVector3{ 1.f, 2.f, 3.f }) * FVector4{ 1.f, 1.f, 1.f }).z == 1.f);
+	static_assert((MakeTranslation(FVector3{ 1.f, 2.f, 3.f }) * MakeTranslation(FVector3{ 1.f, 1.f, 1.f }))(1, 3) == 3.f);
+	static_assert(Determinant(FMatrix4{ FMatrix3::Identity() * 2.f, FVector3{ 5.f, 6.f, 7.f } }) == 8.f);
+	static_assert((MakeTranslation(FVector2{ 4.f, 5.f }) * FPoint3{ 1.f, 1.f }).y == 6.f);
+
+	static_assert(Detail::IsNear(Sin(float(E_PI_DIV_2)), 1.f) && Detail::IsNear(Cos(float(E_PI)), -1.f));
+	static_assert(Detail::IsNear(Sin(float(-E_PI_4)), 0.f) && Detail::IsNear(Cos(float(E_PI_DIV_4)), 0.70710678f));
+	static_assert(Detail::IsNear((MakeRotationZ(float(E_PI_DIV_2)) * FVector3{ 1.f, 0.f, 0.f }).y, 1.f));
+	static_assert(Detail::IsNear((MakeRotation(float(E_PI), FVector3{ 0.f, 1.f, 0.f }) * FVector3{ 1.f, 0.f, 0.f }).x, -1.f));
+	static_assert(Detail::IsNear(Determinant(MakeRotationZYX(0.3f, -1.2f, 2.f)), 1.f));
+	static_assert(MakeRotationX(0.f)(1, 1) == 1.f && MakeRotation(0.f)(0, 1) == 0.f);
+}
 #endif
@@ -0,0 +1,280 @@
+/*=============================================================================*/
+// EMathBatch.h: Eight floats, vectors and points side by side (SoA), for kernels that work on a batch at once
+/*=============================================================================*/
+#ifndef ELITE_MATH_BATCH
+#define ELITE_MATH_BATCH
+
+//One AVX register per component when the build has AVX, two SSE registers otherwise. The functions mirror the scalar
+//API (Dot, Cross, Normalize, Reflect, Lerp...) so a kernel can move to batches without writing intrinsics, and the
+//comparisons return masks for Select instead of branching per lane.
+#include <immintrin.h>
+
+namespace Elite
+{
+	namespace Batch
+	{
+#if defined(__AVX__)
+		typedef __m256 Register;
+
+		inline Register Set(float f) { return _mm256_set1_ps(f); }
+		inline Register Load(const float* p) { return _mm256_loadu_ps(p); }
+		inline void Store(float* p, Register r) { _mm256_storeu_ps(p, r); }
+		inline Register Add(Register a, Register b) { return _mm256_add_ps(a, b); }
+		inline Register Sub(Register a, Register b) { return _mm256_sub_ps(a, b); }
+		inline Register Mul(Register a, Register b) { return _mm256_mul_ps(a, b); }
+		inline Register Div(Register a, Register b) { return _mm256_div_ps(a, b); }
+		inline Register Min(Register a, Register b) { return _mm256_min_ps(a, b); }
+		inline Register Max(Register a, Register b) { return _mm256_max_ps(a, b); }
+		inline Register Sqrt(Register a) { return _mm256_sqrt_ps(a); }
+#if defined(__FMA__) || defined(__AVX2__)
+		inline Register MultiplyAdd(Register a, Register b, Register c) { return _mm256_fmadd_ps(a, b, c); }
+#else
+		inline Register MultiplyAdd(Register a, Register b, Register c) { return _mm256_add_ps(_mm256_mul_ps(a, b), c); }
+#endif
+		inline Register Truncate(Register a) { return _mm256_cvtepi32_ps(_mm256_cvttps_epi32(a)); }
+		inline void StoreInt(uint32_t* p, Register r) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), _mm256_cvttps_epi32(r)); }
+		inline Register And(Register a, Register b) { return _mm256_and_ps(a, b); }
+		inline Register Or(Register a, Register b) { return _mm256_or_ps(a, b); }
+		inline Register Xor(Register a, Register b) { return _mm256_xor_ps(a, b); }
+		inline Register AndNot(Register a, Register b) { return _mm256_andnot_ps(a, b); } //~a & b
+		inline Register Not(Register a) { return _mm256_xor_ps(a, _mm256_castsi256_ps(_mm256_set1_epi32(-1))); }
+		inline Register Less(Register a, Register b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+		inline Register LessEqual(Register a, Register b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+		inline Register Equal(Register a, Register b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+		inline Register Select(Register mask, Register a, Register b) { return _mm256_blendv_ps(b, a, mask); }
+		inline int GetBits(Register mask) { return _mm256_movemask_ps(mask); }
+#else
+		struct Register { __m128 lo, hi; };
+
+		inline Register Set(float f) { return Register{ _mm_set1_ps(f), _mm_set1_ps(f) }; }
+		inline Register Load(const float* p) { return Register{ _mm_loadu_ps(p), _mm_loadu_ps(p + 4) }; }
+		inline void Store(float* p, Register r) { _mm_storeu_ps(p, r.lo); _mm_storeu_ps(p + 4, r.hi); }
+		inline Register Add(Register a, Register b) { return Register{ _mm_add_ps(a.lo, b.lo), _mm_add_ps(a.hi, b.hi) }; }
+		inline Register Sub(Register a, Register b) { return Register{ _mm_sub_ps(a.lo, b.lo), _mm_sub_ps(a.hi, b.hi) }; }
+		inline Register Mul(Register a, Register b) { return Register{ _mm_mul_ps(a.lo, b.lo), _mm_mul_ps(a.hi, b.hi) }; }
+		inline Register Div(Register a, Register b) { return Register{ _mm_div_ps(a.lo, b.lo), _mm_div_ps(a.hi, b.hi) }; }
+		inline Register Min(Register a, Register b) { return Register{ _mm_min_ps(a.lo, b.lo), _mm_min_ps(a.hi, b.hi) }; }
+		inline Register Max(Register a, Register b) { return Register{ _mm_max_ps(a.lo, b.lo), _mm_max_ps(a.hi, b.hi) }; }
+		inline Register Sqrt(Register a) { return Register{ _mm_sqrt_ps(a.lo), _mm_sqrt_ps(a.hi) }; }
+		inline Register MultiplyAdd(Register a, Register b, Register c) { return Register{ _mm_add_ps(_mm_mul_ps(a.lo, b.lo), c.lo), _mm_add_ps(_mm_mul_ps(a.hi, b.hi), c.hi) }; }
+		inline Register Truncate(Register a) { return Register{ _mm_cvtepi32_ps(_mm_cvttps_epi32(a.lo)), _mm_cvtepi32_ps(_mm_cvttps_epi32(a.hi)) }; }
+		inline void StoreInt(uint32_t* p, Register r)
+		{
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(p), _mm_cvttps_epi32(r.lo));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(p + 4), _mm_cvttps_epi32(r.hi));
+		}
+		inline Register And(Register a, Register b) { return Register{ _mm_and_ps(a.lo, b.lo), _mm_and_ps(a.hi, b.hi) }; }
+		inline Register Or(Register a, Register b) { return Register{ _mm_or_ps(a.lo, b.lo), _mm_or_ps(a.hi, b.hi) }; }
+		inline Register Xor(Register a, Register b) { return Register{ _mm_xor_ps(a.lo, b.lo), _mm_xor_ps(a.hi, b.hi) }; }
+		inline Register AndNot(Register a, Register b) { return Register{ _mm_andnot_ps(a.lo, b.lo), _mm_andnot_ps(a.hi, b.hi) }; } //~a & b
+		inline Register Not(Register a)
+		{
+			const __m128 allOnes{ _mm_castsi128_ps(_mm_set1_epi32(-1)) };
+			return Register{ _mm_xor_ps(a.lo, allOnes), _mm_xor_ps(a.hi, allOnes) };
+		}
+		inline Register Less(Register a, Register b) { return Register{ _mm_cmplt_ps(a.lo, b.lo), _mm_cmplt_ps(a.hi, b.hi) }; }
+		inline Register LessEqual(Register a, Register b) { return Register{ _mm_cmple_ps(a.lo, b.lo), _mm_cmple_ps(a.hi, b.hi) }; }
+		inline Register Equal(Register a, Register b) { return Register{ _mm_cmpeq_ps(a.lo, b.lo), _mm_cmpeq_ps(a.hi, b.hi) }; }
+		inline Register Select(Register mask, Register a, Register b) { return Or(And(mask, a), AndNot(mask, b)); }
+		inline int GetBits(Register mask) { return _mm_movemask_ps(mask.lo) | _mm_movemask_ps(mask.hi) << 4; }
+#endif
+	}
+
+	//=== MASK ===
+	//Result of a comparison, every lane all ones or all zeros
+	struct FMask8
+	{
+		Batch::Register r;
+
+		inline FMask8 operator&(const FMask8& m) const { return FMask8{ Batch::And(r, m.r) }; }
+		inline FMask8 operator|(const FMask8& m) const { return FMask8{ Batch::Or(r, m.r) }; }
+		//A true lane is all ones, a NaN, so comparing the mask with itself can't make the ones to flip it with
+		inline FMask8 operator!() const { return FMask8{ Batch::Not(r) }; }
+	};
+
+	//Lane i is bit i
+	inline int GetBits(const FMask8& m) { return Batch::GetBits(m.r); }
+	inline bool Any(const FMask8& m) { return GetBits(m) != 0; }
+	inline bool All(const FMask8& m) { return GetBits(m) == 0xFF; }
+
+	//=== FLOAT ===
+	struct FFloat8
+	{
+		Batch::Register r;
+
+		//=== Constructors ===
+#pragma region Constructors
+		FFloat8() = default;
+		FFloat8(float f) : r(Batch::Set(f)) {} //The same value in every lane
+		explicit FFloat8(Batch::Register _r) : r(_r) {}
+
+		static FFloat8 Load(const float* p) { return FFloat8{ Batch::Load(p) }; } //8 floats, no alignment needed
+		inline void Store(float* p) const { Batch::Store(p, r); }
+#pragma endregion
+
+		//=== Arithmetic Operators ===
+#pragma region ArithmeticOperators
+		inline FFloat8 operator+(const FFloat8& f) const { return FFloat8{ Batch::Add(r, f.r) }; }
+		inline FFloat8 operator-(const FFloat8& f) const { return FFloat8{ Batch::Sub(r, f.r) }; }
+		inline FFloat8 operator*(const FFloat8& f) const { return FFloat8{ Batch::Mul(r, f.r) }; }
+		inline FFloat8 operator/(const FFloat8& f) const { return FFloat8{ Batch::Div(r, f.r) }; }
+		inline FFloat8 operator-() const { return FFloat8{ Batch::Xor(r, Batch::Set(-0.f)) }; }
+
+		inline FFloat8& operator+=(const FFloat8& f) { r = Batch::Add(r, f.r); return *this; }
+		inline FFloat8& operator-=(const FFloat8& f) { r = Batch::Sub(r, f.r); return *this; }
+		inline FFloat8& operator*=(const FFloat8& f) { r = Batch::Mul(r, f.r); return *this; }
+		inline FFloat8& operator/=(const FFloat8& f) { r = Batch::Div(r, f.r); return *this; }
+#pragma endregion
+
+		//=== Relational Operators ===
+#pragma region RelationalOperators
+		inline FMask8 operator<(const FFloat8& f) const { return FMask8{ Batch::Less(r, f.r) }; }
+		inline FMask8 operator<=(const FFloat8& f) const { return FMask8{ Batch::LessEqual(r, f.r) }; }
+		inline FMask8 operator>(const FFloat8& f) const { return FMask8{ Batch::Less(f.r, r) }; }
+		inline FMask8 operator>=(const FFloat8& f) const { return FMask8{ Batch::LessEqual(f.r, r) }; }
+		inline FMask8 operator==(const FFloat8& f) const { return FMask8{ Batch::Equal(r, f.r) }; }
+#pragma endregion
+	};
+
+	//Float on the left, like 2.f * v
+	inline FFloat8 operator+(float f, const FFloat8& b) { return FFloat8{ f } + b; }
+	inline FFloat8 operator-(float f, const FFloat8& b) { return FFloat8{ f } - b; }
+	inline FFloat8 operator*(float f, const FFloat8& b) { return FFloat8{ f } * b; }
+	inline FFloat8 operator/(float f, const FFloat8& b) { return FFloat8{ f } / b; }
+
+	inline FFloat8 Min(const FFloat8& a, const FFloat8& b) { return FFloat8{ Batch::Min(a.r, b.r) }; }
+	inline FFloat8 Max(const FFloat8& a, const FFloat8& b) { return FFloat8{ Batch::Max(a.r, b.r) }; }
+	inline FFloat8 Clamp(const FFloat8& f, const FFloat8& min, const FFloat8& max) { return Min(Max(f, min), max); }
+	inline FFloat8 Sqrt(const FFloat8& f) { return FFloat8{ Batch::Sqrt(f.r) }; }
+	inline FFloat8 Abs(const FFloat8& f) { return FFloat8{ Batch::AndNot(Batch::Set(-0.f), f.r) }; }
+	//a where the mask is set, b elsewhere
+	inline FFloat8 Select(const FMask8& m, const FFloat8& a, const FFloat8& b) { return FFloat8{ Batch::Select(m.r, a.r, b.r) }; }
+	inline FFloat8 Lerp(const FFloat8& v0, const FFloat8& v1, const FFloat8& t) { return v0 + (v1 - v0) * t; }
+	//a * b + c, a single rounding where the build has FMA
+	inline FFloat8 MultiplyAdd(const FFloat8& a, const FFloat8& b, const FFloat8& c) { return FFloat8{ Batch::MultiplyAdd(a.r, b.r, c.r) }; }
+	//Towards zero, for values that fit in an int
+	inline FFloat8 Truncate(const FFloat8& f) { return FFloat8{ Batch::Truncate(f.r) }; }
+
+	//=== VECTOR2 ===
+	struct FVector2x8
+	{
+		FFloat8 x, y;
+
+		FVector2x8() = default;
+		FVector2x8(const FFloat8& _x, const FFloat8& _y) : x(_x), y(_y) {}
+		explicit FVector2x8(const Vector<2, float>& v) : x(v.x), y(v.y) {} //The same vector in every lane
+
+		inline FVector2x8 operator+(const FVector2x8& v) const { return FVector2x8{ x + v.x, y + v.y }; }
+		inline FVector2x8 operator-(const FVector2x8& v) const { return FVector2x8{ x - v.x, y - v.y }; }
+		inline FVector2x8 operator*(const FFloat8& scale) const { return FVector2x8{ x * scale, y * scale }; }
+		inline FVector2x8 operator/(const FFloat8& scale) const { const FFloat8 revS = 1.f / scale; return FVector2x8{ x * revS, y * revS }; }
+	};
+
+	inline FVector2x8 Select(const FMask8& m, const FVector2x8& a, const FVector2x8& b)
+	{ return FVector2x8{ Select(m, a.x, b.x), Select(m, a.y, b.y) }; }
+
+	inline FVector2x8 Lerp(const FVector2x8& v0, const FVector2x8& v1, const FFloat8& t)
+	{ return FVector2x8{ Lerp(v0.x, v1.x, t), Lerp(v0.y, v1.y, t) }; }
+
+	//=== VECTOR3 ===
+	struct FVector3x8
+	{
+		FFloat8 x, y, z;
+
+		FVector3x8() = default;
+		FVector3x8(const FFloat8& _x, const FFloat8& _y, const FFloat8& _z) : x(_x), y(_y), z(_z) {}
+		explicit FVector3x8(const Vector<3, float>& v) : x(v.x), y(v.y), z(v.z) {} //The same vector in every lane
+
+		inline FVector3x8 operator+(const FVector3x8& v) const { return FVector3x8{ x + v.x, y + v.y, z + v.z }; }
+		inline FVector3x8 operator-(const FVector3x8& v) const { return FVector3x8{ x - v.x, y - v.y, z - v.z }; }
+		inline FVector3x8 operator*(const FFloat8& scale) const { return FVector3x8{ x * scale, y * scale, z * scale }; }
+		inline FVector3x8 operator/(const FFloat8& scale) const { const FFloat8 revS = 1.f / scale; return FVector3x8{ x * revS, y * revS, z * revS }; }
+		inline FVector3x8 operator-() const { return FVector3x8{ -x, -y, -z }; }
+
+		inline FVector3x8& operator+=(const FVector3x8& v) { x += v.x; y += v.y; z += v.z; return *this; }
+		inline FVector3x8& operator-=(const FVector3x8& v) { x -= v.x; y -= v.y; z -= v.z; return *this; }
+		inline FVector3x8& operator*=(const FFloat8& scale) { x *= scale; y *= scale; z *= scale; return *this; }
+	};
+
+	inline FVector3x8 operator*(const FFloat8& scale, const FVector3x8& v) { return v * scale; }
+
+	inline FFloat8 Dot(const FVector3x8& v1, const FVector3x8& v2)
+	{ return v1.x * v2.x + v1.y * v2.y + v1.z * v2.z; }
+
+	inline FVector3x8 Cross(const FVector3x8& v1, const FVector3x8& v2)
+	{ return FVector3x8{ v1.y * v2.z - v1.z * v2.y, v1.z * v2.x - v1.x * v2.z, v1.x * v2.y - v1.y * v2.x }; }
+
+	inline FFloat8 SqrMagnitude(const FVector3x8& v)
+	{ return Dot(v, v); }
+
+	inline FFloat8 Magnitude(const FVector3x8& v)
+	{ return Sqrt(SqrMagnitude(v)); }
+
+	//Like the scalar one: returns the magnitudes, and lanes of length 0 become the zero vector
+	inline FFloat8 Normalize(FVector3x8& v)
+	{
+		const FFloat8 m = Magnitude(v);
+		const FMask8 isZero = m <= FFloat8{ FLT_MIN };
+		v *= Select(isZero, FFloat8{ 0.f }, 1.f / m);
+		return m;
+	}
+
+	inline FVector3x8 GetNormalized(const FVector3x8& v)
+	{
+		FVector3x8 cv = v;
+		Normalize(cv);
+		return cv;
+	}
+
+	//Returns the reflect vector d around n
+	inline FVector3x8 Reflect(const FVector3x8& d, const FVector3x8& n)
+	{ return d - 2.f * Dot(d, n) * n; }
+
+	inline FVector3x8 Select(const FMask8& m, const FVector3x8& a, const FVector3x8& b)
+	{ return FVector3x8{ Select(m, a.x, b.x), Select(m, a.y, b.y), Select(m, a.z, b.z) }; }
+
+	inline FVector3x8 Lerp(const FVector3x8& v0, const FVector3x8& v1, const FFloat8& t)
+	{ return FVector3x8{ Lerp(v0.x, v1.x, t), Lerp(v0.y, v1.y, t), Lerp(v0.z, v1.z, t) }; }
+
+	//=== POINT4 ===
+	struct FPoint4x8
+	{
+		FFloat8 x, y, z, w;
+
+		FPoint4x8() = default;
+		FPoint4x8(const FFloat8& _x, const FFloat8& _y, const FFloat8& _z, const FFloat8& _w = 1.f) : x(_x), y(_y), z(_z), w(_w) {}
+		explicit FPoint4x8(const Point<4, float>& p) : x(p.x), y(p.y), z(p.z), w(p.w) {} //The same point in every lane
+
+		inline FPoint4x8 operator+(const FVector3x8& v) const { return FPoint4x8{ x + v.x, y + v.y, z + v.z, w }; }
+		inline FPoint4x8 operator-(const FVector3x8& v) const { return FPoint4x8{ x - v.x, y - v.y, z - v.z, w }; }
+		//Of the x, y and z, for points that still have w 1
+		inline FVector3x8 operator-(const FPoint4x8& p) const { return FVector3x8{ x - p.x, y - p.y, z - p.z }; }
+	};
+
+	inline FPoint4x8 Select(const FMask8& m, const FPoint4x8& a, const FPoint4x8& b)
+	{ return FPoint4x8{ Select(m, a.x, b.x), Select(m, a.y, b.y), Select(m, a.z, b.z), Select(m, a.w, b.w) }; }
+
+	inline FPoint4x8 Lerp(const FPoint4x8& p0, const FPoint4x8& p1, const FFloat8& t)
+	{ return FPoint4x8{ Lerp(p0.x, p1.x, t), Lerp(p0.y, p1.y, t), Lerp(p0.z, p1.z, t), Lerp(p0.w, p1.w, t) }; }
+
+	//=== MATRIX4x4 TIMES BATCH ===
+	//Takes into account translation, like the scalar Matrix * Point the w of the points is taken as 1
+	inline FPoint4x8 operator*(const Matrix<4, 4, float>& m, const FPoint4x8& p)
+	{
+		return FPoint4x8{
+			m(0, 0) * p.x + m(0, 1) * p.y + m(0, 2) * p.z + m(0, 3),
+			m(1, 0) * p.x + m(1, 1) * p.y + m(1, 2) * p.z + m(1, 3),
+			m(2, 0) * p.x + m(2, 1) * p.y + m(2, 2) * p.z + m(2, 3),
+			m(3, 0) * p.x + m(3, 1) * p.y + m(3, 2) * p.z + m(3, 3) };
+	}
+
+	//No translation, see the reminder in EMatrix4.h about transforming normals
+	inline FVector3x8 operator*(const Matrix<4, 4, float>& m, const FVector3x8& v)
+	{
+		return FVector3x8{
+			m(0, 0) * v.x + m(0, 1) * v.y + m(0, 2) * v.z,
+			m(1, 0) * v.x + m(1, 1) * v.y + m(1, 2) * v.z,
+			m(2, 0) * v.x + m(2, 1) * v.y + m(2, 2) * v.z };
+	}
+}
+#endif
@@ -0,0 +1,308 @@
+/*=============================================================================*/
+// EMathSIMD.h: SSE/AVX versions of the float Matrix4x4, Vector4 and Point4 operations
+/*=============================================================================*/
+#ifndef ELITE_MATH_SIMD
+#define ELITE_MATH_SIMD
+
+//Picked at compile time wherever SSE2 is there (every x64 build), define ELITE_MATH_SCALAR to build the plain templates
+//instead, to compare against. The public API stays the same, these are specializations of the float members.
+//The 3 component types stay scalar: they are 12 bytes, loading and storing them costs more than the math saves.
+//Intrinsics cannot be evaluated at compile time, so in constant expressions every one takes the scalar branch instead.
+#if !defined(ELITE_MATH_SCALAR) && (defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define ELITE_MATH_USE_SIMD
+#include <immintrin.h>
+
+namespace Elite
+{
+	namespace Simd
+	{
+		template<int x, int y, int z, int w>
+		inline __m128 Swizzle(__m128 v)
+		{ return _mm_shuffle_ps(v, v, _MM_SHUFFLE(w, z, y, x)); }
+
+		template<int x, int y, int z, int w>
+		inline __m128 Shuffle(__m128 a, __m128 b) //x, y from a and z, w from b
+		{ return _mm_shuffle_ps(a, b, _MM_SHUFFLE(w, z, y, x)); }
+
+		inline __m128 MultiplyAdd(__m128 a, __m128 b, __m128 c)
+		{
+#if defined(__FMA__) || defined(__AVX2__)
+			return _mm_fmadd_ps(a, b, c);
+#else
+			return _mm_add_ps(_mm_mul_ps(a, b), c);
+#endif
+		}
+
+		//2x2 matrices (a b c d, row by row) for the block inverse: a * b, adj(a) * b and a * adj(b)
+		inline __m128 Matrix2Multiply(__m128 a, __m128 b)
+		{ return _mm_add_ps(_mm_mul_ps(a, Swizzle<0, 3, 0, 3>(b)), _mm_mul_ps(Swizzle<1, 0, 3, 2>(a), Swizzle<2, 1, 2, 1>(b))); }
+
+		inline __m128 Matrix2AdjugateMultiply(__m128 a, __m128 b)
+		{ return _mm_sub_ps(_mm_mul_ps(Swizzle<3, 3, 0, 0>(a), b), _mm_mul_ps(Swizzle<1, 1, 2, 2>(a), Swizzle<2, 3, 0, 1>(b))); }
+
+		inline __m128 Matrix2MultiplyAdjugate(__m128 a, __m128 b)
+		{ return _mm_sub_ps(_mm_mul_ps(a, Swizzle<3, 0, 3, 0>(b)), _mm_mul_ps(Swizzle<1, 0, 3, 2>(a), Swizzle<2, 1, 2, 1>(b))); }
+	}
+
+	//=== MATRIX4x4 ===
+#pragma region Matrix4
+	template<>
+	constexpr Matrix<4, 4, float> Matrix<4, 4, float>::operator*(const Matrix<4, 4, float>& rm) const
+	{
+		if (std::is_constant_evaluated())
+		{
+			Matrix<4, 4, float> r{};
+			for (int c = 0; c < 4; ++c)
+				for (int row = 0; row < 4; ++row)
+					r.data[c][row] = data[0][row] * rm.data[c][0] + data[1][row] * rm.data[c][1] + data[2][row] * rm.data[c][2] + data[3][row] * rm.data[c][3];
+			return r;
+		}
+
+		//Every column of the result is this matrix times that column of rm
+		Matrix<4, 4, float> r;
+#if defined(__AVX__)
+		//Two columns at once, this matrix is in both halves. The matrices are only 16 byte aligned, hence the unaligned loads
+		const __m256 c0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(data[0]));
+		const __m256 c1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(data[1]));
+		const __m256 c2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(data[2]));
+		const __m256 c3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(data[3]));
+		for (int c = 0; c < 4; c += 2)
+		{
+			const __m256 v = _mm256_loadu_ps(rm.data[c]);
+			__m256 column = _mm256_mul_ps(c0, _mm256_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0)));
+			column = _mm256_add_ps(column, _mm256_mul_ps(c1, _mm256_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1))));
+			column = _mm256_add_ps(column, _mm256_mul_ps(c2, _mm256_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2))));
+			column = _mm256_add_ps(column, _mm256_mul_ps(c3, _mm256_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3))));
+			_mm256_storeu_ps(r.data[c], column);
+		}
+#else
+		const __m128 c0 = _mm_load_ps(data[0]);
+		const __m128 c1 = _mm_load_ps(data[1]);
+		const __m128 c2 = _mm_load_ps(data[2]);
+		const __m128 c3 = _mm_load_ps(data[3]);
+		for (int c = 0; c < 4; ++c)
+		{
+			const __m128 v = _mm_load_ps(rm.data[c]);
+			__m128 column = _mm_mul_ps(c0, Simd::Swizzle<0, 0, 0, 0>(v));
+			column = Simd::MultiplyAdd(c1, Simd::Swizzle<1, 1, 1, 1>(v), column);
+			column = Simd::MultiplyAdd(c2, Simd::Swizzle<2, 2, 2, 2>(v), column);
+			column = Simd::MultiplyAdd(c3, Simd::Swizzle<3, 3, 3, 3>(v), column);
+			_mm_store_ps(r.data[c], column);
+		}
+#endif
+		return r;
+	}
+
+	template<>
+	constexpr Vector<4, float> Matrix<4, 4, float>::operator*(const Vector<4, float>& v)
+	{
+		if (std::is_constant_evaluated())
+		{
+			return Vector<4, float>(
+				data[0][0] * v.x + data[1][0] * v.y + data[2][0] * v.z,
+				data[0][1] * v.x + data[1][1] * v.y + data[2][1] * v.z,
+				data[0][2] * v.x + data[1][2] * v.y + data[2][2] * v.z, 0.f);
+		}
+
+		//No translation and w is 0, the fourth row of the matrix does not count
+		const __m128 p = _mm_loadu_ps(v.data);
+		__m128 r = _mm_mul_ps(_mm_load_ps(data[0]), Simd::Swizzle<0, 0, 0, 0>(p));
+		r = Simd::MultiplyAdd(_mm_load_ps(data[1]), Simd::Swizzle<1, 1, 1, 1>(p), r);
+		r = Simd::MultiplyAdd(_mm_load_ps(data[2]), Simd::Swizzle<2, 2, 2, 2>(p), r);
+		r = _mm_and_ps(r, _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1)));
+
+		Vector<4, float> result;
+		_mm_storeu_ps(result.data, r);
+		return result;
+	}
+
+	template<>
+	constexpr Point<4, float> Matrix<4, 4, float>::operator*(const Point<4, float>& p)
+	{
+		//Like the templates, w of the point is taken as 1
+		if (std::is_constant_evaluated())
+		{
+			return Point<4, float>(
+				data[0][0] * p.x + data[1][0] * p.y + data[2][0] * p.z + data[3][0],
+				data[0][1] * p.x + data[1][1] * p.y + data[2][1] * p.z + data[3][1],
+				data[0][2] * p.x + data[1][2] * p.y + data[2][2] * p.z + data[3][2],
+				data[0][3] * p.x + data[1][3] * p.y + data[2][3] * p.z + data[3][3]);
+		}
+
+		const __m128 v = _mm_loadu_ps(p.data);
+		__m128 r = Simd::MultiplyAdd(_mm_load_ps(data[0]), Simd::Swizzle<0, 0, 0, 0>(v), _mm_load_ps(data[3]));
+		r = Simd::MultiplyAdd(_mm_load_ps(data[1]), Simd::Swizzle<1, 1, 1, 1>(v), r);
+		r = Simd::MultiplyAdd(_mm_load_ps(data[2]), Simd::Swizzle<2, 2, 2, 2>(v), r);
+
+		Point<4, float> result;
+		_mm_storeu_ps(result.data, r);
+		return result;
+	}
+
+	constexpr Matrix<4, 4, float> Transpose(const Matrix<4, 4, float>& m)
+	{
+		if (std::is_constant_evaluated())
+		{
+			Matrix<4, 4, float> t{};
+			for (int c = 0; c < 4; ++c)
+				for (int r = 0; r < 4; ++r)
+					t.data[c][r] = m.data[r][c];
+			return t;
+		}
+
+		__m128 c0 = _mm_load_ps(m.data[0]);
+		__m128 c1 = _mm_load_ps(m.data[1]);
+		__m128 c2 = _mm_load_ps(m.data[2]);
+		__m128 c3 = _mm_load_ps(m.data[3]);
+		_MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+		Matrix<4, 4, float> t;
+		_mm_store_ps(t.data[0], c0);
+		_mm_store_ps(t.data[1], c1);
+		_mm_store_ps(t.data[2], c2);
+		_mm_store_ps(t.data[3], c3);
+		return t;
+	}
+
+	inline Matrix<4, 4, float> Inverse(const Matrix<4, 4, float>& m)
+	{
+		//Block inverse with 2x2 sub matrices A B C D. It works on the columns as if they were rows: the inverse of the
+		//transpose is the transpose of the inverse, so the result lands in the right layout.
+		const __m128 c0 = _mm_load_ps(m.data[0]);
+		const __m128 c1 = _mm_load_ps(m.data[1]);
+		const __m128 c2 = _mm_load_ps(m.data[2]);
+		const __m128 c3 = _mm_load_ps(m.data[3]);
+		const __m128 a = _mm_movelh_ps(c0, c1);
+		const __m128 b = _mm_movehl_ps(c1, c0);
+		const __m128 c = _mm_movelh_ps(c2, c3);
+		const __m128 d = _mm_movehl_ps(c3, c2);
+
+		//|A| |B| |C| |D|
+		const __m128 detSub = _mm_sub_ps(
+			_mm_mul_ps(Simd::Shuffle<0, 2, 0, 2>(c0, c2), Simd::Shuffle<1, 3, 1, 3>(c1, c3)),
+			_mm_mul_ps(Simd::Shuffle<1, 3, 1, 3>(c0, c2), Simd::Shuffle<0, 2, 0, 2>(c1, c3)));
+		const __m128 detA = Simd::Swizzle<0, 0, 0, 0>(detSub);
+		const __m128 detB = Simd::Swizzle<1, 1, 1, 1>(detSub);
+		const __m128 detC = Simd::Swizzle<2, 2, 2, 2>(detSub);
+		const __m128 detD = Simd::Swizzle<3, 3, 3, 3>(detSub);
+
+		const __m128 dc = Simd::Matrix2AdjugateMultiply(d, c);
+		const __m128 ab = Simd::Matrix2AdjugateMultiply(a, b);
+		__m128 x = _mm_sub_ps(_mm_mul_ps(detD, a), Simd::Matrix2Multiply(b, dc));
+		__m128 w = _mm_sub_ps(_mm_mul_ps(detA, d), Simd::Matrix2Multiply(c, ab));
+		__m128 y = _mm_sub_ps(_mm_mul_ps(detB, c), Simd::Matrix2MultiplyAdjugate(d, ab));
+		__m128 z = _mm_sub_ps(_mm_mul_ps(detC, b), Simd::Matrix2MultiplyAdjugate(a, dc));
+
+		//|M| = |A| |D| + |B| |C| - trace(adj(A) B adj(D) C)
+		__m128 trace = _mm_mul_ps(ab, Simd::Swizzle<0, 2, 1, 3>(dc));
+		trace = _mm_add_ps(trace, Simd::Swizzle<1, 0, 3, 2>(trace));
+		trace = _mm_add_ps(trace, Simd::Swizzle<2, 3, 0, 1>(trace));
+		const __m128 det = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC)), trace);
+		assert((!AreEqual(_mm_cvtss_f32(det), 0.f)) && "ERROR: determinant is 0, there is no INVERSE!");
+
+		//The signs of the adjugate of every block
+		const __m128 invDet = _mm_div_ps(_mm_setr_ps(1.f, -1.f, -1.f, 1.f), det);
+		x = _mm_mul_ps(x, invDet);
+		y = _mm_mul_ps(y, invDet);
+		z = _mm_mul_ps(z, invDet);
+		w = _mm_mul_ps(w, invDet);
+
+		Matrix<4, 4, float> r;
+		_mm_store_ps(r.data[0], Simd::Shuffle<3, 1, 3, 1>(x, y));
+		_mm_store_ps(r.data[1], Simd::Shuffle<2, 0, 2, 0>(x, y));
+		_mm_store_ps(r.data[2], Simd::Shuffle<3, 1, 3, 1>(z, w));
+		_mm_store_ps(r.data[3], Simd::Shuffle<2, 0, 2, 0>(z, w));
+		return r;
+	}
+#pragma endregion
+
+	//=== VECTOR4 ===
+#pragma region Vector4
+	template<>
+	template<>
+	constexpr Vector<4, float> Vector<4, float>::operator+(const Vector<4, float>& v) const
+	{
+		if (std::is_constant_evaluated())
+			return Vector<4, float>(x + v.x, y + v.y, z + v.z, w + v.w);
+
+		Vector<4, float> r;
+		_mm_storeu_ps(r.data, _mm_add_ps(_mm_loadu_ps(data), _mm_loadu_ps(v.data)));
+		return r;
+	}
+
+	template<>
+	template<>
+	constexpr Vector<4, float> Vector<4, float>::operator-(const Vector<4, float>& v) const
+	{
+		if (std::is_constant_evaluated())
+			return Vector<4, float>(x - v.x, y - v.y, z - v.z, w - v.w);
+
+		Vector<4, float> r;
+		_mm_storeu_ps(r.data, _mm_sub_ps(_mm_loadu_ps(data), _mm_loadu_ps(v.data)));
+		return r;
+	}
+
+	template<>
+	constexpr Vector<4, float> Vector<4, float>::operator*(float scale) const
+	{
+		if (std::is_constant_evaluated())
+			return Vector<4, float>(x * scale, y * scale, z * scale, w * scale);
+
+		Vector<4, float> r;
+		_mm_storeu_ps(r.data, _mm_mul_ps(_mm_loadu_ps(data), _mm_set1_ps(scale)));
+		return r;
+	}
+
+	constexpr float Dot(const Vector<4, float>& v1, const Vector<4, float>& v2)
+	{
+		if (std::is_constant_evaluated())
+			return v1.x * v2.x + v1.y * v2.y + v1.z * v2.z + v1.w * v2.w;
+
+		__m128 r = _mm_mul_ps(_mm_loadu_ps(v1.data), _mm_loadu_ps(v2.data));
+		r = _mm_add_ps(r, Simd::Swizzle<2, 3, 0, 1>(r));
+		r = _mm_add_ss(r, Simd::Swizzle<1, 0, 3, 2>(r));
+		return _mm_cvtss_f32(r);
+	}
+#pragma endregion
+
+	//=== POINT4 ===
+#pragma region Point4
+	template<>
+	template<>
+	constexpr Point<4, float> Point<4, float>::operator+(const Vector<4, float>& v) const
+	{
+		if (std::is_constant_evaluated())
+			return Point<4, float>(x + v.x, y + v.y, z + v.z, w + v.w);
+
+		Point<4, float> r;
+		_mm_storeu_ps(r.data, _mm_add_ps(_mm_loadu_ps(data), _mm_loadu_ps(v.data)));
+		return r;
+	}
+
+	template<>
+	template<>
+	constexpr Point<4, float> Point<4, float>::operator-(const Vector<4, float>& v) const
+	{
+		if (std::is_constant_evaluated())
+			return Point<4, float>(x - v.x, y - v.y, z - v.z, w - v.w);
+
+		Point<4, float> r;
+		_mm_storeu_ps(r.data, _mm_sub_ps(_mm_loadu_ps(data), _mm_loadu_ps(v.data)));
+		return r;
+	}
+
+	template<>
+	template<>
+	constexpr Vector<4, float> Point<4, float>::operator-(const Point<4, float>& p) const
+	{
+		if (std::is_constant_evaluated())
+			return Vector<4, float>(x - p.x, y - p.y, z - p.z, w - p.w);
+
+		Vector<4, float> r;
+		_mm_storeu_ps(r.data, _mm_sub_ps(_mm_loadu_ps(data), _mm_loadu_ps(p.data)));
+		return r;
+	}
+#pragma endregion
+}
+#endif
+#endif
@@ -10,6 +10,7 @@
 //Standard C++ includes
 #include <cstdint>
 #include <cstdlib>
+#include <cmath>
 #include <cfloat>
 #include <limits>
 #include <type_traits>
@@ -94,6 +95,42 @@ namespace Elite
 		return a;
 	}
 
+	namespace Detail
+	{
+		/*! Sine or cosine as a Taylor series in double, after reducing the angle to [-PI, PI] (angles below 2^62 radians) */
+		constexpr double SinCosSeries(double angle, bool isCosine)
+		{
+			angle -= E_PI_2 * static_cast<double>(static_cast<int64_t>(angle / E_PI_2 + (angle < 0 ? -0.5 : 0.5)));
+			const double sqrAngle = angle * angle;
+			double term = isCosine ? 1.0 : angle;
+			double sum = term;
+			for (int n = isCosine ? 1 : 2; n < 40; n += 2)
+			{
+				term *= -sqrAngle / (n * (n + 1));
+				sum += term;
+			}
+			return sum;
+		}
+	}
+
+	/*! Sine that also works in constant expressions, the CRT sin at runtime */
+	template<typename T>
+	constexpr T Sin(T angle)
+	{
+		if (std::is_constant_evaluated())
+			return static_cast<T>(Detail::SinCosSeries(static_cast<double>(angle), false));
+		return static_cast<T>(sin(angle));
+	}
+
+	/*! Cosine that also works in constant expressions, the CRT cos at runtime */
+	template<typename T>
+	constexpr T Cos(T angle)
+	{
+		if (std::is_constant_evaluated())
+			return static_cast<T>(Detail::SinCosSeries(static_cast<double>(angle), true));
+		return static_cast<T>(cos(angle));
+	}
+
 	/*! Set Random Seed */
 	inline void SetRandomSeed(const int32_t seed)
 	{ srand(seed); }
@@ -112,7 +149,7 @@ namespace Elite
 
 	/*! Linear Interpolation */
 	template<typename T>
-	inline T Lerp(T v0, T v1, float t)
+	constexpr T Lerp(T v0, T v1, float t)
 	{ return (1 - t) * v0 + t * v1;	}
 
 	/*! Smooth Step */
@@ -34,13 +34,13 @@ namespace Elite
 		//=== Member Access Operators ===
 #pragma region MemberAccessOperators
 		//Access parameter order still happens as row,column indexing (standard in programming)
-		inline T operator()(uint8_t r, uint8_t c) const
+		constexpr T operator()(uint8_t r, uint8_t c) const
 		{
 			assert((r < M && c < N) && "ERROR: indices of Matrix () const operator are out of bounds!");
 			return (data[c][r]);
 		}
 
-		inline T& operator()(uint8_t r, uint8_t c)
+		constexpr T& operator()(uint8_t r, uint8_t c)
 		{
 			assert((r < M && c < N) && "ERROR: indices of Matrix () operator are out of bounds!");
 			return (data[c][r]);
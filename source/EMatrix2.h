@@ -24,24 +24,24 @@ namespace Elite
 #pragma region Constructors
 		Matrix<2, 2, T>() = default;
 		//Every "row" of values passed here is a row in our matrix!
-		Matrix<2, 2, T>(T _00, T _01,
+		constexpr Matrix<2, 2, T>(T _00, T _01,
 						T _10, T _11)
 		{
 			data[0][0] = _00; data[0][1] = _10;
 			data[1][0] = _01; data[1][1] = _11;
 		}
 		//Every vector passed here is a column in our matrix!
-		Matrix<2, 2, T>(const Vector<2, T>& a, const Vector<2, T>& b)
+		constexpr Matrix<2, 2, T>(const Vector<2, T>& a, const Vector<2, T>& b)
 		{
 			data[0][0] = a.x; data[0][1] = a.y;
 			data[1][0] = b.x; data[1][1] = b.y;
 		}
-		Matrix<2, 2, T>(const Matrix<2, 2, T>& m)
+		constexpr Matrix<2, 2, T>(const Matrix<2, 2, T>& m)
 		{
 			data[0][0] = m.data[0][0]; data[0][1] = m.data[0][1];
 			data[1][0] = m.data[1][0]; data[1][1] = m.data[1][1];
 		}
-		Matrix<2, 2, T>(Matrix<2, 2, T>&& m) noexcept
+		constexpr Matrix<2, 2, T>(Matrix<2, 2, T>&& m) noexcept
 		{
 			data[0][0] = std::move(m.data[0][0]); data[0][1] = std::move(m.data[0][1]);
 			data[1][0] = std::move(m.data[1][0]); data[1][1] = std::move(m.data[1][1]);
@@ -50,14 +50,14 @@ namespace Elite
 
 		//=== Arithmetic Operators ===
 #pragma region ArithmeticOperators
-		inline Matrix<2, 2, T> operator+(const Matrix<2, 2, T>& m) const
+		constexpr Matrix<2, 2, T> operator+(const Matrix<2, 2, T>& m) const
 		{ 
 			return Matrix<2, 2, T>(
 				data[0][0] + m.data[0][0], data[1][0] + m.data[1][0],
 				data[0][1] + m.data[0][1], data[1][1] + m.data[1][1]);
 		}
 
-		inline Matrix<2, 2, T> operator-(const Matrix<2, 2, T>& m) const
+		constexpr Matrix<2, 2, T> operator-(const Matrix<2, 2, T>& m) const
 		{ 
 			return Matrix<2, 2, T>(
 				data[0][0] - m.data[0][0], data[1][0] - m.data[1][0],
@@ -65,7 +65,7 @@ namespace Elite
 		}
 
 		template<typename U>
-		inline Matrix<2, 2, T> operator*(U scale) const
+		constexpr Matrix<2, 2, T> operator*(U scale) const
 		{
 			const T s = static_cast<T>(scale);
 			return Matrix<2, 2, T>(
@@ -74,7 +74,7 @@ namespace Elite
 		}
 
 		template<typename U>
-		inline Matrix<2, 2, T> operator/(U scale) const
+		constexpr Matrix<2, 2, T> operator/(U scale) const
 		{
 			const T revS = static_cast<T>(1.0f / scale);
 			return Matrix<2, 2, T>(
@@ -82,7 +82,7 @@ namespace Elite
 				data[0][1] * revS, data[1][1] * revS);
 		}
 
-		inline Matrix<2, 2, T> operator*(const Matrix<2, 2, T>& rm)
+		constexpr Matrix<2, 2, T> operator*(const Matrix<2, 2, T>& rm)
 		{
 			const Matrix<2, 2, T>& lm = (*this);
 			return Matrix<2, 2, T>(
@@ -93,7 +93,7 @@ namespace Elite
 				lm(1, 0) * rm(0, 1) + lm(1, 1) * rm(1, 1));
 		}
 
-		inline Vector<2, T> operator*(const Vector<2, T>& v)
+		constexpr Vector<2, T> operator*(const Vector<2, T>& v)
 		{
 			const Matrix<2, 2, T>& m = (*this);
 			return Vector<2, T>(
@@ -104,21 +104,21 @@ namespace Elite
 
 		//=== Compound Assignment Operators ===
 #pragma region CompoundAssignmentOperators
-		inline Matrix<2, 2, T>& operator=(const Matrix<2, 2, T>& m)
+		constexpr Matrix<2, 2, T>& operator=(const Matrix<2, 2, T>& m)
 		{ 
 			data[0][0] = m.data[0][0]; data[0][1] = m.data[0][1];
 			data[1][0] = m.data[1][0]; data[1][1] = m.data[1][1];
 			return *this; 
 		}
 
-		inline Matrix<2, 2, T>& operator+=(const Matrix<2, 2, T>& m)
+		constexpr Matrix<2, 2, T>& operator+=(const Matrix<2, 2, T>& m)
 		{ 
 			data[0][0] += m.data[0][0]; data[0][1] += m.data[0][1];
 			data[1][0] += m.data[1][0]; data[1][1] += m.data[1][1];
 			return *this; 
 		}
 
-		inline Matrix<2, 2, T>& operator-=(const Matrix<2, 2, T>& m)
+		constexpr Matrix<2, 2, T>& operator-=(const Matrix<2, 2, T>& m)
 		{ 
 			data[0][0] -= m.data[0][0]; data[0][1] -= m.data[0][1];
 			data[1][0] -= m.data[1][0]; data[1][1] -= m.data[1][1];
@@ -126,7 +126,7 @@ namespace Elite
 		}
 
 		template<typename U>
-		inline Matrix<2, 2, T>& operator*=(U scale)
+		constexpr Matrix<2, 2, T>& operator*=(U scale)
 		{
 			const T s = static_cast<T>(scale);
 			data[0][0] *= s; data[0][1] *= s;
@@ -135,7 +135,7 @@ namespace Elite
 		}
 
 		template<typename U>
-		inline Matrix<2, 2, T>& operator/=(U scale)
+		constexpr Matrix<2, 2, T>& operator/=(U scale)
 		{
 			const T revS = static_cast<T>(1.0f / scale);
 			data[0][0] *= revS; data[0][1] *= revS;
@@ -143,7 +143,7 @@ namespace Elite
 			return *this;
 		}
 
-		inline Matrix<2, 2, T>& operator*=(const Matrix<2, 2, T>& m)
+		constexpr Matrix<2, 2, T>& operator*=(const Matrix<2, 2, T>& m)
 		{
 			//Copy is necessary! :( 
 			*this = *this * m;
@@ -163,13 +163,13 @@ namespace Elite
 		//=== Member Access Operators ===
 #pragma region MemberAccessOperators
 		//Access parameter order still happens as row,column indexing (standard in programming)
-		inline T operator()(uint8_t r, uint8_t c) const
+		constexpr T operator()(uint8_t r, uint8_t c) const
 		{
 			assert((r < 2 && c < 2) && "ERROR: indices of Matrix2x2 () const operator are out of bounds!");
 			return (data[c][r]);
 		}
 
-		inline T& operator()(uint8_t r, uint8_t c)
+		constexpr T& operator()(uint8_t r, uint8_t c)
 		{
 			assert((r < 2 && c < 2) && "ERROR: indices of Matrix2x2 () operator are out of bounds!");
 			return (data[c][r]);
@@ -190,7 +190,7 @@ namespace Elite
 #pragma endregion
 
 		//=== Static Functions ===
-		static Matrix<2, 2, T> Identity();
+		static constexpr Matrix<2, 2, T> Identity();
 	};
 
 	//--- VECMATRIX3 FUNCTIONS ---
@@ -199,7 +199,7 @@ namespace Elite
 
 #pragma region GlobalFunctions
 	template<typename T>
-	inline Matrix<2, 2, T> Matrix<2, 2, T>::Identity()
+	constexpr Matrix<2, 2, T> Matrix<2, 2, T>::Identity()
 	{
 		return Matrix<2, 2, T>(
 			1,0,
@@ -207,7 +207,7 @@ namespace Elite
 	}
 
 	template<typename T>
-	inline Matrix<2, 2, T> Transpose(const Matrix<2, 2, T>& m)
+	constexpr Matrix<2, 2, T> Transpose(const Matrix<2, 2, T>& m)
 	{
 		Matrix<2, 2, T> t = {};
 		t(0, 0) = m(0, 0);
@@ -218,7 +218,7 @@ namespace Elite
 	}
 
 	template<typename T>
-	inline T Determinant(const Matrix<2, 2, T>& m)
+	constexpr T Determinant(const Matrix<2, 2, T>& m)
 	{ return m(0, 0) * m(1, 1) - m(0, 1) * m(1, 0); }
 
 	template<typename T>
@@ -236,10 +236,10 @@ namespace Elite
 	//Rotations with a positive angle are considered a counterclockwise rotations around the axis pointing towards
 	//the viewer.
 	template<typename T>
-	inline Matrix<2, 2, T> MakeRotation(T t)
+	constexpr Matrix<2, 2, T> MakeRotation(T t)
 	{
-		T c = static_cast<T>(cos(t));
-		T s = static_cast<T>(sin(t));
+		T c = Cos(t);
+		T s = Sin(t);
 
 		return Matrix<2, 2, T>(
 			c, -s,
@@ -247,7 +247,7 @@ namespace Elite
 	}
 
 	template<typename T>
-	inline Matrix<2, 2, T> MakeScale(T x, T y)
+	constexpr Matrix<2, 2, T> MakeScale(T x, T y)
 	{
 		return Matrix<2, 2, T>(
 			x, static_cast<T>(0),
@@ -24,7 +24,7 @@ namespace Elite
 #pragma region Constructors
 		Matrix<3, 3, T>() = default;
 		//Every "row" of values passed here is a row in our matrix!
-		Matrix<3, 3, T>(T _00, T _01, T _02,
+		constexpr Matrix<3, 3, T>(T _00, T _01, T _02,
 						T _10, T _11, T _12,
 						T _20, T _21, T _22)
 		{
@@ -33,37 +33,37 @@ namespace Elite
 			data[2][0] = _02; data[2][1] = _12; data[2][2] = _22;
 		}
 		//Every vector passed here is a column in our matrix!
-		Matrix<3, 3, T>(const Vector<3, T>& a, const Vector<3, T>& b, const Vector<3, T>& c)
+		constexpr Matrix<3, 3, T>(const Vector<3, T>& a, const Vector<3, T>& b, const Vector<3, T>& c)
 		{
 			data[0][0] = a.x; data[0][1] = a.y; data[0][2] = a.z;
 			data[1][0] = b.x; data[1][1] = b.y; data[1][2] = b.z;
 			data[2][0] = c.x; data[2][1] = c.y; data[2][2] = c.z;
 		}
-		Matrix<3, 3, T>(const Matrix<2, 2, T>& m)
+		constexpr Matrix<3, 3, T>(const Matrix<2, 2, T>& m)
 		{
 			data[0][0] = m.data[0][0]; data[0][1] = m.data[0][1]; data[0][2] = 0;
 			data[1][0] = m.data[1][0]; data[1][1] = m.data[1][1]; data[1][2] = 0;
 			data[2][0] = 0; data[2][1] = 0; data[2][2] = 1;
 		}
-		Matrix<3, 3, T>(const Matrix<3, 3, T>& m)
+		constexpr Matrix<3, 3, T>(const Matrix<3, 3, T>& m)
 		{
 			data[0][0] = m.data[0][0]; data[0][1] = m.data[0][1]; data[0][2] = m.data[0][2];
 			data[1][0] = m.data[1][0]; data[1][1] = m.data[1][1]; data[1][2] = m.data[1][2];
 			data[2][0] = m.data[2][0]; data[2][1] = m.data[2][1]; data[2][2] = m.data[2][2];
 		}
-		Matrix<3, 3, T>(const Matrix<4, 4, T>& m)
+		constexpr Matrix<3, 3, T>(const Matrix<4, 4, T>& m)
 		{
 			data[0][0] = m.data[0][0]; data[0][1] = m.data[0][1]; data[0][2] = m.data[0][2];
 			data[1][0] = m.data[1][0]; data[1][1] = m.data[1][1]; data[1][2] = m.data[1][2];
 			data[2][0] = m.data[2][0]; data[2][1] = m.data[2][1]; data[2][2] = m.data[2][2];
 		}
-		Matrix<3, 3, T>(Matrix<3, 3, T>&& m) noexcept
+		constexpr Matrix<3, 3, T>(Matrix<3, 3, T>&& m) noexcept
 		{
 			data[0][0] = std::move(m.data[0][0]); data[0][1] = std::move(m.data[0][1]); data[0][2] = std::move(m.data[0][2]);
 			data[1][0] = std::move(m.data[1][0]); data[1][1] = std::move(m.data[1][1]); data[1][2] = std::move(m.data[1][2]);
 			data[2][0] = std::move(m.data[2][0]); data[2][1] = std::move(m.data[2][1]); data[2][2] = std::move(m.data[2][2]);
 		}
-		Matrix<3, 3, T>(Matrix<4, 4, T>&& m) noexcept
+		constexpr Matrix<3, 3, T>(Matrix<4, 4, T>&& m) noexcept
 		{
 			data[0][0] = std::move(m.data[0][0]); data[0][1] = std::move(m.data[0][1]); data[0][2] = std::move(m.data[0][2]);
 			data[1][0] = std::move(m.data[1][0]); data[1][1] = std::move(m.data[1][1]); data[1][2] = std::move(m.data[1][2]);
@@ -73,7 +73,7 @@ namespace Elite
 
 		//=== Arithmetic Operators ===
 #pragma region ArithmeticOperators
-		inline Matrix<3, 3, T> operator+(const Matrix<3, 3, T>& m) const
+		constexpr Matrix<3, 3, T> operator+(const Matrix<3, 3, T>& m) const
 		{ 
 			return Matrix<3, 3, T>(
 				data[0][0] + m.data[0][0], data[1][0] + m.data[1][0], data[2][0] + m.data[2][0],
@@ -81,7 +81,7 @@ namespace Elite
 				data[0][2] + m.data[0][2], data[1][2] + m.data[1][2], data[2][2] + m.data[2][2]);
 		}
 
-		inline Matrix<3, 3, T> operator-(const Matrix<3, 3, T>& m) const
+		constexpr Matrix<3, 3, T> operator-(const Matrix<3, 3, T>& m) const
 		{ 
 			return Matrix<3, 3, T>(
 				data[0][0] - m.data[0][0], data[1][0] - m.data[1][0], data[2][0] - m.data[2][0],
@@ -90,7 +90,7 @@ namespace Elite
 		}
 
 		template<typename U>
-		inline Matrix<3, 3, T> operator*(U scale) const
+		constexpr Matrix<3, 3, T> operator*(U scale) const
 		{
 			const T s = static_cast<T>(scale);
 			return Matrix<3, 3, T>(
@@ -100,7 +100,7 @@ namespace Elite
 		}
 
 		template<typename U>
-		inline Matrix<3, 3, T> operator/(U scale) const
+		constexpr Matrix<3, 3, T> operator/(U scale) const
 		{
 			const T revS = static_cast<T>(1.0f / scale);
 			return Matrix<3, 3, T>(
@@ -109,7 +109,7 @@ namespace Elite
 				data[0][2] * revS, data[1][2] * revS, data[2][2] * revS);
 		}
 
-		inline Matrix<3, 3, T> operator*(const Matrix<3, 3, T>& rm)
+		constexpr Matrix<3, 3, T> operator*(const Matrix<3, 3, T>& rm)
 		{
 			const Matrix<3, 3, T>& lm = (*this);
 			return Matrix<3, 3, T>(
@@ -126,7 +126,7 @@ namespace Elite
 				lm(2, 0) * rm(0, 2) + lm(2, 1) * rm(1, 2) + lm(2, 2) * rm(2, 2));
 		}
 
-		inline Vector<3, T> operator*(const Vector<3, T>& v)
+		constexpr Vector<3, T> operator*(const Vector<3, T>& v)
 		{
 			const Matrix<3, 3, T>& m = (*this);
 			return Vector<3, T>(
@@ -135,7 +135,7 @@ namespace Elite
 				m(2, 0) * v.x + m(2, 1) * v.y + m(2, 2) * v.z);
 		}
 
-		inline Point<3, T> operator*(const Point<3, T>& p)
+		constexpr Point<3, T> operator*(const Point<3, T>& p)
 		{
 			const Matrix<3, 3, T>& m = (*this);
 			return Point<3, T>(
@@ -147,7 +147,7 @@ namespace Elite
 
 		//=== Compound Assignment Operators ===
 #pragma region CompoundAssignmentOperators
-		inline Matrix<3, 3, T>& operator=(const Matrix<3, 3, T>& m)
+		constexpr Matrix<3, 3, T>& operator=(const Matrix<3, 3, T>& m)
 		{ 
 			data[0][0] = m.data[0][0]; data[0][1] = m.data[0][1]; data[0][2] = m.data[0][2];
 			data[1][0] = m.data[1][0]; data[1][1] = m.data[1][1]; data[1][2] = m.data[1][2];
@@ -155,7 +155,7 @@ namespace Elite
 			return *this; 
 		}
 
-		inline Matrix<3, 3, T>& operator+=(const Matrix<3, 3, T>& m)
+		constexpr Matrix<3, 3, T>& operator+=(const Matrix<3, 3, T>& m)
 		{ 
 			data[0][0] += m.data[0][0]; data[0][1] += m.data[0][1]; data[0][2] += m.data[0][2];
 			data[1][0] += m.data[1][0]; data[1][1] += m.data[1][1]; data[1][2] += m.data[1][2];
@@ -163,7 +163,7 @@ namespace Elite
 			return *this; 
 		}
 
-		inline Matrix<3, 3, T>& operator-=(const Matrix<3, 3, T>& m)
+		constexpr Matrix<3, 3, T>& operator-=(const Matrix<3, 3, T>& m)
 		{ 
 			data[0][0] -= m.data[0][0]; data[0][1] -= m.data[0][1]; data[0][2] -= m.data[0][2];
 			data[1][0] -= m.data[1][0]; data[1][1] -= m.data[1][1]; data[1][2] -= m.data[1][2];
@@ -172,7 +172,7 @@ namespace Elite
 		}
 
 		template<typename U>
-		inline Matrix<3, 3, T>& operator*=(U scale)
+		constexpr Matrix<3, 3, T>& operator*=(U scale)
 		{
 			const T s = static_cast<T>(scale);
 			data[0][0] *= s; data[0][1] *= s; data[0][2] *= s;
@@ -182,7 +182,7 @@ namespace Elite
 		}
 
 		template<typename U>
-		inline Matrix<3, 3, T>& operator/=(U scale)
+		constexpr Matrix<3, 3, T>& operator/=(U scale)
 		{
 			const T revS = static_cast<T>(1.0f / scale);
 			data[0][0] *= revS; data[0][1] *= revS; data[0][2] *= revS;
@@ -191,7 +191,7 @@ namespace Elite
 			return *this;
 		}
 
-		inline Matrix<3, 3, T>& operator*=(const Matrix<3, 3, T>& m)
+		constexpr Matrix<3, 3, T>& operator*=(const Matrix<3, 3, T>& m)
 		{
 			//Copy is necessary! :( 
 			*this = *this * m;
@@ -211,13 +211,13 @@ namespace Elite
 		//=== Member Access Operators ===
 #pragma region MemberAccessOperators
 		//Access parameter order still happens as row,column indexing (standard in programming)
-		inline T operator()(uint8_t r, uint8_t c) const
+		constexpr T operator()(uint8_t r, uint8_t c) const
 		{
 			assert((r < 3 && c < 3) && "ERROR: indices of Matrix3x3 () const operator are out of bounds!");
 			return (data[c][r]);
 		}
 
-		inline T& operator()(uint8_t r, uint8_t c)
+		constexpr T& operator()(uint8_t r, uint8_t c)
 		{
 			assert((r < 3 && c < 3) && "ERROR: indices of Matrix3x3 () operator are out of bounds!");
 			return (data[c][r]);
@@ -238,7 +238,7 @@ namespace Elite
 #pragma endregion
 
 		//=== Static Functions ===
-		static Matrix<3, 3, T> Identity();
+		static constexpr Matrix<3, 3, T> Identity();
 	};
 
 	//--- VECMATRIX3 FUNCTIONS ---
@@ -247,7 +247,7 @@ namespace Elite
 
 #pragma region GlobalFunctions
 	template<typename T>
-	inline Matrix<3, 3, T> Matrix<3, 3, T>::Identity()
+	constexpr Matrix<3, 3, T> Matrix<3, 3, T>::Identity()
 	{
 		return Matrix<3, 3, T>(
 			1,0,0,
@@ -256,7 +256,7 @@ namespace Elite
 	}
 
 	template<typename T>
-	inline Matrix<3, 3, T> Transpose(const Matrix<3, 3, T>& m)
+	constexpr Matrix<3, 3, T> Transpose(const Matrix<3, 3, T>& m)
 	{
 		Matrix<3, 3, T> t = {};
 		t(0, 0) = m(0, 0);
@@ -272,7 +272,7 @@ namespace Elite
 	}
 
 	template<typename T>
-	inline T Determinant(const Matrix<3, 3, T>& m)
+	constexpr T Determinant(const Matrix<3, 3, T>& m)
 	{
 		return 
 			+ m(0, 0) * (m(1, 1) * m(2, 2) - m(1, 2) * m(2, 1))
@@ -321,10 +321,10 @@ namespace Elite
 	//Rotations with a positive angle are considered a counterclockwise rotations around the axis pointing towards
 	//the viewer. Think of the axis as the "normal" of the planes (x -> yz-plane, y -> xz-plane , z -> xy-plane)!
 	template<typename T>
-	inline Matrix<3, 3, T> MakeRotationX(T t)
+	constexpr Matrix<3, 3, T> MakeRotationX(T t)
 	{
-		T c = static_cast<T>(cos(t));
-		T s = static_cast<T>(sin(t));
+		T c = Cos(t);
+		T s = Sin(t);
 
 		return Matrix<3, 3, T>(
 			static_cast<T>(1), static_cast<T>(0), static_cast<T>(0),
@@ -333,10 +333,10 @@ namespace Elite
 	}
 
 	template<typename T>
-	inline Matrix<3, 3, T> MakeRotationY(T t)
+	constexpr Matrix<3, 3, T> MakeRotationY(T t)
 	{
-		T c = static_cast<T>(cos(t));
-		T s = static_cast<T>(sin(t));
+		T c = Cos(t);
+		T s = Sin(t);
 
 		return Matrix<3, 3, T>(
 			c, static_cast<T>(0), s,
@@ -345,10 +345,10 @@ namespace Elite
 	}
 
 	template<typename T>
-	inline Matrix<3, 3, T> MakeRotationZ(T t)
+	constexpr Matrix<3, 3, T> MakeRotationZ(T t)
 	{
-		T c = static_cast<T>(cos(t));
-		T s = static_cast<T>(sin(t));
+		T c = Cos(t);
+		T s = Sin(t);
 
 		return Matrix<3, 3, T>(
 			c, -s, static_cast<T>(0),
@@ -357,7 +357,7 @@ namespace Elite
 	}
 
 	template<typename T>
-	inline Matrix<3, 3, T> MakeRotationZYX(T x, T y, T z)
+	constexpr Matrix<3, 3, T> MakeRotationZYX(T x, T y, T z)
 	{
 		Matrix<3, 3, T> mX = MakeRotationX(x);
 		Matrix<3, 3, T> mY = MakeRotationY(y);
@@ -366,10 +366,10 @@ namespace Elite
 	}
 
 	template<typename T>
-	inline Matrix<3, 3, T> MakeRotation(T t, const Vector<3, T>& axis)
+	constexpr Matrix<3, 3, T> MakeRotation(T t, const Vector<3, T>& axis)
 	{
-		T c = static_cast<T>(cos(t));
-		T s = static_cast<T>(sin(t));
+		T c = Cos(t);
+		T s = Sin(t);
 		T oneMinusC = static_cast<T>(1 - c);
 
 		T xy = axis.x * axis.y;
@@ -386,7 +386,7 @@ namespace Elite
 	}
 
 	template<typename T>
-	inline Matrix<3, 3, T> MakeScale(T x, T y, T z)
+	constexpr Matrix<3, 3, T> MakeScale(T x, T y, T z)
 	{
 		return Matrix<3, 3, T>(
 			x, static_cast<T>(0), static_cast<T>(0),
@@ -395,7 +395,7 @@ namespace Elite
 	}
 
 	template<typename T>
-	inline Matrix<3, 3, T> MakeScale(T s, const Vector<3, T>& axis)
+	constexpr Matrix<3, 3, T> MakeScale(T s, const Vector<3, T>& axis)
 	{
 		T sMinusOne = s - static_cast<T>(1);
 		T xy = axis.x * axis.y;
@@ -409,7 +409,7 @@ namespace Elite
 	}
 
 	template<typename T>
-	inline Matrix<3, 3, T> MakeTranslation(const Vector<2, T>& v)
+	constexpr Matrix<3, 3, T> MakeTranslation(const Vector<2, T>& v)
 	{
 		return Matrix<3, 3, T>(
 			1, 0, v.x,
@@ -420,7 +420,7 @@ namespace Elite
 	//Can be used to change from right-handed coordinate system (the "assumption" of these rotation matrices is
 	//a right-handed system) to a left-handed coordinate system.
 	template<typename T>
-	inline Matrix<3, 3, T> MakeReflection(const Vector<3, T>& axis)
+	constexpr Matrix<3, 3, T> MakeReflection(const Vector<3, T>& axis)
 	{
 		T xy = axis.x * axis.y;
 		T yz = axis.y * axis.z;
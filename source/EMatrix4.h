@@ -14,8 +14,9 @@
 namespace Elite
 {
 	//=== MATRIX4x4 SPECIALIZATION ===
+	//Aligned so every column loads straight into an SSE register (see EMathSIMD.h)
 	template<typename T>
-	struct Matrix<4, 4, T>
+	struct alignas(16) Matrix<4, 4, T>
 	{		
 		//=== Data ===
 		T data[4][4];
@@ -24,7 +25,7 @@ namespace Elite
 #pragma region Constructors
 		Matrix<4, 4, T>() = default;
 		//Every "row" of values passed here is a row in our matrix!
-		Matrix<4, 4, T>(T _00, T _01, T _02, T _03,
+		constexpr Matrix<4, 4, T>(T _00, T _01, T _02, T _03,
 			T _10, T _11, T _12, T _13,
 			T _20, T _21, T _22, T _23,
 			T _30, T _31, T _32, T _33)
@@ -35,35 +36,35 @@ namespace Elite
 			data[3][0] = _03; data[3][1] = _13; data[3][2] = _23; data[3][3] = _33;
 		}
 		//Every vector passed here is a column in our matrix!
-		Matrix<4, 4, T>(const Vector<4, T> & a, const Vector<4, T> & b, const Vector<4, T> & c, const Vector<4, T> & d)
+		constexpr Matrix<4, 4, T>(const Vector<4, T> & a, const Vector<4, T> & b, const Vector<4, T> & c, const Vector<4, T> & d)
 		{
 			data[0][0] = a.x; data[0][1] = a.y; data[0][2] = a.z; data[0][3] = a.w;
 			data[1][0] = b.x; data[1][1] = b.y; data[1][2] = b.z; data[1][3] = b.w;
 			data[2][0] = c.x; data[2][1] = c.y; data[2][2] = c.z; data[2][3] = c.w;
 			data[3][0] = d.x; data[3][1] = d.y; data[3][2] = d.z; data[3][3] = d.w;
 		}
-		Matrix<4, 4, T>(const Matrix<3, 3, T> & m, const Vector<3, T> & t)
+		constexpr Matrix<4, 4, T>(const Matrix<3, 3, T> & m, const Vector<3, T> & t)
 		{
 			data[0][0] = m.data[0][0]; data[0][1] = m.data[0][1]; data[0][2] = m.data[0][2]; data[0][3] = 0;
 			data[1][0] = m.data[1][0]; data[1][1] = m.data[1][1]; data[1][2] = m.data[1][2]; data[1][3] = 0;
 			data[2][0] = m.data[2][0]; data[2][1] = m.data[2][1]; data[2][2] = m.data[2][2]; data[2][3] = 0;
 			data[3][0] = t.x; data[3][1] = t.y; data[3][2] = t.z; data[3][3] = 1;
 		}
-		Matrix<4, 4, T>(const Matrix<3, 3, T> & m)
+		constexpr Matrix<4, 4, T>(const Matrix<3, 3, T> & m)
 		{
 			data[0][0] = m.data[0][0]; data[0][1] = m.data[0][1]; data[0][2] = m.data[0][2]; data[0][3] = 0;
 			data[1][0] = m.data[1][0]; data[1][1] = m.data[1][1]; data[1][2] = m.data[1][2]; data[1][3] = 0;
 			data[2][0] = m.data[2][0]; data[2][1] = m.data[2][1]; data[2][2] = m.data[2][2]; data[2][3] = 0;
 			data[3][0] = 0; data[3][1] = 0; data[3][2] = 0; data[3][3] = 1;
 		}
-		Matrix<4, 4, T>(const Matrix<4, 4, T> & m)
+		constexpr Matrix<4, 4, T>(const Matrix<4, 4, T> & m)
 		{
 			data[0][0] = m.data[0][0]; data[0][1] = m.data[0][1]; data[0][2] = m.data[0][2]; data[0][3] = m.data[0][3];
 			data[1][0] = m.data[1][0]; data[1][1] = m.data[1][1]; data[1][2] = m.data[1][2]; data[1][3] = m.data[1][3];
 			data[2][0] = m.data[2][0]; data[2][1] = m.data[2][1]; data[2][2] = m.data[2][2]; data[2][3] = m.data[2][3];
 			data[3][0] = m.data[3][0]; data[3][1] = m.data[3][1]; data[3][2] = m.data[3][2]; data[3][3] = m.data[3][3];
 		}
-		Matrix<4, 4, T>(Matrix<4, 4, T> && m) noexcept
+		constexpr Matrix<4, 4, T>(Matrix<4, 4, T> && m) noexcept
 		{
 			data[0][0] = std::move(m.data[0][0]); data[0][1] = std::move(m.data[0][1]);
 			data[0][2] = std::move(m.data[0][2]); data[0][3] = std::move(m.data[0][3]);
@@ -81,7 +82,7 @@ namespace Elite
 
 		//=== Arithmetic Operators ===
 #pragma region ArithmeticOperators
-		inline Matrix<4, 4, T> operator+(const Matrix<4, 4, T>& m) const
+		constexpr Matrix<4, 4, T> operator+(const Matrix<4, 4, T>& m) const
 		{ 
 			return Matrix<4, 4, T>(
 				data[0][0] + m.data[0][0], data[1][0] + m.data[1][0], data[2][0] + m.data[2][0], data[3][0] + m.data[3][0],
@@ -90,7 +91,7 @@ namespace Elite
 				data[0][3] + m.data[0][3], data[1][3] + m.data[1][3], data[2][3] + m.data[2][3], data[3][3] + m.data[3][3]);
 		}
 
-		inline Matrix<4, 4, T> operator-(const Matrix<4, 4, T>& m) const
+		constexpr Matrix<4, 4, T> operator-(const Matrix<4, 4, T>& m) const
 		{ 
 			return Matrix<4, 4, T>(
 				data[0][0] - m.data[0][0], data[1][0] - m.data[1][0], data[2][0] - m.data[2][0], data[3][0] - m.data[3][0],
@@ -100,7 +101,7 @@ namespace Elite
 		}
 
 		template<typename U>
-		inline Matrix<4, 4, T> operator*(U scale) const
+		constexpr Matrix<4, 4, T> operator*(U scale) const
 		{
 			const T s = static_cast<T>(scale);
 			return Matrix<4, 4, T>(
@@ -111,7 +112,7 @@ namespace Elite
 		}
 
 		template<typename U>
-		inline Matrix<4, 4, T> operator/(U scale) const
+		constexpr Matrix<4, 4, T> operator/(U scale) const
 		{
 			const T revS = static_cast<T>(1.0f / scale);
 			return Matrix<4, 4, T>(
@@ -121,7 +122,7 @@ namespace Elite
 				data[0][3] * revS, data[1][3] * revS, data[2][3] * revS, data[3][3] * revS);
 		}
 
-		inline Matrix<4, 4, T> operator*(const Matrix<4, 4, T>& rm) const
+		constexpr Matrix<4, 4, T> operator*(const Matrix<4, 4, T>& rm) const
 		{
 			const Matrix<4, 4, T>& lm = (*this);
 			return Matrix<4, 4, T>(
@@ -149,7 +150,7 @@ namespace Elite
 		//Reminder: when transforming normals (like vectors, so no translation), you have to multiply with
 		//the transpose of the inverse of the original matrix, because they do not behave in the same way!
 		//So vector transformation -> M * v , while normal transformation with same matrix -> inv(transp(M)) * n
-		inline Vector<4, T> operator*(const Vector<4, T>& v)
+		constexpr Vector<4, T> operator*(const Vector<4, T>& v)
 		{
 			const Matrix<4, 4, T>& m = (*this);
 			return Vector<4, T>(
@@ -159,7 +160,7 @@ namespace Elite
 		}
 
 		//Takes into account translation for a point.
-		inline Point<4, T> operator*(const Point<4, T>& p)
+		constexpr Point<4, T> operator*(const Point<4, T>& p)
 		{
 			const Matrix<4, 4, T>& m = (*this);
 			return Point<4, T>(
@@ -172,7 +173,7 @@ namespace Elite
 
 		//=== Compound Assignment Operators ===
 #pragma region CompoundAssignmentOperators
-		inline Matrix<4, 4, T>& operator=(const Matrix<4, 4, T>& m)
+		constexpr Matrix<4, 4, T>& operator=(const Matrix<4, 4, T>& m)
 		{ 
 			data[0][0] = m.data[0][0]; data[0][1] = m.data[0][1]; data[0][2] = m.data[0][2]; data[0][3] = m.data[0][3];
 			data[1][0] = m.data[1][0]; data[1][1] = m.data[1][1]; data[1][2] = m.data[1][2]; data[1][3] = m.data[1][3];
@@ -181,7 +182,7 @@ namespace Elite
 			return *this; 
 		}
 
-		inline Matrix<4, 4, T>& operator+=(const Matrix<4, 4, T>& m)
+		constexpr Matrix<4, 4, T>& operator+=(const Matrix<4, 4, T>& m)
 		{ 
 			data[0][0] += m.data[0][0]; data[0][1] += m.data[0][1]; data[0][2] += m.data[0][2]; data[0][3] += m.data[0][3];
 			data[1][0] += m.data[1][0]; data[1][1] += m.data[1][1]; data[1][2] += m.data[1][2]; data[1][3] += m.data[1][3];
@@ -190,7 +191,7 @@ namespace Elite
 			return *this; 
 		}
 
-		inline Matrix<4, 4, T>& operator-=(const Matrix<4, 4, T>& m)
+		constexpr Matrix<4, 4, T>& operator-=(const Matrix<4, 4, T>& m)
 		{ 
 			data[0][0] -= m.data[0][0]; data[0][1] -= m.data[0][1]; data[0][2] -= m.data[0][2]; data[0][3] -= m.data[0][3];
 			data[1][0] -= m.data[1][0]; data[1][1] -= m.data[1][1]; data[1][2] -= m.data[1][2]; data[1][3] -= m.data[1][3];
@@ -200,7 +201,7 @@ namespace Elite
 		}
 
 		template<typename U>
-		inline Matrix<4, 4, T>& operator*=(U scale)
+		constexpr Matrix<4, 4, T>& operator*=(U scale)
 		{
 			const T s = static_cast<T>(scale);
 			data[0][0] *= s; data[0][1] *= s; data[0][2] *= s; data[0][3] *= s;
@@ -211,7 +212,7 @@ namespace Elite
 		}
 
 		template<typename U>
-		inline Matrix<4, 4, T>& operator/=(U scale)
+		constexpr Matrix<4, 4, T>& operator/=(U scale)
 		{
 			const T revS = static_cast<T>(1.0f / scale);
 			data[0][0] *= revS; data[0][1] *= revS; data[0][2] *= revS;	data[0][3] *= revS;
@@ -221,7 +222,7 @@ namespace Elite
 			return *this;
 		}
 
-		inline Matrix<4, 4, T>& operator*=(const Matrix<4, 4, T>& m)
+		constexpr Matrix<4, 4, T>& operator*=(const Matrix<4, 4, T>& m)
 		{
 			//Copy is necessary! :( 
 			*this = *this * m;
@@ -241,13 +242,13 @@ namespace Elite
 		//=== Member Access Operators ===
 #pragma region MemberAccessOperators
 		//Access parameter order still happens as row,column indexing (standard in programming)
-		inline T operator()(uint8_t r, uint8_t c) const
+		constexpr T operator()(uint8_t r, uint8_t c) const
 		{
 			assert((r < 4 && c < 4) && "ERROR: indices of Matrix4x4 () const operator are out of bounds!");
 			return (data[c][r]);
 		}
 
-		inline T& operator()(uint8_t r, uint8_t c)
+		constexpr T& operator()(uint8_t r, uint8_t c)
 		{
 			assert((r < 4 && c < 4) && "ERROR: indices of Matrix4x4 () operator are out of bounds!");
 			return (data[c][r]);
@@ -268,7 +269,7 @@ namespace Elite
 #pragma endregion
 
 		//=== Static Functions ===
-		static Matrix<4, 4, T> Identity();
+		static constexpr Matrix<4, 4, T> Identity();
 	};
 
 	//--- VECMATRIX3 FUNCTIONS ---
@@ -277,7 +278,7 @@ namespace Elite
 
 #pragma region GlobalFunctions
 	template<typename T>
-	inline Matrix<4, 4, T> Matrix<4, 4, T>::Identity()
+	constexpr Matrix<4, 4, T> Matrix<4, 4, T>::Identity()
 	{
 		return Matrix<4, 4, T>(
 			1, 0, 0, 0,
@@ -287,7 +288,7 @@ namespace Elite
 	}
 
 	template<typename T>
-	inline Matrix<4, 4, T> Transpose(const Matrix<4, 4, T>& m)
+	constexpr Matrix<4, 4, T> Transpose(const Matrix<4, 4, T>& m)
 	{
 		Matrix<4, 4, T> t = {};
 		t(0, 0) = m(0, 0);
@@ -310,7 +311,7 @@ namespace Elite
 	}
 
 	template<typename T>
-	inline T Determinant(const Matrix<4, 4, T>& m)
+	constexpr T Determinant(const Matrix<4, 4, T>& m)
 	{
 		return
 			+ m(0, 0) * (
@@ -367,9 +368,51 @@ namespace Elite
 			r2.x, r2.y, r2.z, -Dot(d, s),
 			r3.x, r3.y, r3.z,  Dot(c, s));
 	}
+
+	//Inverse of a rigid transformation (orthonormal axes and a translation, no scale): the transposed rotation,
+	//with the translation rotated back. A fraction of the general inverse, but wrong for anything else!
+	template<typename T>
+	inline Matrix<4, 4, T> InverseRigid(const Matrix<4, 4, T>& m)
+	{
+		const Vector<3, T>& a = m[0].xyz;
+		const Vector<3, T>& b = m[1].xyz;
+		const Vector<3, T>& c = m[2].xyz;
+		const Vector<3, T>& d = m[3].xyz;
+
+		return Matrix<4, 4, T>(
+			a.x, a.y, a.z, -Dot(a, d),
+			b.x, b.y, b.z, -Dot(b, d),
+			c.x, c.y, c.z, -Dot(c, d),
+			0, 0, 0, 1);
+	}
 	
+	//Normalized planes of the [-1, 1] x [-1, 1] x [0, 1] clip volume (left, right, bottom, top, near, far), the inside is positive.
+	//Gribb and Hartmann: the clip space inequalities -w <= x <= w, -w <= y <= w and 0 <= z <= w written out per row.
+	//Passing a world view projection matrix gives the planes in the space of the mesh.
+	template<typename T>
+	inline void ExtractFrustumPlanes(const Matrix<4, 4, T>& m, Vector<4, T>* pPlanes)
+	{
+		Vector<4, T> rows[4];
+		for (uint8_t row = 0; row < 4; ++row)
+			rows[row] = Vector<4, T>(m.data[0][row], m.data[1][row], m.data[2][row], m.data[3][row]);
+
+		pPlanes[0] = rows[3] + rows[0];
+		pPlanes[1] = rows[3] - rows[0];
+		pPlanes[2] = rows[3] + rows[1];
+		pPlanes[3] = rows[3] - rows[1];
+		pPlanes[4] = rows[2];
+		pPlanes[5] = rows[3] - rows[2];
+
+		for (uint8_t i = 0; i < 6; ++i)
+		{
+			const T length = Magnitude(pPlanes[i].xyz);
+			if (length > 0)
+				pPlanes[i] = pPlanes[i] / length;
+		}
+	}
+
 	template<typename T>
-	inline Matrix<4, 4, T> MakeTranslation(const Vector<3, T>& v)
+	constexpr Matrix<4, 4, T> MakeTranslation(const Vector<3, T>& v)
 	{
 		return Matrix<4, 4, T>(
 			1, 0, 0, v.x,
@@ -0,0 +1,625 @@
+#include "pch.h"
+#include "EObjParser.h"
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string_view>
+#include "Hash.h"
+#include "MappedFile.h"
+#include "MeshTangents.h"
+#include "ThreadPool.h"
+
+using namespace Elite;
+
+namespace
+{
+	constexpr uint32_t g_InvalidIndex{ UINT32_MAX };
+	constexpr size_t g_BytesPerChunk{ 4 * 1024 * 1024 };
+
+	//0 based indices, g_InvalidIndex when the corner has no uv or normal
+	struct Corner
+	{
+		uint32_t position;
+		uint32_t uv;
+		uint32_t normal;
+	};
+
+	bool operator==(const Corner& a, const Corner& b)
+	{
+		return a.position == b.position && a.uv == b.uv && a.normal == b.normal;
+	}
+
+	struct CornerHash
+	{
+		size_t operator()(const Corner& corner) const
+		{
+			uint64_t hash{ corner.position * 0x9E3779B97F4A7C15ull };
+			hash ^= (corner.uv + 0x632BE59BD9B4E019ull) * 0xC2B2AE3D27D4EB4Full;
+			hash ^= (corner.normal + 0x165667B19E3779F9ull) * 0xD6E8FEB86659FD93ull;
+			return static_cast<size_t>(hash ^ (hash >> 32));
+		}
+	};
+
+	//Exact amount of every element in a chunk, counted before parsing so nothing grows by reallocation
+	struct ChunkCounts
+	{
+		size_t positions;
+		size_t UVs;
+		size_t normals;
+		size_t triangles;
+	};
+
+	//Where a chunk writes its elements. Attributes go straight into the final arrays at the chunk offset,
+	//corners are only kept for the chunks of the batch that is being welded.
+	struct ChunkOutput
+	{
+		FPoint4* pPositions;
+		FVector2* pUVs;
+		FVector3* pNormals;
+		std::vector<Corner> corners;
+		std::string error;
+	};
+
+	//Open addressing replacement for std::unordered_map<Corner, uint32_t>, one 16 byte slot per entry instead of a node
+	class CornerTable final
+	{
+	public:
+		explicit CornerTable(size_t expectedCount)
+		{
+			size_t capacity{ 16 };
+			while (capacity * 3 < expectedCount * 4)
+				capacity *= 2;
+			m_Slots.resize(capacity, Slot{ Corner{ g_InvalidIndex, g_InvalidIndex, g_InvalidIndex }, g_InvalidIndex });
+		}
+
+		//Returns the index stored for the corner, inserts newIndex when the corner is new
+		uint32_t FindOrInsert(const Corner& corner, uint32_t newIndex, bool& isInserted)
+		{
+			//Linear probing stays short up to a 3/4 load
+			if ((m_Count + 1) * 4 > m_Slots.size() * 3)
+				Grow();
+
+			Slot& slot{ FindSlot(corner) };
+			isInserted = slot.index == g_InvalidIndex;
+			if (isInserted)
+			{
+				slot = Slot{ corner, newIndex };
+				++m_Count;
+			}
+			return slot.index;
+		}
+
+	private:
+		struct Slot
+		{
+			Corner corner;
+			uint32_t index;
+		};
+
+		std::vector<Slot> m_Slots;
+		size_t m_Count{};
+
+		Slot& FindSlot(const Corner& corner)
+		{
+			const size_t mask{ m_Slots.size() - 1 };
+			size_t i{ CornerHash{}(corner) & mask };
+			while (m_Slots[i].index != g_InvalidIndex && !(m_Slots[i].corner == corner))
+				i = (i + 1) & mask;
+			return m_Slots[i];
+		}
+
+		void Grow()
+		{
+			std::vector<Slot> oldSlots(m_Slots.size() * 2, Slot{ Corner{ g_InvalidIndex, g_InvalidIndex, g_InvalidIndex }, g_InvalidIndex });
+			m_Slots.swap(oldSlots);
+			for (const Slot& slot : oldSlots)
+			{
+				if (slot.index != g_InvalidIndex)
+					FindSlot(slot.corner) = slot;
+			}
+		}
+	};
+
+	bool IsSpace(char c)
+	{
+		return c == ' ' || c == '\t' || c == '\r';
+	}
+
+	void SkipSpaces(const char*& pCurrent, const char* pEnd)
+	{
+		while (pCurrent < pEnd && IsSpace(*pCurrent))
+			++pCurrent;
+	}
+
+	bool ReadFloat(const char*& pCurrent, const char* pEnd, float& value)
+	{
+		SkipSpaces(pCurrent, pEnd);
+		//from_chars doesn't accept an explicit plus sign
+		if (pCurrent < pEnd && *pCurrent == '+')
+			++pCurrent;
+
+		const std::from_chars_result result{ std::from_chars(pCurrent, pEnd, value) };
+		if (result.ec != std::errc{})
+			return false;
+
+		pCurrent = result.ptr;
+		return true;
+	}
+
+	//Converts the 1 based OBJ index, relative (negative) indices aren't supported
+	bool ReadIndex(const char*& pCurrent, const char* pEnd, uint32_t& index)
+	{
+		int64_t value;
+		const std::from_chars_result result{ std::from_chars(pCurrent, pEnd, value) };
+		if (result.ec != std::errc{} || value <= 0 || value > UINT32_MAX)
+			return false;
+
+		pCurrent = result.ptr;
+		index = static_cast<uint32_t>(value - 1);
+		return true;
+	}
+
+	bool ReadCorner(const char*& pCurrent, const char* pEnd, Corner& corner)
+	{
+		corner = Corner{ g_InvalidIndex, g_InvalidIndex, g_InvalidIndex };
+
+		SkipSpaces(pCurrent, pEnd);
+		if (!ReadIndex(pCurrent, pEnd, corner.position))
+			return false;
+
+		if (pCurrent < pEnd && *pCurrent == '/')
+		{
+			++pCurrent;
+
+			// Optional texture coordinate
+			if (pCurrent < pEnd && *pCurrent != '/' && !ReadIndex(pCurrent, pEnd, corner.uv))
+				return false;
+
+			// Optional vertex normal
+			if (pCurrent < pEnd && *pCurrent == '/')
+			{
+				++pCurrent;
+				if (!ReadIndex(pCurrent, pEnd, corner.normal))
+					return false;
+			}
+		}
+		return true;
+	}
+
+	std::string_view ReadCommand(const char*& pCurrent, const char* pEnd)
+	{
+		SkipSpaces(pCurrent, pEnd);
+		const char* pCommand{ pCurrent };
+		while (pCurrent < pEnd && !IsSpace(*pCurrent))
+			++pCurrent;
+		return std::string_view{ pCommand, static_cast<size_t>(pCurrent - pCommand) };
+	}
+
+	//A face ends at a trailing comment, the other records stop after their last value and never see it
+	const char* FindCommentStart(const char* pCurrent, const char* pEnd)
+	{
+		return std::find(pCurrent, pEnd, '#');
+	}
+
+	//Calls function(pLineBegin, pLineEnd) for every line, stops at the first line it returns false for
+	template<typename Function>
+	bool ForEachLine(const char* pBegin, const char* pEnd, const Function& function)
+	{
+		const char* pLine{ pBegin };
+		while (pLine < pEnd)
+		{
+			const char* pLineEnd{ static_cast<const char*>(std::memchr(pLine, '\n', static_cast<size_t>(pEnd - pLine))) };
+			if (!pLineEnd)
+				pLineEnd = pEnd;
+
+			if (!function(pLine, pLineEnd))
+				return false;
+			pLine = pLineEnd + 1;
+		}
+		return true;
+	}
+
+	//Counts the elements without converting any number, faces count their space separated corners
+	void ScanChunk(const char* pBegin, const char* pEnd, ChunkCounts& counts)
+	{
+		counts = ChunkCounts{};
+		ForEachLine(pBegin, pEnd, [&counts](const char* pCurrent, const char* pLineEnd)
+			{
+				const std::string_view command{ ReadCommand(pCurrent, pLineEnd) };
+				if (command == "v")
+					++counts.positions;
+				else if (command == "vt")
+					++counts.UVs;
+				else if (command == "vn")
+					++counts.normals;
+				else if (command == "f")
+				{
+					pLineEnd = FindCommentStart(pCurrent, pLineEnd);
+					size_t cornerCount{};
+					while (pCurrent < pLineEnd)
+					{
+						SkipSpaces(pCurrent, pLineEnd);
+						if (pCurrent == pLineEnd)
+							break;
+						++cornerCount;
+						while (pCurrent < pLineEnd && !IsSpace(*pCurrent))
+							++pCurrent;
+					}
+					counts.triangles += cornerCount > 2 ? cornerCount - 2 : 0;
+				}
+				return true;
+			});
+	}
+
+	bool ParseLine(const char* pCurrent, const char* pEnd, ChunkOutput& chunk)
+	{
+		const std::string_view command{ ReadCommand(pCurrent, pEnd) };
+
+		float values[3];
+		if (command == "v")
+		{
+			//Vertex
+			if (!ReadFloat(pCurrent, pEnd, values[0]) || !ReadFloat(pCurrent, pEnd, values[1]) || !ReadFloat(pCurrent, pEnd, values[2]))
+				return false;
+			*chunk.pPositions++ = FPoint4{ values[0], values[1], -values[2] };
+		}
+		else if (command == "vt")
+		{
+			// Vertex TexCoord
+			if (!ReadFloat(pCurrent, pEnd, values[0]) || !ReadFloat(pCurrent, pEnd, values[1]))
+				return false;
+			*chunk.pUVs++ = FVector2{ values[0], 1 - values[1] };
+		}
+		else if (command == "vn")
+		{
+			// Vertex Normal
+			if (!ReadFloat(pCurrent, pEnd, values[0]) || !ReadFloat(pCurrent, pEnd, values[1]) || !ReadFloat(pCurrent, pEnd, values[2]))
+				return false;
+			*chunk.pNormals++ = FVector3{ values[0], values[1], -values[2] };
+		}
+		else if (command == "f")
+		{
+			// Faces or triangles, polygons are split into a fan around their first corner
+			pEnd = FindCommentStart(pCurrent, pEnd);
+			Corner first, previous, current;
+			if (!ReadCorner(pCurrent, pEnd, first) || !ReadCorner(pCurrent, pEnd, previous))
+				return false;
+
+			size_t triangleCount{};
+			for (SkipSpaces(pCurrent, pEnd); pCurrent < pEnd; SkipSpaces(pCurrent, pEnd))
+			{
+				if (!ReadCorner(pCurrent, pEnd, current))
+					return false;
+				chunk.corners.push_back(first);
+				chunk.corners.push_back(previous);
+				chunk.corners.push_back(current);
+				previous = current;
+				++triangleCount;
+			}
+			return triangleCount > 0;
+		}
+		//Comments and everything else are skipped
+		return true;
+	}
+
+	void ParseChunk(const char* pBegin, const char* pEnd, ChunkOutput& chunk)
+	{
+		ForEachLine(pBegin, pEnd, [&chunk](const char* pLine, const char* pLineEnd)
+			{
+				if (ParseLine(pLine, pLineEnd, chunk))
+					return true;
+
+				chunk.error = std::string{ pLine, pLineEnd };
+				return false;
+			});
+	}
+
+	//Runs function(i) for every i in [first, last) on the pool, or one after the other without one
+	template<typename Function>
+	void RunParallel(ThreadPool* pThreadPool, size_t first, size_t last, const Function& function)
+	{
+		if (!pThreadPool)
+		{
+			for (size_t i{ first }; i < last; ++i)
+				function(i);
+			return;
+		}
+		pThreadPool->ParallelFor(last - first, [first, &function](size_t i) { function(first + i); });
+	}
+
+	//Splits on line boundaries, the last chunk takes the remainder
+	std::vector<const char*> SplitChunks(const char* pBegin, const char* pEnd, uint32_t chunkCount)
+	{
+		std::vector<const char*> boundaries{ pBegin };
+		const size_t chunkSize{ static_cast<size_t>(pEnd - pBegin) / chunkCount };
+		for (uint32_t i{ 1 }; i < chunkCount; ++i)
+		{
+			const char* pSplit{ std::max(boundaries.back(), pBegin + chunkSize * i) };
+			const char* pLineEnd{ static_cast<const char*>(std::memchr(pSplit, '\n', static_cast<size_t>(pEnd - pSplit))) };
+			if (!pLineEnd)
+				break;
+			boundaries.push_back(pLineEnd + 1);
+		}
+		boundaries.push_back(pEnd);
+		return boundaries;
+	}
+
+	//Corners with the same position/uv/normal triple share one vertex, the indices are written from pIndex on
+	bool WeldCorners(const std::vector<Corner>& corners, const ChunkCounts& available, const std::vector<FPoint4>& positions, const std::vector<FVector2>& UVs,
+		const std::vector<FVector3>& normals, CornerTable& weldedCorners, std::vector<Vertex_Input>& vertices, uint32_t*& pIndex)
+	{
+		for (const Corner& corner : corners)
+		{
+			bool isInserted;
+			*pIndex++ = weldedCorners.FindOrInsert(corner, uint32_t(vertices.size()), isInserted);
+			if (!isInserted)
+				continue;
+
+			//Only the attributes of the chunks parsed so far are valid, OBJ never references ahead
+			if (corner.position >= available.positions
+				|| (corner.uv != g_InvalidIndex && corner.uv >= available.UVs)
+				|| (corner.normal != g_InvalidIndex && corner.normal >= available.normals))
+			{
+				std::cout << "Face index out of range" << std::endl;
+				return false;
+			}
+
+			Vertex_Input vertex{};
+			vertex.Position = positions[corner.position];
+			if (corner.uv != g_InvalidIndex)
+				vertex.UV = UVs[corner.uv];
+			if (corner.normal != g_InvalidIndex)
+				vertex.Normal = normals[corner.normal];
+
+			vertices.emplace_back(vertex);
+		}
+		return true;
+	}
+}
+
+bool Elite::ParseOBJ(const std::string& filename, const FVector3& /*position*/, std::vector<Vertex_Input>& vertices, std::vector<uint32_t>& indices, ThreadPool* pThreadPool,
+	uint32_t chunkCount, uint64_t* pSourceHash)
+{
+	const MappedFile file{ filename };
+	if (!file.IsValid())
+		return false;
+
+	if (pSourceHash)
+		*pSourceHash = Hash::Fnv1a(file.GetData(), file.GetSize());
+
+	const char* pBegin{ reinterpret_cast<const char*>(file.GetData()) };
+	const char* pEnd{ pBegin + file.GetSize() };
+
+	if (chunkCount == 0)
+		chunkCount = static_cast<uint32_t>(std::min<size_t>(file.GetSize() / g_BytesPerChunk + 1, UINT32_MAX));
+
+	const std::vector<const char*> boundaries{ SplitChunks(pBegin, pEnd, chunkCount) };
+	const size_t actualChunkCount{ boundaries.size() - 1 };
+	const size_t batchSize{ pThreadPool ? pThreadPool->GetThreadCount() + size_t{ 1 } : 1 };
+
+	//Pre-scan: exact element counts per chunk, their prefix sums are where every chunk writes
+	std::vector<ChunkCounts> counts(actualChunkCount);
+	for (size_t batch{}; batch < actualChunkCount; batch += batchSize)
+	{
+		RunParallel(pThreadPool, batch, std::min(batch + batchSize, actualChunkCount), [&](size_t i)
+			{
+				ScanChunk(boundaries[i], boundaries[i + 1], counts[i]);
+			});
+	}
+
+	std::vector<ChunkCounts> offsets(actualChunkCount + 1, ChunkCounts{});
+	for (size_t i{}; i < actualChunkCount; ++i)
+	{
+		offsets[i + 1].positions = offsets[i].positions + counts[i].positions;
+		offsets[i + 1].UVs = offsets[i].UVs + counts[i].UVs;
+		offsets[i + 1].normals = offsets[i].normals + counts[i].normals;
+		offsets[i + 1].triangles = offsets[i].triangles + counts[i].triangles;
+	}
+	const ChunkCounts& totals{ offsets.back() };
+
+	std::vector<FPoint4> positions(totals.positions);
+	std::vector<FVector2> UVs(totals.UVs);
+	std::vector<FVector3> normals(totals.normals);
+
+	vertices.clear();
+	vertices.reserve(std::max({ totals.positions, totals.UVs, totals.normals }));
+	indices.resize(totals.triangles * 3);
+	uint32_t* pIndex{ indices.data() };
+
+	//Parse a batch of chunks in parallel, then weld its faces in file order before parsing the next batch.
+	//Only the corners of one batch are alive at a time.
+	CornerTable weldedCorners{ vertices.capacity() };
+	std::vector<ChunkOutput> outputs(std::min(batchSize, actualChunkCount));
+	for (size_t batch{}; batch < actualChunkCount; batch += batchSize)
+	{
+		const size_t batchEnd{ std::min(batch + batchSize, actualChunkCount) };
+		RunParallel(pThreadPool, batch, batchEnd, [&](size_t i)
+			{
+				ChunkOutput& output{ outputs[i - batch] };
+				output.pPositions = positions.data() + offsets[i].positions;
+				output.pUVs = UVs.data() + offsets[i].UVs;
+				output.pNormals = normals.data() + offsets[i].normals;
+				output.corners.clear();
+				output.corners.reserve(counts[i].triangles * 3);
+				ParseChunk(boundaries[i], boundaries[i + 1], output);
+			});
+
+		for (size_t i{ batch }; i < batchEnd; ++i)
+		{
+			const ChunkOutput& output{ outputs[i - batch] };
+			if (!output.error.empty())
+			{
+				std::cout << "Error parsing line \"" << output.error << "\" in " << filename << std::endl;
+				return false;
+			}
+
+			if (!WeldCorners(output.corners, offsets[batchEnd], positions, UVs, normals, weldedCorners, vertices, pIndex))
+				return false;
+		}
+	}
+
+	MeshTangents::Compute(vertices, indices, pThreadPool);
+
+	return true;
+}
+
+bool Elite::ParseOBJLegacy(const std::string& filename, const FVector3& /*position*/, std::vector<Vertex_Input>& vertices, std::vector<uint32_t>& indices)
+{
+	std::ifstream file(filename);
+	if (!file.is_open())
+		return false;
+
+	std::vector<FPoint4> positions;
+	std::vector<FVector3> normals;
+	std::vector<FVector2> UVs;
+
+	std::string sCommand;
+	// read the first word of every line, stops once no command can be read anymore
+	// (testing eof() first processed the last command a second time)
+	while (file >> sCommand)
+	{
+		//use conditional statements to process the different commands	
+		if (sCommand == "#")
+		{
+			// Ignore Comment
+		}
+		else if (sCommand == "v")
+		{
+			//Vertex
+			float x, y, z;
+			file >> x >> y >> z;
+			positions.emplace_back(x, y, -z);
+		}
+		else if (sCommand == "vt")
+		{
+			// Vertex TexCoord
+			float u, v;
+			file >> u >> v;
+			UVs.emplace_back(FVector2(u, 1 - v));
+		}
+		else if (sCommand == "vn")
+		{
+			// Vertex Normal
+			float x, y, z;
+			file >> x >> y >> z;
+			normals.emplace_back(FVector3(x, y, -z));
+		}
+		else if (sCommand == "f")
+		{
+			//if a face is read:
+			//construct the 3 vertices, add them to the vertex array
+			//add three indices to the index array
+			//add the material index as attibute to the attribute array
+			//
+			// Faces or triangles
+			Vertex_Input vertex{  };
+			size_t iPosition, iTexCoord, iNormal;
+			for (size_t iFace = 0; iFace < 3; iFace++)
+			{
+				// OBJ format uses 1-based arrays
+				file >> iPosition;
+				vertex.Position = positions[iPosition - 1];
+
+				if ('/' == file.peek())//is next in buffer ==  '/' ?
+				{
+					file.ignore();//read and ignore one element ('/')
+
+					if ('/' != file.peek())
+					{
+						// Optional texture coordinate
+						file >> iTexCoord;
+						vertex.UV = FVector2{ UVs[iTexCoord - 1] };
+					}
+
+					if ('/' == file.peek())
+					{
+						file.ignore();
+
+						// Optional vertex normal
+						file >> iNormal;
+						vertex.Normal = normals[iNormal - 1];
+					}
+				}
+
+				vertices.emplace_back(vertex);
+				indices.emplace_back(uint32_t(vertices.size()) - 1);
+			}
+		}
+		//read till end of line and ignore all remaining chars
+		file.ignore(1000, '\n');
+	}
+
+	MeshTangents::Compute(vertices, indices);
+
+	return true;
+}
+
+void Elite::BenchmarkOBJParser(const std::string& filename, uint32_t iterations)
+{
+	std::error_code error;
+	const uintmax_t fileSize{ std::filesystem::file_size(filename, error) };
+	if (error || iterations == 0)
+	{
+		std::cout << "Error opening " << filename << " for benchmarking" << std::endl;
+		return;
+	}
+
+	std::vector<Vertex_Input> referenceVertices;
+	std::vector<uint32_t> referenceIndices;
+	if (!ParseOBJLegacy(filename, FVector3{}, referenceVertices, referenceIndices))
+	{
+		std::cout << "Error parsing " << filename << " for benchmarking" << std::endl;
+		return;
+	}
+
+	const auto benchmark = [&](const char* pName, const auto& parse)
+	{
+		std::vector<Vertex_Input> vertices;
+		std::vector<uint32_t> indices;
+
+		const auto start{ std::chrono::steady_clock::now() };
+		for (uint32_t i{}; i < iterations; ++i)
+		{
+			vertices.clear();
+			indices.clear();
+			parse(vertices, indices);
+		}
+		const float seconds{ std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count() / iterations };
+
+		//The legacy parser doesn't weld, so the triangles are compared corner by corner
+		const bool isMatching{ indices.size() == referenceIndices.size()
+			&& std::equal(indices.begin(), indices.end(), referenceIndices.begin(), [&](uint32_t a, uint32_t b)
+				{
+					return vertices[a].Position == referenceVertices[b].Position && vertices[a].UV == referenceVertices[b].UV && vertices[a].Normal == referenceVertices[b].Normal;
+				}) };
+
+		std::cout << "  " << pName << ": " << seconds * 1000.f << " ms, " << fileSize / 1'000'000.f / seconds << " MB/s, " << vertices.size() << " vertices"
+			<< (isMatching ? "" : " (output differs from the legacy parser)") << std::endl;
+	};
+
+	ThreadPool threadPool;
+	const uint32_t threadCount{ threadPool.GetThreadCount() + 1 };
+	std::cout << "Parsing " << filename << " (" << fileSize / 1024 << " KiB, " << iterations << " iterations)" << std::endl;
+	benchmark("ifstream", [&](auto& vertices, auto& indices) { ParseOBJLegacy(filename, FVector3{}, vertices, indices); });
+	benchmark("mapped, 1 chunk", [&](auto& vertices, auto& indices) { ParseOBJ(filename, FVector3{}, vertices, indices, nullptr, 1); });
+	benchmark("mapped, parallel", [&](auto& vertices, auto& indices) { ParseOBJ(filename, FVector3{}, vertices, indices, &threadPool, threadCount); });
+
+	//Tangents alone, on the welded vertices of the last parse
+	std::vector<Vertex_Input> vertices;
+	std::vector<uint32_t> indices;
+	ParseOBJ(filename, FVector3{}, vertices, indices);
+	for (ThreadPool* pTangentPool : { static_cast<ThreadPool*>(nullptr), &threadPool })
+	{
+		const auto start{ std::chrono::steady_clock::now() };
+		for (uint32_t i{}; i < iterations; ++i)
+		{
+			for (Vertex_Input& vertex : vertices)
+				vertex.Tangent = FVector3{};
+			MeshTangents::Compute(vertices, indices, pTangentPool);
+		}
+		const float seconds{ std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count() / iterations };
+		std::cout << "  tangents, " << (pTangentPool ? threadCount : 1) << " thread(s): " << seconds * 1000.f << " ms" << std::endl;
+	}
+}
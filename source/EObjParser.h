@@ -7,133 +7,27 @@
 /*=============================================================================*/
 
 #include <string>
-#include <fstream>
 #include <vector>
 #include "EMath.h"
 
 #include "structs.h"
 
+class ThreadPool;
 
 namespace Elite
 {
-
-	//Just parses vertices and indices
-	static bool ParseOBJ(const std::string& filename, const FVector3& /*position*/, std::vector<Vertex_Input>& vertices, std::vector<uint32_t>& indices)
-	{
-		std::ifstream file(filename);
-		if (!file.is_open())
-			return false;
-
-		std::vector<FPoint4> positions;
-		std::vector<FVector3> normals;
-		std::vector<FVector2> UVs;
-
-		std::string sCommand;
-		// start a while iteration ending when the end of file is reached (ios::eof)
-		while (!file.eof())
-		{
-			//read the first word of the string, use the >> operator (istream::operator>>) 
-			file >> sCommand;
-			//use conditional statements to process the different commands	
-			if (sCommand == "#")
-			{
-				// Ignore Comment
-			}
-			else if (sCommand == "v")
-			{
-				//Vertex
-				float x, y, z;
-				file >> x >> y >> z;
-				positions.emplace_back(x, y, -z);
-			}
-			else if (sCommand == "vt")
-			{
-				// Vertex TexCoord
-				float u, v;
-				file >> u >> v;
-				UVs.emplace_back(FVector2(u, 1 - v));
-			}
-			else if (sCommand == "vn")
-			{
-				// Vertex Normal
-				float x, y, z;
-				file >> x >> y >> z;
-				normals.emplace_back(FVector3(x, y, -z));
-			}
-			else if (sCommand == "f")
-			{
-				//if a face is read:
-				//construct the 3 vertices, add them to the vertex array
-				//add three indices to the index array
-				//add the material index as attibute to the attribute array
-				//
-				// Faces or triangles
-				Vertex_Input vertex{  };
-				size_t iPosition, iTexCoord, iNormal;
-				for (size_t iFace = 0; iFace < 3; iFace++)
-				{
-					// OBJ format uses 1-based arrays
-					file >> iPosition;
-					vertex.Position = positions[iPosition - 1];
-
-					if ('/' == file.peek())//is next in buffer ==  '/' ?
-					{
-						file.ignore();//read and ignore one element ('/')
-
-						if ('/' != file.peek())
-						{
-							// Optional texture coordinate
-							file >> iTexCoord;
-							vertex.UV = FVector2{ UVs[iTexCoord - 1] };
-						}
-
-						if ('/' == file.peek())
-						{
-							file.ignore();
-
-							// Optional vertex normal
-							file >> iNormal;
-							vertex.Normal = normals[iNormal - 1];
-						}
-					}
-
-					vertices.emplace_back(vertex);
-					indices.emplace_back(uint32_t(vertices.size()) - 1);
-				}
-			}
-			//read till end of line and ignore all remaining chars
-			file.ignore(1000, '\n');
-		}
-
-		//Tangents
-		for (uint32_t i = 0; i < indices.size(); i += 3) {
-			uint32_t index0 = indices[i];
-			uint32_t index1 = indices[i + 1];
-			uint32_t index2 = indices[i + 2];
-
-			const FPoint3& p0 = vertices[index0].Position.xyz;
-			const FPoint3& p1 = vertices[index1].Position.xyz;
-			const FPoint3& p2 = vertices[index2].Position.xyz;
-			const FVector2& uv0 = vertices[index0].UV;
-			const FVector2& uv1 = vertices[index1].UV;
-			const FVector2& uv2 = vertices[index2].UV;
-
-			const FVector3 edge0 = p1 - p0;
-			const FVector3 edge1 = p2 - p0;
-			const FVector2 diffX = FVector2(uv1.x - uv0.x, uv2.x - uv0.x);
-			const FVector2 diffY = FVector2(uv1.y - uv0.y, uv2.y - uv0.y);
-			float r = 1.f / Cross(diffX, diffY);
-
-			FVector3 tangent = (edge0 * diffY.y - edge1 * diffY.x) * r;
-			tangent.z *= -1.f;
-
-			vertices[index0].Tangent += tangent;
-			vertices[index1].Tangent += tangent;
-			vertices[index2].Tangent += tangent;
-		}
-		for (auto& v : vertices)
-			v.Tangent = Elite::GetNormalized(Reject(v.Tangent, v.Normal));
-
-		return true;
-	}
-}
\ No newline at end of file
+	//Parses vertices and indices, corners sharing the same position/uv/normal indices are welded into one vertex.
+	//Polygons are fan triangulated. The file is memory mapped and tokenized in place, chunkCount 0 picks one chunk per 4 MB.
+	//A pre-scan counts every element so all arrays are allocated once at their final size, then the chunks are parsed
+	//one batch (a chunk per pool thread) at a time, which bounds the temporary face data no matter how large the file is.
+	//The chunks run on pThreadPool, which may be the pool this is called from, or one after the other when it is null.
+	//pSourceHash receives the Hash::Fnv1a of the mapped bytes, so callers never have to read the file a second time.
+	bool ParseOBJ(const std::string& filename, const FVector3& position, std::vector<Vertex_Input>& vertices, std::vector<uint32_t>& indices,
+		ThreadPool* pThreadPool = nullptr, uint32_t chunkCount = 0, uint64_t* pSourceHash = nullptr);
+
+	//Original std::ifstream based parser, only kept as the reference for BenchmarkOBJParser
+	bool ParseOBJLegacy(const std::string& filename, const FVector3& position, std::vector<Vertex_Input>& vertices, std::vector<uint32_t>& indices);
+
+	//Prints the parse throughput in MB/s of the legacy, single chunk and chunked parser
+	void BenchmarkOBJParser(const std::string& filename, uint32_t iterations);
+}
@@ -33,7 +33,7 @@ namespace Elite
 	};
 
 	template<int N, typename T>
-	inline T SqrDistance(const Point<N, T>& p1, const Point<N, T>& p2)
+	constexpr T SqrDistance(const Point<N, T>& p1, const Point<N, T>& p2)
 	{
 		const Vector<N, T> diff = p2 - p1;
 		return SqrMagnitude(diff);
@@ -21,25 +21,26 @@ namespace Elite
 #pragma warning(disable : 4201)
 		union
 		{
-			T data[2];
+			//First, so a value initialized one starts with the member constant expressions read
 			struct { T x, y; };
+			T data[2];
 		};
 #pragma warning(default : 4201)
 
 		//=== Constructors ===
 #pragma region Constructors
 		Point<2, T>() = default;
-		Point<2, T>(T _x, T _y)
+		constexpr Point<2, T>(T _x, T _y)
 			: x(_x), y(_y) {}
-		Point<2, T>(const Point<2, T>& p)
+		constexpr Point<2, T>(const Point<2, T>& p)
 			: x(p.x), y(p.y) {}
-		Point<2, T>(Point<2, T>&& p) noexcept
+		constexpr Point<2, T>(Point<2, T>&& p) noexcept
 			:x(std::move(p.x)), y(std::move(p.y)) {}
-		explicit Point<2, T>(const Vector<2, T>& v)
+		constexpr explicit Point<2, T>(const Vector<2, T>& v)
 			: x(v.x), y(v.y) {}
-		explicit Point<2, T>(const Point<3, T>& p)
+		constexpr explicit Point<2, T>(const Point<3, T>& p)
 			: x(p.x), y(p.y) {}
-		explicit Point<2, T>(const Point<4, T>& p)
+		constexpr explicit Point<2, T>(const Point<4, T>& p)
 			: x(p.x), y(p.y) {}
 #pragma endregion
 
@@ -57,27 +58,27 @@ namespace Elite
 		//=== Arithmetic Operators ===
 #pragma region ArithmeticOperators
 		template<typename U>
-		inline Point<2, T> operator+(const Vector<2, U>& v) const
+		constexpr Point<2, T> operator+(const Vector<2, U>& v) const
 		{ return Point<2, T>(x + static_cast<T>(v.x), y + static_cast<T>(v.y)); }
 
 		template<typename U>
-		inline Point<2, T> operator-(const Vector<2, U>& v) const
+		constexpr Point<2, T> operator-(const Vector<2, U>& v) const
 		{ return Point<2, T>(x - static_cast<T>(v.x), y - static_cast<T>(v.y)); }
 
 		template<typename U>
-		inline Vector<2, T> operator-(const Point<2, U>& p) const
+		constexpr Vector<2, T> operator-(const Point<2, U>& p) const
 		{ return Vector<2, T>(x - static_cast<T>(p.x), y - static_cast<T>(p.y)); }
 #pragma endregion
 
 		//=== Compound Assignment Operators ===
 #pragma region CompoundAssignmentOperators
-		inline Point<2, T>& operator=(const Point<2, T>& p)
+		constexpr Point<2, T>& operator=(const Point<2, T>& p)
 		{ x = p.x; y = p.y; return *this; }
 
-		inline Point<2, T>& operator+=(const Vector<2, T>& v)
+		constexpr Point<2, T>& operator+=(const Vector<2, T>& v)
 		{ x += v.x; y += v.y; return *this; }
 
-		inline Point<2, T>& operator-=(const Vector<2, T>& v)
+		constexpr Point<2, T>& operator-=(const Vector<2, T>& v)
 		{ x -= v.x; y -= v.y; return *this; }
 #pragma endregion
 
@@ -23,46 +23,45 @@ namespace Elite
 
 		//=== Constructors & Destructor ===
 		RGBColor() = default;
-		RGBColor(float _r, float _g, float _b) :r(_r), g(_g), b(_b) {}
-		RGBColor(const RGBColor& c) : r(c.r), g(c.g), b(c.b) {}
-		RGBColor(RGBColor&& c) noexcept : r(std::move(c.r)), g(std::move(c.g)), b(std::move(c.b)) {}
+		constexpr RGBColor(float _r, float _g, float _b) :r(_r), g(_g), b(_b) {}
+		//Defaulted, so the type is trivially copyable and passed around in registers
+		RGBColor(const RGBColor& c) = default;
+		RGBColor(RGBColor&& c) noexcept = default;
 		~RGBColor() = default;
 
 		//=== Operators ===
-		RGBColor& operator=(const RGBColor& c)
-		{ r = c.r; g = c.g; b = c.b; return *this; }
-		RGBColor& operator=(RGBColor&& c) noexcept
-		{ r = std::move(c.r); g = std::move(c.g); b = std::move(c.b); return *this;	}
+		RGBColor& operator=(const RGBColor& c) = default;
+		RGBColor& operator=(RGBColor&& c) noexcept = default;
 
 		//=== Arithmetic Operators ===
-		inline RGBColor operator+(const RGBColor& c) const
+		constexpr RGBColor operator+(const RGBColor& c) const
 		{ return RGBColor(r + c.r, g + c.g, b + c.b); }
-		inline RGBColor operator-(const RGBColor& c) const 
+		constexpr RGBColor operator-(const RGBColor& c) const 
 		{ return RGBColor(r - c.r, g - c.g, b - c.b); }
-		inline RGBColor operator*(const RGBColor& c) const 
+		constexpr RGBColor operator*(const RGBColor& c) const 
 		{ return RGBColor(r * c.r, g * c.g, b * c.b); }
-		inline RGBColor operator/(float f) const
+		constexpr RGBColor operator/(float f) const
 		{
 			float rev = 1.0f / f;
 			return RGBColor(r * rev, g * rev, b * rev);
 		}
-		inline RGBColor operator*(float f) const
+		constexpr RGBColor operator*(float f) const
 		{ return RGBColor(r * f, g * f, b * f);	}
-		inline RGBColor operator/(const RGBColor& c) const
+		constexpr RGBColor operator/(const RGBColor& c) const
 		{ return RGBColor(r / c.r, g / c.g, b / c.b); }
 
 		//=== Compound Assignment Operators ===
-		inline RGBColor& operator+=(const RGBColor& c)
+		constexpr RGBColor& operator+=(const RGBColor& c)
 		{ r += c.r; g += c.g; b += c.b; return *this; }
-		inline RGBColor& operator-=(const RGBColor& c)
+		constexpr RGBColor& operator-=(const RGBColor& c)
 		{ r -= c.r; g -= c.g; b -= c.b; return *this; }
-		inline RGBColor& operator*=(const RGBColor& c)
+		constexpr RGBColor& operator*=(const RGBColor& c)
 		{ r *= c.r; g *= c.g; b *= c.b; return *this; }
-		inline RGBColor& operator/=(const RGBColor& c)
+		constexpr RGBColor& operator/=(const RGBColor& c)
 		{ r /= c.r; g /= c.g; b /= c.b; return *this; }
-		inline RGBColor& operator*=(float f)
+		constexpr RGBColor& operator*=(float f)
 		{ r *= f; g *= f; b *= f; return *this; }
-		inline RGBColor& operator/=(float f)
+		constexpr RGBColor& operator/=(float f)
 		{
 			float rev = 1.0f / f;
 			r *= rev; g *= rev; b *= rev; return *this;
@@ -75,14 +74,14 @@ namespace Elite
 		{ return !(*this == c);	}
 
 		//=== Internal RGBColor Functions ===
-		inline void Clamp()
+		constexpr void Clamp()
 		{
 			r = Elite::Clamp(r, 0.0f, 1.0f);
 			g = Elite::Clamp(g, 0.0f, 1.0f);
 			b = Elite::Clamp(b, 0.0f, 1.0f);
 		}
 
-		inline void MaxToOne()
+		constexpr void MaxToOne()
 		{
 			float maxValue = std::max(r, std::max(g, b));
 			if (maxValue > 1.f)
@@ -91,7 +90,7 @@ namespace Elite
 	};
 
 	//=== Global RGBColor Functions ===
-	inline RGBColor Max(const RGBColor& c1, const RGBColor& c2)
+	constexpr RGBColor Max(const RGBColor& c1, const RGBColor& c2)
 	{
 		RGBColor c = c1;
 		if (c2.r > c.r) c.r = c2.r;
@@ -100,7 +99,7 @@ namespace Elite
 		return c;
 	}
 
-	inline RGBColor Min(const RGBColor& c1, const RGBColor& c2)
+	constexpr RGBColor Min(const RGBColor& c1, const RGBColor& c2)
 	{
 		RGBColor c = c1;
 		if (c2.r < c.r) c.r = c2.r;
@@ -109,7 +108,7 @@ namespace Elite
 		return c;
 	}
 
-	inline uint32_t GetSDL_ARGBColor(const RGBColor& c)
+	constexpr uint32_t GetSDL_ARGBColor(const RGBColor& c)
 	{
 		RGBColor rsColor = c * 255;
 		uint32_t finalColor = 0;
@@ -119,7 +118,7 @@ namespace Elite
 		return finalColor;
 	}
 
-	inline RGBColor GetColorFromSDL_ARGB(const uint32_t c)
+	constexpr RGBColor GetColorFromSDL_ARGB(const uint32_t c)
 	{
 		RGBColor color =
 		{
@@ -159,5 +158,13 @@ namespace Elite
 		result.MaxToOne();
 		return result;
 	}
+
+	//=== Compile Time Checks ===
+	static_assert((RGBColor{ 0.5f, 0.25f, 1.f } * RGBColor{ 2.f, 2.f, 0.5f } + RGBColor{ 0.f, 0.5f, 0.f }).g == 1.f);
+	static_assert([] { RGBColor c{ 4.f, 2.f, 1.f }; c.MaxToOne(); return c.g; }() == 0.5f);
+	static_assert([] { RGBColor c{ -1.f, 0.5f, 2.f }; c.Clamp(); return c.r == 0.f && c.b == 1.f; }());
+	static_assert(GetSDL_ARGBColor(RGBColor{ 1.f, 0.5f, 0.f }) == 0x00FF7F00);
+	static_assert(GetColorFromSDL_ARGB(0x00FF0033).b == 0.2f);
+	static_assert(std::is_trivially_copyable_v<RGBColor>);
 }
 #endif
\ No newline at end of file
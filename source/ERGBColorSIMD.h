@@ -0,0 +1,153 @@
+/*=============================================================================*/
+// ERGBColorSIMD.h: RGBColor in an SSE register, and eight of them side by side (SoA) for batch kernels
+/*=============================================================================*/
+#ifndef ELITE_MATH_RGBCOLOR_SIMD
+#define ELITE_MATH_RGBCOLOR_SIMD
+
+//For the shading loops: every operation is one or two instructions on a register instead of three scalar temporaries,
+//MultiplyAdd fuses the lighting terms, MaxToOne has no branch and the result goes straight to a packed pixel.
+//RGBColor stays the type to store colors and to use in constant expressions, convert at the edges.
+#include "EMath.h"
+#include "ERGBColor.h"
+#include <immintrin.h>
+
+namespace Elite
+{
+	//=== RGBCOLOR4 ===
+	//r, g and b in the first three lanes, the fourth one stays 0
+	struct RGBColor4
+	{
+		__m128 m;
+
+		//=== Constructors ===
+#pragma region Constructors
+		RGBColor4() = default;
+		explicit RGBColor4(__m128 _m) : m(_m) {}
+		RGBColor4(float r, float g, float b) : m(_mm_setr_ps(r, g, b, 0.f)) {}
+		RGBColor4(const RGBColor& c) : m(_mm_setr_ps(c.r, c.g, c.b, 0.f)) {}
+
+		inline RGBColor ToRGBColor() const
+		{
+			alignas(16) float f[4];
+			_mm_store_ps(f, m);
+			return RGBColor{ f[0], f[1], f[2] };
+		}
+#pragma endregion
+
+		//=== Arithmetic Operators ===
+#pragma region ArithmeticOperators
+		inline RGBColor4 operator+(const RGBColor4& c) const { return RGBColor4{ _mm_add_ps(m, c.m) }; }
+		inline RGBColor4 operator-(const RGBColor4& c) const { return RGBColor4{ _mm_sub_ps(m, c.m) }; }
+		inline RGBColor4 operator*(const RGBColor4& c) const { return RGBColor4{ _mm_mul_ps(m, c.m) }; }
+		inline RGBColor4 operator*(float f) const { return RGBColor4{ _mm_mul_ps(m, _mm_set1_ps(f)) }; }
+		inline RGBColor4 operator/(float f) const { return RGBColor4{ _mm_mul_ps(m, _mm_set1_ps(1.f / f)) }; }
+
+		inline RGBColor4& operator+=(const RGBColor4& c) { m = _mm_add_ps(m, c.m); return *this; }
+		inline RGBColor4& operator-=(const RGBColor4& c) { m = _mm_sub_ps(m, c.m); return *this; }
+		inline RGBColor4& operator*=(const RGBColor4& c) { m = _mm_mul_ps(m, c.m); return *this; }
+		inline RGBColor4& operator*=(float f) { m = _mm_mul_ps(m, _mm_set1_ps(f)); return *this; }
+#pragma endregion
+
+		//=== Internal RGBColor4 Functions ===
+#pragma region InternalFunctions
+		inline void Clamp()
+		{ m = _mm_min_ps(_mm_max_ps(m, _mm_setzero_ps()), _mm_set1_ps(1.f)); }
+
+		//Divides by the largest component if it is above 1 and by 1 otherwise, the same result as RGBColor without the branch
+		inline void MaxToOne()
+		{
+			__m128 maxValue = _mm_max_ps(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(2, 3, 0, 1)));
+			maxValue = _mm_max_ps(maxValue, _mm_shuffle_ps(maxValue, maxValue, _MM_SHUFFLE(1, 0, 3, 2)));
+			m = _mm_mul_ps(m, _mm_div_ps(_mm_set1_ps(1.f), _mm_max_ps(maxValue, _mm_set1_ps(1.f))));
+		}
+#pragma endregion
+	};
+
+	//=== Global RGBColor4 Functions ===
+	//a * b + c, a single rounding where the build has FMA
+	inline RGBColor4 MultiplyAdd(const RGBColor4& a, const RGBColor4& b, const RGBColor4& c)
+	{
+#if defined(__FMA__) || defined(__AVX2__)
+		return RGBColor4{ _mm_fmadd_ps(a.m, b.m, c.m) };
+#else
+		return RGBColor4{ _mm_add_ps(_mm_mul_ps(a.m, b.m), c.m) };
+#endif
+	}
+
+	inline RGBColor4 MultiplyAdd(const RGBColor4& a, float f, const RGBColor4& c)
+	{ return MultiplyAdd(a, RGBColor4{ _mm_set1_ps(f) }, c); }
+
+	inline RGBColor4 Max(const RGBColor4& c1, const RGBColor4& c2) { return RGBColor4{ _mm_max_ps(c1.m, c2.m) }; }
+	inline RGBColor4 Min(const RGBColor4& c1, const RGBColor4& c2) { return RGBColor4{ _mm_min_ps(c1.m, c2.m) }; }
+
+	//0x00RRGGBB like GetSDL_ARGBColor: truncated the same way, but out of range components saturate instead of wrapping
+	inline uint32_t GetSDL_ARGBColor(const RGBColor4& c)
+	{
+		__m128i i = _mm_cvttps_epi32(_mm_mul_ps(c.m, _mm_set1_ps(255.f)));
+		i = _mm_shuffle_epi32(i, _MM_SHUFFLE(3, 0, 1, 2)); //b, g, r, 0 from the lowest byte up
+		i = _mm_packs_epi32(i, i);
+		i = _mm_packus_epi16(i, i);
+		return static_cast<uint32_t>(_mm_cvtsi128_si32(i));
+	}
+
+	//=== RGBCOLORx8 ===
+	//Eight colors, a register per component (see EMathBatch.h)
+	struct RGBColorx8
+	{
+		FFloat8 r, g, b;
+
+		//=== Constructors ===
+#pragma region Constructors
+		RGBColorx8() = default;
+		RGBColorx8(const FFloat8& _r, const FFloat8& _g, const FFloat8& _b) : r(_r), g(_g), b(_b) {}
+		explicit RGBColorx8(const RGBColor& c) : r(c.r), g(c.g), b(c.b) {} //The same color in every lane
+#pragma endregion
+
+		//=== Arithmetic Operators ===
+#pragma region ArithmeticOperators
+		inline RGBColorx8 operator+(const RGBColorx8& c) const { return RGBColorx8{ r + c.r, g + c.g, b + c.b }; }
+		inline RGBColorx8 operator-(const RGBColorx8& c) const { return RGBColorx8{ r - c.r, g - c.g, b - c.b }; }
+		inline RGBColorx8 operator*(const RGBColorx8& c) const { return RGBColorx8{ r * c.r, g * c.g, b * c.b }; }
+		inline RGBColorx8 operator*(const FFloat8& f) const { return RGBColorx8{ r * f, g * f, b * f }; }
+
+		inline RGBColorx8& operator+=(const RGBColorx8& c) { r += c.r; g += c.g; b += c.b; return *this; }
+		inline RGBColorx8& operator*=(const FFloat8& f) { r *= f; g *= f; b *= f; return *this; }
+#pragma endregion
+
+		//=== Internal RGBColorx8 Functions ===
+#pragma region InternalFunctions
+		inline void Clamp()
+		{
+			r = Elite::Clamp(r, 0.f, 1.f);
+			g = Elite::Clamp(g, 0.f, 1.f);
+			b = Elite::Clamp(b, 0.f, 1.f);
+		}
+
+		inline void MaxToOne()
+		{
+			const FFloat8 scale{ 1.f / Max(Max(Max(r, g), b), 1.f) };
+			*this *= scale;
+		}
+#pragma endregion
+	};
+
+	inline RGBColorx8 MultiplyAdd(const RGBColorx8& a, const RGBColorx8& b, const RGBColorx8& c)
+	{ return RGBColorx8{ MultiplyAdd(a.r, b.r, c.r), MultiplyAdd(a.g, b.g, c.g), MultiplyAdd(a.b, b.b, c.b) }; }
+
+	inline RGBColorx8 MultiplyAdd(const RGBColorx8& a, const FFloat8& f, const RGBColorx8& c)
+	{ return RGBColorx8{ MultiplyAdd(a.r, f, c.r), MultiplyAdd(a.g, f, c.g), MultiplyAdd(a.b, f, c.b) }; }
+
+	inline RGBColorx8 Select(const FMask8& m, const RGBColorx8& a, const RGBColorx8& b)
+	{ return RGBColorx8{ Select(m, a.r, b.r), Select(m, a.g, b.g), Select(m, a.b, b.b) }; }
+
+	//Eight 0x00RRGGBB pixels, like the single color version. The channels are truncated and saturated as floats, then
+	//put together as r * 2^16 + g * 2^8 + b, which is exact in a float: no integer vector instructions needed.
+	inline void GetSDL_ARGBColor(const RGBColorx8& c, uint32_t* pPixels)
+	{
+		const FFloat8 r{ Truncate(Clamp(c.r * 255.f, 0.f, 255.f)) };
+		const FFloat8 g{ Truncate(Clamp(c.g * 255.f, 0.f, 255.f)) };
+		const FFloat8 b{ Truncate(Clamp(c.b * 255.f, 0.f, 255.f)) };
+		Batch::StoreInt(pPixels, MultiplyAdd(r, 65536.f, MultiplyAdd(g, 256.f, b)).r);
+	}
+}
+#endif
@@ -4,9 +4,20 @@
 #include "ERenderer.h"
 
 //My includes
+#include "EFastMath.h"
 #include "Texture.h"
 #include "Triangle.h"
 #include "Mesh.h"
+#include "AssetLoader.h"
+#include "AssetRegistry.h"
+#include "AssetStreamer.h"
+#include "InstanceBuffer.h"
+#include "Meshlets.h"
+#include "OcclusionBuffer.h"
+#include "RenderQueue.h"
+#include "Scene.h"
+#include "ThreadPool.h"
+#include "VertexPacking.h"
 
 
 Elite::Renderer::Renderer(SDL_Window * pWindow, Camera* pCamera)
@@ -18,7 +29,19 @@ Elite::Renderer::Renderer(SDL_Window * pWindow, Camera* pCamera)
 	, m_Angle{}
 	, m_RotateSpeed{ -ToRadians(45.f) }
 	, m_pCamera{ pCamera }
+	, m_VehicleMaterial{}
+	, m_FleetSize{}
 	, m_ShowFireFX{ true }
+	, m_FireFXInstance{}
+	, m_IsOcclusionCulling{ true }
+	, m_IsMeshletCulling{ true }
+	, m_DrawnMeshlets{}
+	, m_FrustumCulledMeshlets{}
+	, m_BackfaceCulledMeshlets{}
+	, m_IsFastMath{ false }
+	, m_World{ FMatrix4::Identity() }
+	, m_WorldViewProjection{ FMatrix4::Identity() }
+	, m_pMaterial{ nullptr }
 {
 	int width, height = 0;
 	SDL_GetWindowSize(pWindow, &width, &height);
@@ -33,23 +56,40 @@ Elite::Renderer::Renderer(SDL_Window * pWindow, Camera* pCamera)
 
 	InitializeDirectX();
 	
-	// Vehicle
-	m_pVehicle = make_unique<Mesh>(m_pDevice.Get(), "Resources/vehicle.obj", FVector3(0, 0, 50));
-	m_pDiffuseMap = make_unique<Texture>("Resources/vehicle_diffuse.png", m_pDevice.Get());
-	m_pNormalMap = make_unique<Texture>("Resources/vehicle_normal.png", m_pDevice.Get());
-	m_pSpecularMap = make_unique<Texture>("Resources/vehicle_specular.png", m_pDevice.Get());
-	m_pGlossinessMap = make_unique<Texture>("Resources/vehicle_gloss.png", m_pDevice.Get());
+	// Decode on the worker threads, upload here
+	m_pThreadPool = make_unique<ThreadPool>();
+	m_pAssetRegistry = make_unique<AssetRegistry>();
+	AssetLoader loader{ m_pThreadPool.get(), m_pAssetRegistry.get() };
 
-	m_pVehicle->SetDiffuseMap(m_pDiffuseMap->GetResourceView());
-	m_pVehicle->SetNormalMap(m_pNormalMap->GetResourceView());
-	m_pVehicle->SetSpecularMap(m_pSpecularMap->GetResourceView());
-	m_pVehicle->SetGlossinessMap(m_pGlossinessMap->GetResourceView());
+	// Vehicle
+	Material vehicleMaterial{};
+	loader.AddMesh(m_pVehicle, "Resources/vehicle.obj", FVector3(0, 0, 50));
+	loader.AddTexture(vehicleMaterial.pDiffuseMap, "Resources/vehicle_diffuse.png", TextureFormat::bc1);
+	loader.AddTexture(vehicleMaterial.pNormalMap, "Resources/vehicle_normal.png", TextureFormat::bc5);
+	loader.AddTexture(vehicleMaterial.pSpecularMap, "Resources/vehicle_specular.png", TextureFormat::bc1);
+	loader.AddTexture(vehicleMaterial.pGlossinessMap, "Resources/vehicle_gloss.png", TextureFormat::bc1);
 
 	// FireFX
-	m_pFireFX = make_unique<Mesh>(m_pDevice.Get(), "Resources/fireFX.obj", FVector3(0,0,50), true);
-	m_pFireFXDiffuse = make_unique<Texture>("Resources/fireFX_diffuse.png", m_pDevice.Get());
-
-	m_pFireFX->SetDiffuseMap(m_pFireFXDiffuse->GetResourceView());
+	Material fireFXMaterial{};
+	fireFXMaterial.isTransparent = true;
+	loader.AddMesh(m_pFireFX, "Resources/fireFX.obj", FVector3(0, 0, 50), true);
+	loader.AddTexture(fireFXMaterial.pDiffuseMap, "Resources/fireFX_diffuse.png", TextureFormat::bc3);
+
+	loader.Load(m_pDevice.Get());
+	m_pAssetRegistry->PrintResidency();
+
+	m_pScene = make_unique<Scene>();
+	m_pRenderQueue = make_unique<RenderQueue>();
+	m_pInstanceBuffer = make_unique<InstanceBuffer>();
+	m_pOcclusionBuffer = make_unique<OcclusionBuffer>(m_pThreadPool.get());
+
+	m_VehicleMaterial = m_pScene->AddMaterial(std::move(vehicleMaterial));
+	const uint32_t fireFXMaterialId{ m_pScene->AddMaterial(std::move(fireFXMaterial)) };
+	m_pScene->SetOccluder(m_pScene->AddInstance(m_pVehicle.get(), m_VehicleMaterial, m_pVehicle->GetPosition()), true);
+	m_FireFXInstance = m_pScene->AddInstance(m_pFireFX.get(), fireFXMaterialId, m_pFireFX->GetPosition());
+
+	// Runtime loads, drawn as a textured box until they are uploaded
+	m_pAssetStreamer = make_unique<AssetStreamer>(m_pThreadPool.get(), m_pAssetRegistry.get(), m_pDevice.Get());
 }
 
 Elite::Renderer::~Renderer()
@@ -61,38 +101,45 @@ Elite::Renderer::~Renderer()
 
 void Elite::Renderer::Render()
 {
+	m_pRenderQueue->Build(*m_pScene, *m_pCamera);
+
 	if (m_RasterMode == RasterMode::hardware)
 	{
 		if (!m_IsInitialized)
 			return;
 
+		// The occluders are drawn on the worker threads while the targets are cleared and the camera constants set here
+		if (m_IsOcclusionCulling)
+			m_pOcclusionBuffer->BeginCull(*m_pRenderQueue, m_CullMode);
+
 		//Clear Buffers
-		const RGBColor clearColor = RGBColor(0.1f, 0.1f, 0.1f);
-		m_pDeviceContext->ClearRenderTargetView(m_pRenderTargetView.Get(), &clearColor.r);
+		// RGBA, RGBColor only has the 3 floats
+		const float clearColor[4]{ 0.1f, 0.1f, 0.1f, 1.f };
+		m_pDeviceContext->ClearRenderTargetView(m_pRenderTargetView.Get(), clearColor);
 		m_pDeviceContext->ClearDepthStencilView(m_pDepthStencilView.Get(), D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.0f, 0);
 
-		// Initialize Variables
-		const FVector3 vehiclePos = m_pVehicle->GetPosition();
-
-		FMatrix4 world = MakeTranslation(vehiclePos);
-		world *= static_cast<FMatrix4>(MakeRotationY(m_Angle));
-
-		const FMatrix4 worldViewPort = m_pCamera->GetWorldViewProjection();
-		const FMatrix4 viewInv = m_pCamera->GetViewToWorld();
+		// The same for every batch, and EndCull only ever drops batches
+		const FMatrix4& viewProjection = m_pCamera->GetViewProjection();
+		const FMatrix4& viewInv = m_pCamera->GetViewToWorld();
+		for (const RenderQueue::Batch& batch : m_pRenderQueue->GetBatches())
+		{
+			batch.pMesh->SetViewProjectionMatrix(reinterpret_cast<const float*>(viewProjection.data));
+			batch.pMesh->SetViewInverseMatrix(reinterpret_cast<const float*>(viewInv.data));
+		}
 
-		// Render
-		m_pCamera->SetWorldMatrix(world);
-		m_pVehicle->SetWorldViewMatrix(reinterpret_cast<const float*>(worldViewPort.data));
-		m_pVehicle->SetWorldMatrix(reinterpret_cast<float*>(world.data));
-		m_pVehicle->SetViewInverseMatrix(reinterpret_cast<const float*>(viewInv.data));
-		m_pVehicle->Render(m_pDeviceContext.Get());
+		// The instance buffer and the draws need the instances that survived
+		if (m_IsOcclusionCulling)
+			m_pOcclusionBuffer->EndCull(*m_pRenderQueue);
 
-		if (m_ShowFireFX)
+		// Render, one instanced draw per batch. Material maps are set per draw, a mesh can show up in several batches.
+		if (m_pInstanceBuffer->Upload(m_pDevice.Get(), m_pDeviceContext.Get(), m_pRenderQueue->GetWorldMatrices()))
 		{
-			m_pFireFX->SetWorldViewMatrix(reinterpret_cast<const float*>(worldViewPort.data));
-			m_pFireFX->SetWorldMatrix(reinterpret_cast<float*>(world.data));
-			m_pFireFX->SetViewInverseMatrix(reinterpret_cast<const float*>(viewInv.data));
-			m_pFireFX->Render(m_pDeviceContext.Get());
+			for (const RenderQueue::Batch& batch : m_pRenderQueue->GetBatches())
+			{
+				batch.pMesh->SetInstanceBuffer(m_pInstanceBuffer->GetResourceView());
+				SetMaterialMaps(*batch.pMesh, m_pScene->GetMaterial(batch.material));
+				batch.pMesh->Render(m_pDeviceContext.Get(), batch.lod, batch.firstInstance, batch.instanceCount);
+			}
 		}
 
 		//Present
@@ -107,8 +154,26 @@ void Elite::Renderer::Render()
 		// Reset to black
 		SDL_FillRect(m_pBackBuffer, nullptr, 0xFF1A1A1A);
 
-		RenderTriangleMesh(m_pVehicle.get());
-		//No Booster render in software rasterizer
+		m_DrawnMeshlets = 0;
+		m_FrustumCulledMeshlets = 0;
+		m_BackfaceCulledMeshlets = 0;
+
+		const std::span<const FMatrix4> worldMatrices{ m_pRenderQueue->GetWorldMatrices() };
+		const std::span<const FMatrix4> worldViewProjections{ m_pRenderQueue->GetWorldViewProjections() };
+		for (const RenderQueue::Batch& batch : m_pRenderQueue->GetBatches())
+		{
+			//No transparent render in software rasterizer
+			if (batch.isTransparent)
+				continue;
+
+			m_pMaterial = &m_pScene->GetMaterial(batch.material);
+			for (uint32_t i{ batch.firstInstance }; i < batch.firstInstance + batch.instanceCount; ++i)
+			{
+				m_World = worldMatrices[i];
+				m_WorldViewProjection = worldViewProjections[i];
+				RenderTriangleMesh(batch.pMesh, batch.lod);
+			}
+		}
 
 		SDL_UnlockSurface(m_pBackBuffer);
 		SDL_BlitSurface(m_pBackBuffer, 0, m_pFrontBuffer, 0);
@@ -118,7 +183,69 @@ void Elite::Renderer::Render()
 
 void Elite::Renderer::Update(float dt)
 {
-	if (m_IsRotating) m_Angle += dt * m_RotateSpeed;
+	if (m_IsRotating)
+	{
+		m_Angle += dt * m_RotateSpeed;
+		const uint32_t instanceCount{ static_cast<uint32_t>(m_pScene->GetInstances().size()) };
+		for (uint32_t instance{}; instance < instanceCount; ++instance)
+			m_pScene->SetYaw(instance, m_Angle);
+	}
+
+	m_pAssetStreamer->Update();
+}
+
+std::vector<Mesh*> Elite::Renderer::GetMeshes() const
+{
+	// The placeholder gets its state even before the first vehicle is streamed, a mesh twice is harmless
+	std::vector<Mesh*> meshes{ m_pScene->GetMeshes() };
+	meshes.push_back(m_pAssetStreamer->GetPlaceholder());
+	return meshes;
+}
+
+void Elite::Renderer::SetMaterialMaps(const Mesh& mesh, const Material& material) const
+{
+	if (material.pDiffuseMap)
+		mesh.SetDiffuseMap(material.pDiffuseMap->GetResourceView());
+	if (material.pNormalMap)
+		mesh.SetNormalMap(material.pNormalMap->GetResourceView());
+	if (material.pSpecularMap)
+		mesh.SetSpecularMap(material.pSpecularMap->GetResourceView());
+	if (material.pGlossinessMap)
+		mesh.SetGlossinessMap(material.pGlossinessMap->GetResourceView());
+}
+
+void Elite::Renderer::StreamVehicle()
+{
+	// Lined up on both sides of the first vehicle
+	const float side{ m_StreamedVehicles.size() % 2 == 0 ? 1.f : -1.f };
+	const FVector3 position{ m_pVehicle->GetPosition() + FVector3{ side * 20.f * float(m_StreamedVehicles.size() / 2 + 1), 0.f, 0.f } };
+
+	std::cout << "Streaming vehicle " << m_StreamedVehicles.size() + 1 << "." << std::endl;
+	const uint32_t instance{ m_pScene->AddInstance(m_pAssetStreamer->GetPlaceholder(), m_VehicleMaterial, position, m_Angle) };
+	m_pScene->SetOccluder(instance, true);
+	m_StreamedVehicles.push_back(m_pAssetStreamer->LoadMeshAsync("Resources/vehicle.obj", position, false, [this, instance](Mesh& mesh)
+		{
+			mesh.SetTextureSamplingState(m_SampleMode);
+			mesh.SetCullMode(m_CullMode);
+			mesh.SetVertexFormat(m_pDevice.Get(), m_VertexFormat);
+			m_pScene->SetMesh(instance, &mesh);
+		}));
+}
+
+void Elite::Renderer::SpawnFleet()
+{
+	// Rows of 32 behind the first vehicle, each call adds 8 rows
+	constexpr uint32_t columns{ 32 };
+	constexpr uint32_t rows{ 8 };
+	constexpr float spacing{ 20.f };
+	for (uint32_t i{}; i < columns * rows; ++i, ++m_FleetSize)
+	{
+		const float column{ float(m_FleetSize % columns) - float(columns - 1) / 2.f };
+		const float row{ float(m_FleetSize / columns + 1) };
+		const FVector3 position{ m_pVehicle->GetPosition() + FVector3{ column * spacing, 0.f, row * spacing } };
+		m_pScene->SetOccluder(m_pScene->AddInstance(m_pVehicle.get(), m_VehicleMaterial, position, m_Angle), true);
+	}
+	std::cout << "Fleet of " << m_FleetSize << " vehicles." << std::endl;
 }
 
 void Elite::Renderer::SwitchSampleFilter()
@@ -144,8 +271,8 @@ void Elite::Renderer::SwitchSampleFilter()
 		break;
 	}
 
-	m_pVehicle->SetTextureSamplingState(m_SampleMode);
-	m_pFireFX->SetTextureSamplingState(m_SampleMode);
+	for (Mesh* pMesh : GetMeshes())
+		pMesh->SetTextureSamplingState(m_SampleMode);
 }
 
 void Elite::Renderer::SwitchCullMode()
@@ -171,8 +298,8 @@ void Elite::Renderer::SwitchCullMode()
 		break;
 	}
 
-	m_pVehicle->SetCullMode(m_CullMode);
-	m_pFireFX->SetCullMode(m_CullMode);
+	for (Mesh* pMesh : GetMeshes())
+		pMesh->SetCullMode(m_CullMode);
 }
 
 void Elite::Renderer::SwitchRenderMode()
@@ -195,6 +322,29 @@ void Elite::Renderer::SwitchRenderMode()
 	}
 }
 
+void Elite::Renderer::SwitchVertexFormat()
+{
+	m_VertexFormat = VertexFormat((int(m_VertexFormat) + 1) % int(VertexFormat::SIZE));
+
+	switch (m_VertexFormat)
+	{
+	case VertexFormat::full:
+		std::cout << "FULL vertices (" << sizeof(Vertex_Input) << " bytes)." << std::endl;
+		break;
+
+	case VertexFormat::packed:
+		std::cout << "PACKED vertices (" << sizeof(Vertex_Packed) << " bytes)." << std::endl;
+		break;
+
+	default:
+		std::cout << "Invalid VertexFormat" << std::endl;
+		break;
+	}
+
+	for (Mesh* pMesh : GetMeshes())
+		pMesh->SetVertexFormat(m_pDevice.Get(), m_VertexFormat);
+}
+
 void Elite::Renderer::ToggleRotating()
 {
 	m_IsRotating = !m_IsRotating;
@@ -207,12 +357,52 @@ void Elite::Renderer::ToggleRotating()
 void Elite::Renderer::ToggleFireFX()
 {
 	m_ShowFireFX = !m_ShowFireFX;
+	m_pScene->SetVisible(m_FireFXInstance, m_ShowFireFX);
 	if (m_ShowFireFX)
 		std::cout << "FireFX ENABLED.\n";
 	else
 		std::cout << "FireFX DISABLED.\n";
 }
 
+void Elite::Renderer::ToggleMeshletCulling()
+{
+	m_IsMeshletCulling = !m_IsMeshletCulling;
+	if (m_IsMeshletCulling)
+		std::cout << "Meshlet culling ENABLED.\n";
+	else
+		std::cout << "Meshlet culling DISABLED.\n";
+}
+
+void Elite::Renderer::ToggleOcclusionCulling()
+{
+	m_IsOcclusionCulling = !m_IsOcclusionCulling;
+	if (m_IsOcclusionCulling)
+		std::cout << "Occlusion culling ENABLED.\n";
+	else
+		std::cout << "Occlusion culling DISABLED.\n";
+}
+
+void Elite::Renderer::ToggleFastMath()
+{
+	m_IsFastMath = !m_IsFastMath;
+	if (m_IsFastMath)
+		std::cout << "Fast math ENABLED.\n";
+	else
+		std::cout << "Fast math DISABLED.\n";
+}
+
+void Elite::Renderer::PrintStatistics() const
+{
+	std::cout << "Render queue: " << m_pRenderQueue->GetWorldMatrices().size() << " instances in " << m_pRenderQueue->GetBatches().size()
+		<< " draws, " << m_pRenderQueue->GetCulledCount() << " culled, " << m_pRenderQueue->GetOccludedCount() << " occluded" << std::endl;
+
+	if (m_RasterMode != RasterMode::software || !m_IsMeshletCulling)
+		return;
+
+	std::cout << "Meshlets: " << m_DrawnMeshlets << " drawn, " << m_FrustumCulledMeshlets << " frustum culled, "
+		<< m_BackfaceCulledMeshlets << " backface culled" << std::endl;
+}
+
 void Elite::Renderer::InitializeDirectX()
 {
 	//Initialize DirectX pipeline
@@ -324,15 +514,68 @@ void Elite::Renderer::InitializeDirectX()
 	std::cout << "DirectX is ready!" << std::endl;
 }
 
-void Elite::Renderer::RenderTriangleMesh(Mesh* pMesh)
+void Elite::Renderer::RenderTriangleMesh(Mesh* pMesh, uint32_t lod)
 {
-	std::vector<Vertex_Input> vertices{ pMesh->GetVertexBuffer() };
-	const std::vector<uint32_t> indexes{ pMesh->GetIndexBuffer() };
-	for (size_t i{}; i < indexes.size() - 2; i += 3)
+	if (lod >= pMesh->GetLodCount())
+		return;
+
+	const std::span<const Meshlets::Meshlet> meshlets{ pMesh->GetMeshlets(lod) };
+	const uint32_t firstTriangle{ pMesh->GetLod(lod).indexOffset / 3 };
+	if (!m_IsMeshletCulling)
 	{
-		pMesh->SetTemplateVertices({ vertices[indexes[i]], vertices[indexes[i + 1]], vertices[indexes[i + 2]] });
-		RenderTriangle(pMesh->GetTriangle());
+		const uint32_t triangleCount{ pMesh->GetLod(lod).indexCount / 3 };
+		for (uint32_t triangle{}; triangle < triangleCount; ++triangle)
+			RenderTriangle(pMesh, firstTriangle + triangle);
+		m_DrawnMeshlets += static_cast<uint32_t>(meshlets.size());
+		return;
 	}
+
+	// The meshlet bounds are in mesh space, so bring the frustum and the camera there instead of transforming every meshlet
+	FVector4 frustumPlanes[6];
+	ExtractFrustumPlanes(m_WorldViewProjection, frustumPlanes);
+	const FPoint3 cameraPosition{ (Inverse(m_World) * FPoint4{ FPoint3{ m_pCamera->GetPosition() } }).xyz };
+
+	const std::vector<uint32_t>& meshletTriangles{ pMesh->GetMeshletTriangles() };
+	for (const Meshlets::Meshlet& meshlet : meshlets)
+	{
+		if (Meshlets::IsOutsideFrustum(meshlet, frustumPlanes))
+		{
+			++m_FrustumCulledMeshlets;
+			continue;
+		}
+
+		if (m_CullMode != CullMode::none && Meshlets::IsBackfacing(meshlet, cameraPosition, m_CullMode == CullMode::frontface))
+		{
+			++m_BackfaceCulledMeshlets;
+			continue;
+		}
+
+		++m_DrawnMeshlets;
+		for (uint32_t i{ meshlet.triangleOffset }; i < meshlet.triangleOffset + meshlet.triangleCount; ++i)
+			RenderTriangle(pMesh, firstTriangle + meshletTriangles[i]);
+	}
+}
+
+void Elite::Renderer::RenderTriangle(Mesh* pMesh, uint32_t triangle)
+{
+	const uint32_t* pIndices{ &pMesh->GetIndexBuffer()[size_t(triangle) * 3] };
+	if (pMesh->GetVertexFormat() == VertexFormat::packed)
+	{
+		// Vertex fetch decodes the packed vertices, a third of the bytes of the full ones
+		const std::span<const Vertex_Packed> vertices{ pMesh->GetPackedVertexBuffer() };
+		const FPoint3& boundsMin{ pMesh->GetBoundsMin() };
+		const FVector3 boundsExtent{ pMesh->GetBoundsMax() - boundsMin };
+		pMesh->SetTemplateVertices({
+			VertexPacking::Unpack(vertices[pIndices[0]], boundsMin, boundsExtent),
+			VertexPacking::Unpack(vertices[pIndices[1]], boundsMin, boundsExtent),
+			VertexPacking::Unpack(vertices[pIndices[2]], boundsMin, boundsExtent) });
+	}
+	else
+	{
+		const std::span<const Vertex_Input> vertices{ pMesh->GetVertexBuffer() };
+		pMesh->SetTemplateVertices({ vertices[pIndices[0]], vertices[pIndices[1]], vertices[pIndices[2]] });
+	}
+	RenderTriangle(pMesh->GetTriangle());
 }
 
 void Elite::Renderer::RenderTriangle(Triangle* pTriangle)
@@ -364,13 +607,37 @@ void Elite::Renderer::RenderTriangle(Triangle* pTriangle)
 	// w = maxY
 	IVector4 boundingBox{ GetBoundingBox(transformedVertices) };
 
+	// The approximations of EFastMath.h when fast math is on, the exact divides and square roots otherwise
+	const auto reciprocal{ [this](float value) { return m_IsFastMath ? FastReciprocal(value) : 1 / value; } };
+	const auto normalize{ [this](const FVector3& v) { return m_IsFastMath ? GetNormalizedFast(v) : GetNormalized(v); } };
+
+	// Per vertex, the same for every pixel. The depth and w interpolations took these same 1 / z and 1 / w per pixel.
+	const std::vector<Vertex_Input>& inputVertices{ pTriangle->GetColoredVertices() };
+	float inverseZ[3], vertexW[3], inverseW[3], inputW[3], inverseInputW[3];
+	for (int i = 0; i < 3; ++i)
+	{
+		inverseZ[i] = reciprocal(transformedVertices[i].Position.z);
+		vertexW[i] = transformedVertices[i].Position.w;
+		inverseW[i] = reciprocal(vertexW[i]);
+		inputW[i] = inputVertices[i].Position.w;
+		inverseInputW[i] = reciprocal(inputW[i]);
+	}
+
+	// Perspective correct attribute, a / w weighted by the barycentrics. The exact path divides like the pixel loop always did,
+	// only the fast path multiplies by the reciprocals (a * (1 / w) can differ from a / w in the last bit).
+	const auto interpolate{ [this](const auto& a0, const auto& a1, const auto& a2, const float* pW, const float* pInverseW,
+		float w0, float w1, float w2, float wInterpolated)
+	{
+		if (m_IsFastMath)
+			return (a0 * pInverseW[0] * w0 + a1 * pInverseW[1] * w1 + a2 * pInverseW[2] * w2) * wInterpolated;
+		return (a0 / pW[0] * w0 + a1 / pW[1] * w1 + a2 / pW[2] * w2) * wInterpolated;
+	} };
+
 	// Loop over all the pixels in the box
 	for (int r = boundingBox.z; r < boundingBox.w; ++r)
 	{
 		for (int c = boundingBox.x; c < boundingBox.y; ++c)
 		{
-			RGBColor color{ 0,0,0 };
-
 			FPoint2 pixelPos{ static_cast<float>(c) + 0.5f, static_cast<float>(r) + 0.5f }; // + 0.5f for center of pixel
 			FPoint2 v0{ transformedVertices[0].Position.xy };
 			FPoint2 v1{ transformedVertices[1].Position.xy };
@@ -385,39 +652,46 @@ void Elite::Renderer::RenderTriangle(Triangle* pTriangle)
 			if (IsPointInTriangle(w0, w1, w2))
 			{
 				float totalArea = w0 + w1 + w2;
-				w0 /= totalArea;
-				w1 /= totalArea;
-				w2 /= totalArea;
+				if (m_IsFastMath)
+				{
+					const float inverseArea{ FastReciprocal(totalArea) };
+					w0 *= inverseArea;
+					w1 *= inverseArea;
+					w2 *= inverseArea;
+				}
+				else
+				{
+					w0 /= totalArea;
+					w1 /= totalArea;
+					w2 /= totalArea;
+				}
 
-				float zDepth{ 1 / (1 / transformedVertices[0].Position.z * w0 + 1 / transformedVertices[1].Position.z * w1 + 1 / transformedVertices[2].Position.z * w2) };
-				float wInterpolated{ 1 / (1 / transformedVertices[0].Position.w * w0 + 1 / transformedVertices[1].Position.w * w1 + 1 / transformedVertices[2].Position.w * w2) };
+				float zDepth{ reciprocal(inverseZ[0] * w0 + inverseZ[1] * w1 + inverseZ[2] * w2) };
+				float wInterpolated{ reciprocal(inverseW[0] * w0 + inverseW[1] * w1 + inverseW[2] * w2) };
 
 				if (zDepth < m_DepthBuffer[c + r * m_Width])
 				{
 					m_DepthBuffer[c + r * m_Width] = zDepth;
 
 					// Pixel data interpolations
-					FVector2 interpolatedUV{ (transformedVertices[0].UV / transformedVertices[0].Position.w * w0 + transformedVertices[1].UV / transformedVertices[1].Position.w * w1 + transformedVertices[2].UV / transformedVertices[2].Position.w * w2) * wInterpolated };
-					FVector3 interpolatedNormal{ (transformedVertices[0].Normal / transformedVertices[0].Position.w * w0 + transformedVertices[1].Normal / transformedVertices[1].Position.w * w1 + transformedVertices[2].Normal / transformedVertices[2].Position.w * w2) * wInterpolated };
-					interpolatedNormal = GetNormalized(interpolatedNormal);
+					FVector2 interpolatedUV{ interpolate(transformedVertices[0].UV, transformedVertices[1].UV, transformedVertices[2].UV, vertexW, inverseW, w0, w1, w2, wInterpolated) };
+					FVector3 interpolatedNormal{ interpolate(transformedVertices[0].Normal, transformedVertices[1].Normal, transformedVertices[2].Normal, vertexW, inverseW, w0, w1, w2, wInterpolated) };
+					interpolatedNormal = normalize(interpolatedNormal);
 
-					FVector3 interpolatedTangent{ (transformedVertices[0].Tangent / transformedVertices[0].Position.w * w0 + transformedVertices[1].Tangent / transformedVertices[1].Position.w * w1 + transformedVertices[2].Tangent / transformedVertices[2].Position.w * w2) * wInterpolated };
-					interpolatedTangent = GetNormalized(interpolatedTangent);
+					FVector3 interpolatedTangent{ interpolate(transformedVertices[0].Tangent, transformedVertices[1].Tangent, transformedVertices[2].Tangent, vertexW, inverseW, w0, w1, w2, wInterpolated) };
+					interpolatedTangent = normalize(interpolatedTangent);
 
 					FMatrix3 tangentSpaceAxis{ interpolatedTangent, Cross(interpolatedNormal, interpolatedTangent), interpolatedNormal };
-					RGBColor normalSample{ m_pNormalMap->Sample(interpolatedUV) };
+					RGBColor normalSample{ m_pMaterial->pNormalMap->Sample(interpolatedUV) };
 					FVector3 trueNormal{ tangentSpaceAxis * FVector3{ 2 * normalSample.r - 1, 2 * normalSample.g - 1, 2 * normalSample.b - 1 } };
 
-					FVector3 interpolatedViewDirection{ (transformedVertices[0].viewDirection / pTriangle->GetColoredVertices()[0].Position.w * w0 + transformedVertices[1].viewDirection / pTriangle->GetColoredVertices()[1].Position.w * w1 + transformedVertices[2].viewDirection / pTriangle->GetColoredVertices()[2].Position.w * w2) * wInterpolated };
-					interpolatedViewDirection = GetNormalized(interpolatedViewDirection);
+					FVector3 interpolatedViewDirection{ interpolate(transformedVertices[0].viewDirection, transformedVertices[1].viewDirection, transformedVertices[2].viewDirection, inputW, inverseInputW, w0, w1, w2, wInterpolated) };
+					interpolatedViewDirection = normalize(interpolatedViewDirection);
 
-					color = PixelShader(m_pDiffuseMap->Sample(interpolatedUV), m_pSpecularMap->Sample(interpolatedUV), RGBColor{ 0.025f, 0.025f, 0.025f }, m_pGlossinessMap->Sample(interpolatedUV).r, trueNormal, interpolatedViewDirection);
+					const RGBColor4 color{ PixelShader(m_pMaterial->pDiffuseMap->Sample(interpolatedUV), m_pMaterial->pSpecularMap->Sample(interpolatedUV), RGBColor4{ 0.025f, 0.025f, 0.025f }, m_pMaterial->pGlossinessMap->Sample(interpolatedUV).r, trueNormal, interpolatedViewDirection) };
 
-					//Fill the pixels - pixel access demo
-					m_pBackBufferPixels[c + (r * m_Width)] = SDL_MapRGB(m_pBackBuffer->format,
-																		static_cast<uint8_t>(color.r * 255),
-																		static_cast<uint8_t>(color.g * 255),
-																		static_cast<uint8_t>(color.b * 255));
+					//The back buffer has the default 32 bit format (XRGB8888), the packed color goes in as is
+					m_pBackBufferPixels[c + (r * m_Width)] = GetSDL_ARGBColor(color);
 				}
 			}
 		}
@@ -429,35 +703,41 @@ void Elite::Renderer::VertexShader(const std::vector<Vertex_Input>& inputVertice
 {
 	//outputVertices = inputVertices;
 	outputVertices.resize(inputVertices.size());
+	// Cached by the instance, no matrix is composed per vertex
+	FMatrix4 world{ m_World };
+	FMatrix4 worldViewProjection{ m_WorldViewProjection };
+	const FVector3 cameraPosition{ m_pCamera->GetPosition() };
 	for (size_t i = 0; i < inputVertices.size(); i++)
 	{
-		auto rotMatrix{ Elite::MakeRotationY(m_Angle) };
-		outputVertices[i].Position = Elite::FPoint4(rotMatrix * inputVertices[i].Position.xyz + m_pVehicle->GetPosition()); // World transformation
-		outputVertices[i].Tangent = (rotMatrix * inputVertices[i].Tangent);
-		outputVertices[i].Normal = (rotMatrix * inputVertices[i].Normal);
+		const Elite::FPoint4 position{ inputVertices[i].Position.xyz };
+		outputVertices[i].Tangent = (world * Elite::FVector4(inputVertices[i].Tangent)).xyz;
+		outputVertices[i].Normal = (world * Elite::FVector4(inputVertices[i].Normal)).xyz;
 		outputVertices[i].UV = inputVertices[i].UV;
-		outputVertices[i].viewDirection = m_pCamera->GetPosition() - FVector3(outputVertices[i].Position.xyz);
+		outputVertices[i].viewDirection = cameraPosition - FVector3((world * position).xyz);
 
-		outputVertices[i].Position = m_pCamera->GetProjectionMatrix() * m_pCamera->GetWorldToView() * outputVertices[i].Position;
+		outputVertices[i].Position = worldViewProjection * position;
 		outputVertices[i].Position.x /= outputVertices[i].Position.w;
 		outputVertices[i].Position.y /= outputVertices[i].Position.w;
 		outputVertices[i].Position.z /= outputVertices[i].Position.w;
 	}
 }
 
-Elite::RGBColor Elite::Renderer::PixelShader(const Elite::RGBColor& diffuse, const Elite::RGBColor& specular, const Elite::RGBColor& ambient, float phongExponent, const Elite::FVector3& normal, const Elite::FVector3& viewDirection) const
+Elite::RGBColor4 Elite::Renderer::PixelShader(const Elite::RGBColor4& diffuse, const Elite::RGBColor4& specular, const Elite::RGBColor4& ambient, float phongExponent, const Elite::FVector3& normal, const Elite::FVector3& viewDirection) const
 {
+	// The light is fixed, everything that only depends on it is folded at compile time
 	constexpr float shininess{ 25.0f };
-	const FVector3 lightDirection = { 0.577f, -0.577f, 0.577f };
+	constexpr FVector3 lightDirection = { 0.577f, -0.577f, 0.577f };
 	constexpr float lightIntensity = 7.0f / static_cast<float>(E_PI);
-	const Elite::RGBColor lightColor = { 1.0f, 1.0f, 1.0f };
+	constexpr Elite::RGBColor lightColor = { 1.0f, 1.0f, 1.0f };
+	constexpr Elite::RGBColor lightRadiance{ lightColor * lightIntensity };
 
-	Elite::RGBColor finalColor = diffuse * (lightColor * lightIntensity * std::max(Elite::Dot(-normal, lightDirection), 0.0f)) + ambient;
+	// One register per color, the diffuse and specular terms are each a single multiply-add
+	Elite::RGBColor4 finalColor = MultiplyAdd(diffuse, RGBColor4{ lightRadiance } * std::max(Elite::Dot(-normal, lightDirection), 0.0f), ambient);
 
 	const float dotProduct = Elite::Dot(lightDirection - (2 * Elite::Dot(normal, lightDirection) * normal), viewDirection);
 
 	if (dotProduct > 0)
-		finalColor += specular * std::powf(dotProduct, phongExponent * shininess);
+		finalColor = MultiplyAdd(specular, m_IsFastMath ? FastPow(dotProduct, phongExponent * shininess) : std::powf(dotProduct, phongExponent * shininess), finalColor);
 
 	finalColor.MaxToOne();
 
@@ -21,6 +21,15 @@ class Geometry;
 class Triangle;
 class Mesh;
 class Texture;
+class ThreadPool;
+class AssetRegistry;
+class AssetStreamer;
+class MeshHandle;
+class Scene;
+class RenderQueue;
+class InstanceBuffer;
+class OcclusionBuffer;
+struct Material;
 
 namespace Elite
 {
@@ -41,8 +50,20 @@ namespace Elite
 		void SwitchSampleFilter();
 		void SwitchCullMode();
 		void SwitchRenderMode();
+		void SwitchVertexFormat();
 		void ToggleRotating();
 		void ToggleFireFX();
+		// Culls whole meshlets against the frustum and their normal cone before the vertex shader (software only)
+		void ToggleMeshletCulling();
+		// Skips the instances hidden behind the nearest vehicles, tested on the CPU before they are drawn (DirectX only)
+		void ToggleOcclusionCulling();
+		// Approximate reciprocals, normalizes and specular power in the pixel loop, to compare against the exact image (software only)
+		void ToggleFastMath();
+		void PrintStatistics() const;
+		// Streams in another vehicle next to the existing ones without blocking the frame loop
+		void StreamVehicle();
+		// Adds a block of instances of the vehicle behind it, they share its mesh and draw in one call per level of detail
+		void SpawnFleet();
 
 	private:
 		SDL_Window* m_pWindow;
@@ -72,29 +93,58 @@ namespace Elite
 
 		SampleMode m_SampleMode = SampleMode::point;
 		CullMode m_CullMode = CullMode::backface;
+		VertexFormat m_VertexFormat = VertexFormat::packed;
+
+		unique_ptr<ThreadPool> m_pThreadPool;
+		unique_ptr<AssetRegistry> m_pAssetRegistry;
+		unique_ptr<AssetStreamer> m_pAssetStreamer;
+		// Keep the streamed meshes alive, the scene only points at them
+		std::vector<std::shared_ptr<MeshHandle>> m_StreamedVehicles;
 
 		// Meshes
 		//Vehicle
-		unique_ptr<Mesh> m_pVehicle;
-		unique_ptr<Texture> m_pDiffuseMap;
-		unique_ptr<Texture> m_pNormalMap;
-		unique_ptr<Texture> m_pSpecularMap;
-		unique_ptr<Texture> m_pGlossinessMap;
+		std::shared_ptr<Mesh> m_pVehicle;
+		uint32_t m_VehicleMaterial;
+		uint32_t m_FleetSize;
 		//FireFX
 		bool m_ShowFireFX;
-		unique_ptr<Mesh> m_pFireFX;
-		unique_ptr<Texture> m_pFireFXDiffuse;
+		std::shared_ptr<Mesh> m_pFireFX;
+		uint32_t m_FireFXInstance;
+
+		// Rebuilt every frame from the scene, both rasterizers draw from it
+		unique_ptr<Scene> m_pScene;
+		unique_ptr<RenderQueue> m_pRenderQueue;
+		unique_ptr<InstanceBuffer> m_pInstanceBuffer;
+		unique_ptr<OcclusionBuffer> m_pOcclusionBuffer;
+		bool m_IsOcclusionCulling;
 
 		// Sampling
 		RasterMode m_RasterMode = RasterMode::hardware;
 
+		// Meshlets of the last software frame
+		bool m_IsMeshletCulling;
+		uint32_t m_DrawnMeshlets;
+		uint32_t m_FrustumCulledMeshlets;
+		uint32_t m_BackfaceCulledMeshlets;
+
+		// EFastMath.h in the software pixel loop
+		bool m_IsFastMath;
+
+		// Instance the software rasterizer is drawing
+		FMatrix4 m_World;
+		FMatrix4 m_WorldViewProjection;
+		const Material* m_pMaterial;
+
 		// Member Functions
 		void InitializeDirectX();
-		void RenderTriangleMesh(Mesh* pMesh);
+		void RenderTriangleMesh(Mesh* pMesh, uint32_t lod);
+		void RenderTriangle(Mesh* pMesh, uint32_t triangle);
+		[[nodiscard]] std::vector<Mesh*> GetMeshes() const;
+		void SetMaterialMaps(const Mesh& mesh, const Material& material) const;
 		void ResetDepthBuffer() const;
 		void RenderTriangle(Triangle* pTriangle);
 		void VertexShader(const std::vector<Vertex_Input>& inputVertices, std::vector<Vertex_Input>& outputVertices) const;
-		Elite::RGBColor PixelShader(const RGBColor& diffuse, const RGBColor& specular, const RGBColor& ambient, float phongExponent, const FVector3& normal, const FVector3& viewDirection) const;
+		Elite::RGBColor4 PixelShader(const RGBColor4& diffuse, const RGBColor4& specular, const RGBColor4& ambient, float phongExponent, const FVector3& normal, const FVector3& viewDirection) const;
 		Elite::IVector4 GetBoundingBox(const std::vector<Vertex_Input>& vertices) const;
 		bool IsPointInTriangle(float w0, float w1, float w2) const;
 	};
@@ -33,7 +33,7 @@ namespace Elite
 	};
 
 	template<int N, typename T>
-	inline T SqrMagnitude(const Vector<N, T>& v)
+	constexpr T SqrMagnitude(const Vector<N, T>& v)
 	{ return Dot(v, v); }
 
 	//Euclidean Norm (expect definition of Euclidean Inner Product - Dot Product)
@@ -76,7 +76,7 @@ namespace Elite
 
 	//Returns the reflect vector d around n
 	template<int N, typename T>
-	inline Vector<N, T> Reflect(const Vector<N, T>& d, const Vector<N, T>& n)
+	constexpr Vector<N, T> Reflect(const Vector<N, T>& d, const Vector<N, T>& n)
 	{ return d - static_cast<T>(2)* Dot(d, n) * n; }
 
 	//Returns angle from v1 to v2 in radians
@@ -89,7 +89,7 @@ namespace Elite
 	{ return asin((Dot(Cross(axis, v1), v2)) / (Magnitude(v1)*Magnitude(v2))); }
 
 	template<int N, typename T>
-	inline Vector<N, T> Lerp(float t, const Vector<N, T>& v1, const Vector<N, T>& v2)
+	constexpr Vector<N, T> Lerp(float t, const Vector<N, T>& v1, const Vector<N, T>& v2)
 	{ return v2 + ((v2 - v1) * static_cast<T>(t)); }
 }
 #endif
\ No newline at end of file
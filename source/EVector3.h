@@ -21,8 +21,9 @@ namespace Elite
 #pragma warning(disable : 4201)
 		union
 		{
-			T data[3];
+			//First, so a value initialized one starts with the member constant expressions read
 			struct { T x, y, z; };
+			T data[3];
 			struct { T r, g, b; };
 			Vector<2, T> xy;
 			Vector<2, T> rg;
@@ -32,17 +33,17 @@ namespace Elite
 		//=== Constructors ===
 #pragma region Constructors
 		Vector<3, T>() = default;
-		Vector<3, T>(T _x, T _y, T _z = 0)
+		constexpr Vector<3, T>(T _x, T _y, T _z = 0)
 			: x(_x), y(_y), z(_z) {}
-		Vector<3, T>(const Vector<3, T>& v)
+		constexpr Vector<3, T>(const Vector<3, T>& v)
 			: x(v.x), y(v.y), z(v.z) {}
-		Vector<3, T>(const Vector<2, T>& v, T _z = 0)
+		constexpr Vector<3, T>(const Vector<2, T>& v, T _z = 0)
 			: x(v.x), y(v.y), z(_z) {}
-		Vector<3, T>(Vector<3, T>&& v) noexcept
+		constexpr Vector<3, T>(Vector<3, T>&& v) noexcept
 			:x(std::move(v.x)), y(std::move(v.y)), z(std::move(v.z)) {}
-		explicit Vector<3, T>(const Point<3, T>& p)
+		constexpr explicit Vector<3, T>(const Point<3, T>& p)
 			: x(p.x), y(p.y), z(p.z) {}
-		explicit Vector<3, T>(const Vector<4, T>& v)
+		constexpr explicit Vector<3, T>(const Vector<4, T>& v)
 			: x(v.x), y(v.y), z(v.z) {}
 #pragma endregion
 
@@ -61,17 +62,17 @@ namespace Elite
 		//=== Arithmetic Operators ===
 #pragma region ArithmeticOperators
 		template<typename U>
-		inline Vector<3, T> operator+(const Vector<3, U>& v) const
+		constexpr Vector<3, T> operator+(const Vector<3, U>& v) const
 		{ return Vector<3, T>(x + static_cast<T>(v.x), y + static_cast<T>(v.y), z + static_cast<T>(v.z)); }
 
 		template<typename U>
-		inline Vector<3, T> operator-(const Vector<3, U>& v) const
+		constexpr Vector<3, T> operator-(const Vector<3, U>& v) const
 		{ return Vector<3, T>(x - static_cast<T>(v.x), y - static_cast<T>(v.y), z - static_cast<T>(v.z)); }
 
-		inline Vector<3, T> operator*(T scale) const
+		constexpr Vector<3, T> operator*(T scale) const
 		{ return Vector<3, T>(x * scale, y * scale, z * scale);	}
 
-		inline Vector<3, T> operator/(T scale) const
+		constexpr Vector<3, T> operator/(T scale) const
 		{
 			const T revS = static_cast<T>(1.0f / scale);
 			return Vector<3, T>(x * revS, y * revS, z * revS);
@@ -80,19 +81,19 @@ namespace Elite
 
 		//=== Compound Assignment Operators ===
 #pragma region CompoundAssignmentOperators
-		inline Vector<3, T>& operator=(const Vector<3, T>& v)
+		constexpr Vector<3, T>& operator=(const Vector<3, T>& v)
 		{ x = v.x; y = v.y; z = v.z; return *this; }
 
-		inline Vector<3, T>& operator+=(const Vector<3, T>& v)
+		constexpr Vector<3, T>& operator+=(const Vector<3, T>& v)
 		{ x += v.x; y += v.y; z += v.z; return *this; }
 
-		inline Vector<3, T>& operator-=(const Vector<3, T>& v)
+		constexpr Vector<3, T>& operator-=(const Vector<3, T>& v)
 		{ x -= v.x; y -= v.y; z -= v.z; return *this; }
 
-		inline Vector<3, T>& operator*=(T scale)
+		constexpr Vector<3, T>& operator*=(T scale)
 		{ x *= scale; y *= scale; z *= scale; return *this; }
 
-		inline Vector<3, T>& operator/=(T scale)
+		constexpr Vector<3, T>& operator/=(T scale)
 		{
 			const T revS = static_cast<T>(1.0f / scale);
 			x *= revS; y *= revS; z *= revS; return *this;
@@ -101,7 +102,7 @@ namespace Elite
 
 		//=== Unary Operators ===
 #pragma region UnaryOperators
-		inline Vector<3, T> operator-() const
+		constexpr Vector<3, T> operator-() const
 		{ return Vector<3, T>(-x, -y, -z); }
 #pragma endregion
 
@@ -130,13 +131,13 @@ namespace Elite
 #pragma endregion
 
 		//=== Static Functions ===
-		static Vector<3, T> ZeroVector();
+		static constexpr Vector<3, T> ZeroVector();
 	};
 
 	//--- VECTOR3 FUNCTIONS ---
 #pragma region GlobalOperators
 	template<typename T, typename U>
-	inline Vector<3, T> operator*(U scale, const Vector<3, T>& v)
+	constexpr Vector<3, T> operator*(U scale, const Vector<3, T>& v)
 	{ 
 		T s = static_cast<T>(scale);
 		return Vector<3, T>(v.x * s, v.y * s, v.z * s); 
@@ -145,18 +146,18 @@ namespace Elite
 
 #pragma region GlobalFunctions
 	template<typename T>
-	inline Vector<3, T> Vector<3, T>::ZeroVector()
+	constexpr Vector<3, T> Vector<3, T>::ZeroVector()
 	{ 
 		T z = static_cast<T>(0);
 		return Vector<3, T>(z, z, z); 
 	}
 
 	template<typename T>
-	inline T Dot(const Vector<3, T>& v1, const Vector<3, T>& v2)
+	constexpr T Dot(const Vector<3, T>& v1, const Vector<3, T>& v2)
 	{ return v1.x * v2.x + v1.y * v2.y + v1.z * v2.z; }
 
 	template<typename T>
-	inline Vector<3, T> Cross(const Vector<3, T>& v1, const Vector<3, T>& v2)
+	constexpr Vector<3, T> Cross(const Vector<3, T>& v1, const Vector<3, T>& v2)
 	{
 		return Vector<3, T>{
 			v1.y * v2.z - v1.z * v2.y,
@@ -169,7 +170,7 @@ namespace Elite
 	{ return Vector<3, T>(abs(v.x), abs(v.y), abs(v.z)); }
 
 	template<typename T>
-	inline Vector<3, T> Max(const Vector<3, T>& v1, const Vector<3, T>& v2)
+	constexpr Vector<3, T> Max(const Vector<3, T>& v1, const Vector<3, T>& v2)
 	{
 		Vector<3, T>v = v1;
 		if (v2.x > v.x) v.x = v2.x;
@@ -179,7 +180,7 @@ namespace Elite
 	}
 
 	template<typename T>
-	inline Vector<3, T> Min(const Vector<3, T>& v1, const Vector<3, T>& v2)
+	constexpr Vector<3, T> Min(const Vector<3, T>& v1, const Vector<3, T>& v2)
 	{
 		Vector<3, T>v = v1;
 		if (v2.x < v.x) v.x = v2.x;
@@ -21,8 +21,9 @@ namespace Elite
 #pragma warning(disable : 4201)
 		union
 		{
-			T data[4];
+			//First, so a value initialized one starts with the member constant expressions read
 			struct { T x, y, z, w; };
+			T data[4];
 			struct { T r, g, b, a; };
 			Vector<2, T> xy;
 			Vector<3, T> xyz;
@@ -34,17 +35,17 @@ namespace Elite
 		//=== Constructors ===
 #pragma region Constructors
 		Vector<4, T>() = default;
-		Vector<4, T>(T _x, T _y, T _z, T _w = 0) //W component of Vector is usually 0
+		constexpr Vector<4, T>(T _x, T _y, T _z, T _w = 0) //W component of Vector is usually 0
 			: x(_x), y(_y), z(_z), w(_w) {}
-		Vector<4, T>(const Vector<2, T> v, T _z, T _w = 0)
+		constexpr Vector<4, T>(const Vector<2, T> v, T _z, T _w = 0)
 			: x(v.x), y(v.y), z(_z), w(_w) {}
-		Vector<4, T>(const Vector<3, T> v, T _w = 0)
+		constexpr Vector<4, T>(const Vector<3, T> v, T _w = 0)
 			: x(v.x), y(v.y), z(v.z), w(_w) {}
-		Vector<4, T>(const Vector<4, T>& v)
+		constexpr Vector<4, T>(const Vector<4, T>& v)
 			: x(v.x), y(v.y), z(v.z), w(v.w) {}
-		Vector<4, T>(Vector<4, T>&& v) noexcept
+		constexpr Vector<4, T>(Vector<4, T>&& v) noexcept
 			:x(std::move(v.x)), y(std::move(v.y)), z(std::move(v.z)), w(std::move(v.w)) {}
-		explicit Vector<4, T>(const Point<4, T>& p)
+		constexpr explicit Vector<4, T>(const Point<4, T>& p)
 			: x(p.x), y(p.y), z(p.z), w(p.w) {}
 #pragma endregion
 
@@ -64,19 +65,19 @@ namespace Elite
 		//=== Arithmetic Operators ===
 #pragma region ArithmeticOperators
 		template<typename U>
-		inline Vector<4, T> operator+(const Vector<4, U>& v) const
+		constexpr Vector<4, T> operator+(const Vector<4, U>& v) const
 		{ return Vector<4, T>(x + static_cast<T>(v.x), y + static_cast<T>(v.y), 
 			z + static_cast<T>(v.z), w + static_cast<T>(v.w)); }
 
 		template<typename U>
-		inline Vector<4, T> operator-(const Vector<4, U>& v) const
+		constexpr Vector<4, T> operator-(const Vector<4, U>& v) const
 		{ return Vector<4, T>(x - static_cast<T>(v.x), y - static_cast<T>(v.y),
 			z - static_cast<T>(v.z), w - static_cast<T>(v.w)); }
 
-		inline Vector<4, T> operator*(T scale) const
+		constexpr Vector<4, T> operator*(T scale) const
 		{ return Vector<4, T>(x * scale, y * scale, z * scale, w * scale); }
 
-		inline Vector<4, T> operator/(T scale) const
+		constexpr Vector<4, T> operator/(T scale) const
 		{
 			const T revS = static_cast<T>(1.0f / scale);
 			return Vector<4, T>(x * revS, y * revS, z * revS, w * revS);
@@ -85,19 +86,19 @@ namespace Elite
 
 		//=== Compound Assignment Operators ===
 #pragma region CompoundAssignmentOperators
-		inline Vector<4, T>& operator=(const Vector<4, T>& v)
+		constexpr Vector<4, T>& operator=(const Vector<4, T>& v)
 		{ x = v.x; y = v.y; z = v.z; w = v.w; return *this;	}
 
-		inline Vector<4, T>& operator+=(const Vector<4, T>& v)
+		constexpr Vector<4, T>& operator+=(const Vector<4, T>& v)
 		{ x += v.x; y += v.y; z += v.z; w += v.w; return *this;	}
 
-		inline Vector<4, T>& operator-=(const Vector<4, T>& v)
+		constexpr Vector<4, T>& operator-=(const Vector<4, T>& v)
 		{ x -= v.x; y -= v.y; z -= v.z; w -= v.w; return *this; }
 
-		inline Vector<4, T>& operator*=(T scale)
+		constexpr Vector<4, T>& operator*=(T scale)
 		{ x *= scale; y *= scale; z *= scale; w *= scale; return *this;	}
 
-		inline Vector<4, T>& operator/=(T scale)
+		constexpr Vector<4, T>& operator/=(T scale)
 		{
 			const T revS = static_cast<T>(1.0f / scale);
 			x *= revS; y *= revS; z *= revS; w *= revS; return *this;
@@ -106,7 +107,7 @@ namespace Elite
 
 		//=== Unary Operators ===
 #pragma region UnaryOperators
-		inline Vector<4, T> operator-() const
+		constexpr Vector<4, T> operator-() const
 		{ return Vector<4, T>(-x, -y, -z, -w); }
 #pragma endregion
 
@@ -135,13 +136,13 @@ namespace Elite
 #pragma endregion
 
 		//=== Static Functions ===
-		static Vector<4, T> ZeroVector();
+		static constexpr Vector<4, T> ZeroVector();
 	};
 
 	//--- VECTOR4 FUNCTIONS ---
 #pragma region GlobalOperators
 	template<typename T, typename U>
-	inline Vector<4, T> operator*(U scale, const Vector<4, T>& v)
+	constexpr Vector<4, T> operator*(U scale, const Vector<4, T>& v)
 	{ 
 		T s = static_cast<T>(scale);
 		return Vector<4, T>(v.x * s, v.y * s, v.z * s, v.w * s); 
@@ -150,14 +151,14 @@ namespace Elite
 
 #pragma region GlobalFunctions
 	template<typename T>
-	inline Vector<4, T> Vector<4, T>::ZeroVector()
+	constexpr Vector<4, T> Vector<4, T>::ZeroVector()
 	{
 		T z = static_cast<T>(0);
 		return Vector<4, T>(z, z, z, z);
 	}
 
 	template<typename T>
-	inline T Dot(const Vector<4, T>& v1, const Vector<4, T>& v2)
+	constexpr T Dot(const Vector<4, T>& v1, const Vector<4, T>& v2)
 	{
 		return v1.x * v2.x + v1.y * v2.y + v1.z * v2.z + v1.w * v2.w;
 	}
@@ -167,7 +168,7 @@ namespace Elite
 	{ return Vector<4, T>(abs(v.x), abs(v.y), abs(v.z), abs(v.w)); }
 
 	template<typename T>
-	inline Vector<4, T> Max(const Vector<4, T>& v1, const Vector<4, T>& v2)
+	constexpr Vector<4, T> Max(const Vector<4, T>& v1, const Vector<4, T>& v2)
 	{
 		Vector<4, T>v = v1;
 		if (v2.x > v.x) v.x = v2.x;
@@ -178,7 +179,7 @@ namespace Elite
 	}
 
 	template<typename T>
-	inline Vector<4, T> Min(const Vector<4, T>& v1, const Vector<4, T>& v2)
+	constexpr Vector<4, T> Min(const Vector<4, T>& v1, const Vector<4, T>& v2)
 	{
 		Vector<4, T>v = v1;
 		if (v2.x < v.x) v.x = v2.x;
@@ -8,6 +8,9 @@ EffectPartialCoverage::EffectPartialCoverage(ID3D11Device* pDevice, const std::w
 	m_pPointTechnique = m_pEffect->GetTechniqueByName("PointTechnique");
 	m_pLinearTechnique = m_pEffect->GetTechniqueByName("LinearTechnique");
 	m_pAnisotropicTechnique = m_pEffect->GetTechniqueByName("AnisotropicTechnique");
+	m_pPointPackedTechnique = m_pEffect->GetTechniqueByName("PointPackedTechnique");
+	m_pLinearPackedTechnique = m_pEffect->GetTechniqueByName("LinearPackedTechnique");
+	m_pAnisotropicPackedTechnique = m_pEffect->GetTechniqueByName("AnisotropicPackedTechnique");
 
 	if (!m_pPointTechnique->IsValid())
 		std::wcout << L"Point Technique not valid\n";
@@ -18,6 +21,15 @@ EffectPartialCoverage::EffectPartialCoverage(ID3D11Device* pDevice, const std::w
 	if (!m_pAnisotropicTechnique->IsValid())
 		std::wcout << L"Anisotropic Technique not valid\n";
 
+	if (!m_pPointPackedTechnique->IsValid())
+		std::wcout << L"Point Packed Technique not valid\n";
+
+	if (!m_pLinearPackedTechnique->IsValid())
+		std::wcout << L"Linear Packed Technique not valid\n";
+
+	if (!m_pAnisotropicPackedTechnique->IsValid())
+		std::wcout << L"Anisotropic Packed Technique not valid\n";
+
 	m_pActiveTechnique = m_pPointTechnique;
 }
 
@@ -26,22 +38,28 @@ EffectPartialCoverage::~EffectPartialCoverage()
 	m_pPointTechnique->Release();
 	m_pLinearTechnique->Release();
 	m_pAnisotropicTechnique->Release();
+	m_pPointPackedTechnique->Release();
+	m_pLinearPackedTechnique->Release();
+	m_pAnisotropicPackedTechnique->Release();
 }
 
 void EffectPartialCoverage::SetTechnique(SampleMode renderTechnique)
 {
+	m_SampleMode = renderTechnique;
+	const bool isPacked{ m_VertexFormat == VertexFormat::packed };
+
 	switch (renderTechnique)
 	{
 	case SampleMode::point:
-		m_pActiveTechnique = m_pPointTechnique;
+		m_pActiveTechnique = isPacked ? m_pPointPackedTechnique : m_pPointTechnique;
 		break;
 
 	case SampleMode::linear:
-		m_pActiveTechnique = m_pLinearTechnique;
+		m_pActiveTechnique = isPacked ? m_pLinearPackedTechnique : m_pLinearTechnique;
 		break;
 
 	case SampleMode::anisotropic:
-		m_pActiveTechnique = m_pAnisotropicTechnique;
+		m_pActiveTechnique = isPacked ? m_pAnisotropicPackedTechnique : m_pAnisotropicTechnique;
 		break;
 
 	default:
@@ -20,4 +20,7 @@ private:
 	ID3DX11EffectTechnique* m_pPointTechnique;
 	ID3DX11EffectTechnique* m_pLinearTechnique;
 	ID3DX11EffectTechnique* m_pAnisotropicTechnique;
+	ID3DX11EffectTechnique* m_pPointPackedTechnique;
+	ID3DX11EffectTechnique* m_pLinearPackedTechnique;
+	ID3DX11EffectTechnique* m_pAnisotropicPackedTechnique;
 };
@@ -0,0 +1,19 @@
+#include "pch.h"
+#include "Hash.h"
+#include <fstream>
+
+bool Hash::HashFile(const std::string& filePath, uint64_t& hash)
+{
+	std::ifstream file{ filePath, std::ios::binary };
+	if (!file.is_open())
+		return false;
+
+	hash = FnvOffsetBasis;
+	char buffer[64 * 1024];
+	while (file)
+	{
+		file.read(buffer, sizeof(buffer));
+		hash = Fnv1a(buffer, static_cast<size_t>(file.gcount()), hash);
+	}
+	return true;
+}
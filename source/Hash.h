@@ -0,0 +1,32 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+// 64 bit FNV-1a, used to key assets and cached files by content
+namespace Hash
+{
+	constexpr uint64_t FnvOffsetBasis{ 14695981039346656037ull };
+	constexpr uint64_t FnvPrime{ 1099511628211ull };
+
+	[[nodiscard]] inline uint64_t Fnv1a(const void* pData, size_t size, uint64_t hash = FnvOffsetBasis)
+	{
+		const uint8_t* pBytes{ static_cast<const uint8_t*>(pData) };
+		for (size_t i{}; i < size; ++i)
+		{
+			hash ^= pBytes[i];
+			hash *= FnvPrime;
+		}
+		return hash;
+	}
+
+	// Folds the bytes of a trivially copyable value into an existing hash
+	template<typename T>
+	[[nodiscard]] uint64_t Combine(uint64_t hash, const T& value)
+	{
+		return Fnv1a(&value, sizeof(T), hash);
+	}
+
+	// Hashes the whole file, returns false when it can't be opened
+	[[nodiscard]] bool HashFile(const std::string& filePath, uint64_t& hash);
+}
+
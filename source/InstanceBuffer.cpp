@@ -0,0 +1,66 @@
+#include "pch.h"
+#include "InstanceBuffer.h"
+#include <cstring>
+
+bool InstanceBuffer::Upload(ID3D11Device* pDevice, ID3D11DeviceContext* pDeviceContext, std::span<const Elite::FMatrix4> worldMatrices)
+{
+	if (worldMatrices.empty())
+		return true;
+
+	if (worldMatrices.size() > m_Capacity)
+	{
+		uint32_t capacity{ std::max(m_Capacity, m_MinCapacity) };
+		while (capacity < worldMatrices.size())
+			capacity *= 2;
+		if (!Create(pDevice, capacity))
+			return false;
+	}
+
+	// The matrices go in as they are, the shader reads them row_major to get the same layout SetMatrix uploads
+	D3D11_MAPPED_SUBRESOURCE mapped{};
+	const HRESULT result = pDeviceContext->Map(m_pBuffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped);
+	if (FAILED(result))
+	{
+		std::cout << "Error when mapping InstanceBuffer!" << std::endl;
+		return false;
+	}
+	std::memcpy(mapped.pData, worldMatrices.data(), worldMatrices.size_bytes());
+	pDeviceContext->Unmap(m_pBuffer.Get(), 0);
+	return true;
+}
+
+bool InstanceBuffer::Create(ID3D11Device* pDevice, uint32_t capacity)
+{
+	m_pResourceView.Reset();
+	m_pBuffer.Reset();
+	m_Capacity = 0;
+
+	D3D11_BUFFER_DESC bd{};
+	bd.Usage = D3D11_USAGE_DYNAMIC;
+	bd.ByteWidth = sizeof(Elite::FMatrix4) * capacity;
+	bd.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+	bd.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	bd.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
+	bd.StructureByteStride = sizeof(Elite::FMatrix4);
+	HRESULT result = pDevice->CreateBuffer(&bd, nullptr, &m_pBuffer);
+	if (FAILED(result))
+	{
+		std::cout << "Error when creating InstanceBuffer!" << std::endl;
+		return false;
+	}
+
+	D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc{};
+	srvDesc.Format = DXGI_FORMAT_UNKNOWN;
+	srvDesc.ViewDimension = D3D11_SRV_DIMENSION_BUFFER;
+	srvDesc.Buffer.FirstElement = 0;
+	srvDesc.Buffer.NumElements = capacity;
+	result = pDevice->CreateShaderResourceView(m_pBuffer.Get(), &srvDesc, &m_pResourceView);
+	if (FAILED(result))
+	{
+		std::cout << "Error when creating InstanceBuffer view!" << std::endl;
+		return false;
+	}
+
+	m_Capacity = capacity;
+	return true;
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <span>
+#include "structs.h"
+
+// World matrices of the queued instances, read by the vertex shaders as a StructuredBuffer indexed by the instance id.
+// Written once per frame, every batch reads its own range. Grows to the largest frame and never shrinks.
+class InstanceBuffer final
+{
+public:
+	InstanceBuffer() = default;
+	~InstanceBuffer() = default;
+
+	InstanceBuffer(const InstanceBuffer&) = delete;
+	InstanceBuffer(InstanceBuffer&&) noexcept = delete;
+	InstanceBuffer& operator=(const InstanceBuffer&) = delete;
+	InstanceBuffer& operator=(InstanceBuffer&&) noexcept = delete;
+
+	[[nodiscard]] bool Upload(ID3D11Device* pDevice, ID3D11DeviceContext* pDeviceContext, std::span<const Elite::FMatrix4> worldMatrices);
+
+	[[nodiscard]] ID3D11ShaderResourceView* GetResourceView() const { return m_pResourceView.Get(); }
+
+private:
+	static constexpr uint32_t m_MinCapacity{ 256 };
+
+	ComPtr<ID3D11Buffer> m_pBuffer;
+	ComPtr<ID3D11ShaderResourceView> m_pResourceView;
+	uint32_t m_Capacity{};
+
+	[[nodiscard]] bool Create(ID3D11Device* pDevice, uint32_t capacity);
+};
@@ -0,0 +1,46 @@
+#include "pch.h"
+#include "MappedFile.h"
+
+MappedFile::MappedFile(const std::string& filePath)
+	: m_File{ INVALID_HANDLE_VALUE }
+	, m_Mapping{ nullptr }
+	, m_pData{ nullptr }
+	, m_Size{}
+{
+	m_File = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (m_File == INVALID_HANDLE_VALUE)
+		return;
+
+	LARGE_INTEGER fileSize{};
+	if (!GetFileSizeEx(m_File, &fileSize) || fileSize.QuadPart == 0)
+	{
+		std::cout << "Error mapping empty file " << filePath << std::endl;
+		return;
+	}
+
+	m_Mapping = CreateFileMappingA(m_File, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!m_Mapping)
+	{
+		std::cout << "Error creating file mapping for " << filePath << std::endl;
+		return;
+	}
+
+	m_pData = static_cast<const uint8_t*>(MapViewOfFile(m_Mapping, FILE_MAP_READ, 0, 0, 0));
+	if (!m_pData)
+	{
+		std::cout << "Error mapping view of " << filePath << std::endl;
+		return;
+	}
+
+	m_Size = static_cast<size_t>(fileSize.QuadPart);
+}
+
+MappedFile::~MappedFile()
+{
+	if (m_pData)
+		UnmapViewOfFile(m_pData);
+	if (m_Mapping)
+		CloseHandle(m_Mapping);
+	if (m_File != INVALID_HANDLE_VALUE)
+		CloseHandle(m_File);
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include <string>
+
+// Read only view of a whole file, the pages are loaded by the OS on first access
+class MappedFile final
+{
+public:
+	explicit MappedFile(const std::string& filePath);
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile(MappedFile&&) noexcept = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+	MappedFile& operator=(MappedFile&&) noexcept = delete;
+
+	[[nodiscard]] bool IsValid() const { return m_pData != nullptr; }
+	[[nodiscard]] const uint8_t* GetData() const { return m_pData; }
+	[[nodiscard]] size_t GetSize() const { return m_Size; }
+
+private:
+	HANDLE m_File;
+	HANDLE m_Mapping;
+	const uint8_t* m_pData;
+	size_t m_Size;
+};
+
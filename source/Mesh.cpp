@@ -1,26 +1,225 @@
 #include "pch.h"
 #include "Mesh.h" 
 #include "EObjParser.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "MeshFile.h"
+#include "MappedFile.h"
+#include "Meshlets.h"
+#include "VertexPacking.h"
 
 Mesh::Mesh(ID3D11Device* pDevice, const std::string& filePath, const Elite::FVector3& position, bool isTransparent)
+	: Mesh{ filePath, position, isTransparent }
+{
+	Upload(pDevice);
+}
+
+Mesh::Mesh(const std::string& filePath, const Elite::FVector3& position, bool isTransparent, ThreadPool* pThreadPool)
+	: m_Position{ position }
+	, m_IsTransparent{ isTransparent }
+	, m_IsLoaded{}
+	, m_SourceHash{}
+	, m_AmountIndices{}
+	, m_pTriangle{ make_unique<Triangle>(Elite::FPoint3(position)) }
+	, m_BoundsMin{}
+	, m_BoundsMax{}
+{
+	if (!LoadCache(filePath) && !LoadOBJ(filePath, position, pThreadPool))
+		return;
+	m_IsLoaded = true;
+
+	VertexPacking::Pack(m_Vertices, m_BoundsMin, m_BoundsMax, m_PackedVertices);
+	BuildMeshlets();
+}
+
+Mesh::Mesh(std::vector<Vertex_Input> vertices, std::vector<uint32_t> indices, const Elite::FVector3& position, bool isTransparent)
 	: m_Position{ position }
+	, m_IsTransparent{ isTransparent }
+	, m_IsLoaded{ true }
+	, m_SourceHash{}
 	, m_AmountIndices{}
 	, m_pTriangle{ make_unique<Triangle>(Elite::FPoint3(position)) }
+	, m_SWIndexBuffer{ std::move(indices) }
+	, m_SWVertexBuffer{ std::move(vertices) }
+	, m_BoundsMin{}
+	, m_BoundsMax{}
 {
-	
-	if (!ParseOBJ(filePath, position, m_SWVertexBuffer, m_SWIndexBuffer))
+	m_Vertices = m_SWVertexBuffer;
+	ComputeBounds();
+	BuildLods();
+
+	VertexPacking::Pack(m_Vertices, m_BoundsMin, m_BoundsMax, m_PackedVertices);
+	BuildMeshlets();
+}
+
+Mesh::~Mesh() = default;
+
+bool Mesh::LoadCache(const std::string& filePath)
+{
+	auto pMappedFile{ make_unique<MappedFile>(MeshFile::GetCachePath(filePath)) };
+	if (!pMappedFile->IsValid())
+		return false;
+
+	const MeshFile::Header* pHeader;
+	if (!MeshFile::Parse(pMappedFile->GetData(), pMappedFile->GetSize(), filePath, pHeader))
+		return false;
+
+	m_Vertices = { reinterpret_cast<const Vertex_Input*>(pMappedFile->GetData() + pHeader->vertexOffset), pHeader->vertexCount };
+	m_Indices = { reinterpret_cast<const uint32_t*>(pMappedFile->GetData() + pHeader->indexOffset), pHeader->indexCount };
+	m_BoundsMin = Elite::FPoint3{ pHeader->boundsMin[0], pHeader->boundsMin[1], pHeader->boundsMin[2] };
+	m_BoundsMax = Elite::FPoint3{ pHeader->boundsMax[0], pHeader->boundsMax[1], pHeader->boundsMax[2] };
+	m_Lods.assign(pHeader->lods, pHeader->lods + pHeader->lodCount);
+	m_SourceHash = pHeader->sourceHash;
+
+	m_pMappedFile = std::move(pMappedFile);
+	return true;
+}
+
+bool Mesh::LoadOBJ(const std::string& filePath, const Elite::FVector3& position, ThreadPool* pThreadPool)
+{
+	if (!ParseOBJ(filePath, position, m_SWVertexBuffer, m_SWIndexBuffer, pThreadPool, 0, &m_SourceHash))
 	{
 		std::cout << "Parsing error with file " << filePath << std::endl;
+		return false;
+	}
+
+	MeshOptimizer::Optimize(m_SWVertexBuffer, m_SWIndexBuffer);
+
+	m_Vertices = m_SWVertexBuffer;
+	ComputeBounds();
+	BuildLods();
+
+	if (!MeshFile::Write(filePath, m_SourceHash, m_Vertices, m_Indices, m_Lods, m_BoundsMin, m_BoundsMax))
+		std::cout << "Error writing mesh cache for " << filePath << std::endl;
+	return true;
+}
+
+void Mesh::ComputeBounds()
+{
+	if (m_Vertices.empty())
 		return;
+
+	m_BoundsMin = m_Vertices[0].Position.xyz;
+	m_BoundsMax = m_Vertices[0].Position.xyz;
+	for (const Vertex_Input& vertex : m_Vertices)
+	{
+		for (uint8_t axis{}; axis < 3; ++axis)
+		{
+			m_BoundsMin[axis] = std::min(m_BoundsMin[axis], vertex.Position[axis]);
+			m_BoundsMax[axis] = std::max(m_BoundsMax[axis], vertex.Position[axis]);
+		}
+	}
+}
+
+void Mesh::BuildLods()
+{
+	const float maxError{ Elite::Magnitude(m_BoundsMax - m_BoundsMin) * m_LodMaxError };
+	MeshSimplifier::BuildLods(m_Vertices, m_SWIndexBuffer, MeshFile::MaxLods, maxError, m_Lods);
+	m_Indices = m_SWIndexBuffer;
+}
+
+void Mesh::BuildMeshlets()
+{
+	m_LodMeshletOffsets.assign(1, 0);
+	for (const MeshLod& lod : m_Lods)
+	{
+		Meshlets::Build(m_Vertices, m_Indices.subspan(lod.indexOffset, lod.indexCount), m_Meshlets, m_MeshletTriangles);
+		m_LodMeshletOffsets.push_back(static_cast<uint32_t>(m_Meshlets.size()));
 	}
+}
+
+uint32_t Mesh::SelectLod(float screenSize, uint32_t currentLod) const
+{
+	const uint32_t lodCount{ GetLodCount() };
+	uint32_t lod{ std::min(currentLod, lodCount > 0 ? lodCount - 1 : 0) };
+	while (lod + 1 < lodCount && screenSize < m_LodScreenSizes[lod] * (1.f - m_LodHysteresis))
+		++lod;
+	while (lod > 0 && screenSize > m_LodScreenSizes[lod - 1] * (1.f + m_LodHysteresis))
+		--lod;
+	return lod;
+}
+
+std::span<const Meshlets::Meshlet> Mesh::GetMeshlets(uint32_t lod) const
+{
+	return std::span<const Meshlets::Meshlet>{ m_Meshlets }.subspan(m_LodMeshletOffsets[lod], m_LodMeshletOffsets[lod + 1] - m_LodMeshletOffsets[lod]);
+}
+
+void Mesh::Upload(ID3D11Device* pDevice)
+{
+	if (!m_IsLoaded)
+		return;
 
-	if (!isTransparent)
+	if (!m_IsTransparent)
 		m_pEffect = make_unique<Effect>(pDevice, L"Resources/PosCol3D.fx");
 	else 
 		m_pEffect = make_unique<EffectPartialCoverage>(pDevice, L"Resources/FireFX.fx");
 
-	//Create Vertex Layout
-	HRESULT result = S_OK;
+	if (!CreateInputLayouts(pDevice) || !CreateVertexBuffer(pDevice))
+		return;
+
+	//Create index buffer
+	D3D11_BUFFER_DESC bd{};
+	D3D11_SUBRESOURCE_DATA initData{};
+	m_AmountIndices = static_cast<uint32_t>(m_Indices.size());
+	bd.Usage = D3D11_USAGE_IMMUTABLE;
+	bd.ByteWidth = sizeof(uint32_t) * m_AmountIndices;
+	bd.BindFlags = D3D11_BIND_INDEX_BUFFER;
+	bd.CPUAccessFlags = 0;
+	bd.MiscFlags = 0;
+	initData.pSysMem = m_Indices.data();
+	HRESULT result = pDevice->CreateBuffer(&bd, &initData, &m_pIndexBuffer);
+	if (FAILED(result))
+	{
+		std::cout << "Error when creating IndexBuffer!" << std::endl;
+		return;
+	}
+
+	m_pMatViewProjVariable = m_pEffect->GetVariableByName("gViewProj")->AsMatrix();
+	if (!m_pMatViewProjVariable->IsValid())
+		std::cout << "m_pMatViewProjVariable not valid.\n";
+
+	m_pMatViewInverseVariable = m_pEffect->GetVariableByName("gViewInverseMatrix")->AsMatrix();
+	if (!m_pMatViewInverseVariable->IsValid())
+		std::cout << "m_pMatViewInverseVariable not valid.\n";
+
+	m_pInstanceWorldsVariable = m_pEffect->GetVariableByName("gInstanceWorlds")->AsShaderResource();
+	if (!m_pInstanceWorldsVariable->IsValid())
+		std::cout << "m_pInstanceWorldsVariable not valid.\n";
+
+	m_pInstanceOffsetVariable = m_pEffect->GetVariableByName("gInstanceOffset")->AsScalar();
+	if (!m_pInstanceOffsetVariable->IsValid())
+		std::cout << "m_pInstanceOffsetVariable not valid.\n";
+
+	m_pDiffuseMapVariable = m_pEffect->GetVariableByName("gDiffuseMap")->AsShaderResource();
+	if (!m_pDiffuseMapVariable->IsValid())
+		std::cout << "m_pDiffuseMapVariable not valid.\n";
+
+	m_pNormalMapVariable = m_pEffect->GetVariableByName("gNormalMap")->AsShaderResource();
+	if (!m_pNormalMapVariable->IsValid())
+		std::cout << "m_pNormalMapVariable not valid.\n";
+
+	m_pSpecularMapVariable = m_pEffect->GetVariableByName("gSpecularMap")->AsShaderResource();
+	if (!m_pSpecularMapVariable->IsValid())
+		std::cout << "m_pSpecularMapVariable not valid.\n";
+
+	m_pGlossinessMapVariable = m_pEffect->GetVariableByName("gGlossinessMap")->AsShaderResource();
+	if (!m_pGlossinessMapVariable->IsValid())
+		std::cout << "m_pGlossinessMapVariable not valid.\n";
+
+	// Only read by VS_PACKED, the bounds never change after loading. SetFloatVector always reads 4 floats.
+	const Elite::FVector3 extent{ m_BoundsMax - m_BoundsMin };
+	const float boundsMin[4]{ m_BoundsMin.x, m_BoundsMin.y, m_BoundsMin.z, 0.0f };
+	const float boundsExtent[4]{ extent.x, extent.y, extent.z, 0.0f };
+	ID3DX11EffectVectorVariable* pBoundsMinVariable{ m_pEffect->GetVariableByName("gBoundsMin")->AsVector() };
+	ID3DX11EffectVectorVariable* pBoundsExtentVariable{ m_pEffect->GetVariableByName("gBoundsExtent")->AsVector() };
+	if (!pBoundsMinVariable->IsValid() || !pBoundsExtentVariable->IsValid())
+		std::cout << "Bounds variables not valid.\n";
+	pBoundsMinVariable->SetFloatVector(boundsMin);
+	pBoundsExtentVariable->SetFloatVector(boundsExtent);
+}
+
+bool Mesh::CreateInputLayouts(ID3D11Device* pDevice)
+{
 	static constexpr uint32_t numElements{ 5 };
 	D3D11_INPUT_ELEMENT_DESC vertexDesc[numElements]{};
 
@@ -54,10 +253,11 @@ Mesh::Mesh(ID3D11Device* pDevice, const std::string& filePath, const Elite::FVec
 	vertexDesc[4].AlignedByteOffset = 48;
 	vertexDesc[4].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
 
-	//Create input layout
+	// The input signature comes from the active technique, all techniques of one format share the vertex shader
 	D3DX11_PASS_DESC passDesc{};
+	m_pEffect->SetVertexFormat(VertexFormat::full);
 	m_pEffect->GetTechnique()->GetPassByIndex(0)->GetDesc(&passDesc);
-	result = pDevice->CreateInputLayout(
+	HRESULT result = pDevice->CreateInputLayout(
 		vertexDesc,
 		numElements,
 		passDesc.pIAInputSignature,
@@ -67,73 +267,83 @@ Mesh::Mesh(ID3D11Device* pDevice, const std::string& filePath, const Elite::FVec
 	if (FAILED(result)) 
 	{
 		std::cout << "Error when creating InputLayout!" << std::endl;
-		return;
+		return false;
 	}
 
-	//Create vertex buffer
+	// Packed layout, see Vertex_Packed
+	static constexpr uint32_t numPackedElements{ 4 };
+	D3D11_INPUT_ELEMENT_DESC packedVertexDesc[numPackedElements]{};
+
+	packedVertexDesc[0].SemanticName = "POSITION";
+	packedVertexDesc[0].Format = DXGI_FORMAT_R16G16B16A16_UNORM;
+	packedVertexDesc[0].AlignedByteOffset = 0;
+	packedVertexDesc[0].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+
+	packedVertexDesc[1].SemanticName = "TEXCOORD";
+	packedVertexDesc[1].Format = DXGI_FORMAT_R16G16_FLOAT;
+	packedVertexDesc[1].AlignedByteOffset = 8;
+	packedVertexDesc[1].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+
+	packedVertexDesc[2].SemanticName = "NORMAL";
+	packedVertexDesc[2].Format = DXGI_FORMAT_R16G16_SNORM;
+	packedVertexDesc[2].AlignedByteOffset = 12;
+	packedVertexDesc[2].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+
+	packedVertexDesc[3].SemanticName = "TANGENT";
+	packedVertexDesc[3].Format = DXGI_FORMAT_R16G16_SNORM;
+	packedVertexDesc[3].AlignedByteOffset = 16;
+	packedVertexDesc[3].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+
+	m_pEffect->SetVertexFormat(VertexFormat::packed);
+	m_pEffect->GetTechnique()->GetPassByIndex(0)->GetDesc(&passDesc);
+	result = pDevice->CreateInputLayout(
+		packedVertexDesc,
+		numPackedElements,
+		passDesc.pIAInputSignature,
+		passDesc.IAInputSignatureSize,
+		&m_pPackedVertexLayout);
+
+	m_pEffect->SetVertexFormat(m_VertexFormat);
+	if (FAILED(result))
+	{
+		std::cout << "Error when creating packed InputLayout!" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+bool Mesh::CreateVertexBuffer(ID3D11Device* pDevice)
+{
+	const bool isPacked{ m_VertexFormat == VertexFormat::packed };
+
 	D3D11_BUFFER_DESC bd{};
 	bd.Usage = D3D11_USAGE_IMMUTABLE;
-	bd.ByteWidth = sizeof(Vertex_Input) * static_cast<uint32_t>(m_SWVertexBuffer.size());
+	bd.ByteWidth = static_cast<uint32_t>(isPacked ? m_PackedVertices.size() * sizeof(Vertex_Packed) : m_Vertices.size_bytes());
 	bd.BindFlags = D3D11_BIND_VERTEX_BUFFER;
 	bd.CPUAccessFlags = 0;
 	bd.MiscFlags = 0;
 	D3D11_SUBRESOURCE_DATA initData{};
-	initData.pSysMem = m_SWVertexBuffer.data();
-	result = pDevice->CreateBuffer(&bd, &initData, &m_pVertexBuffer);
+	initData.pSysMem = isPacked ? static_cast<const void*>(m_PackedVertices.data()) : m_Vertices.data();
+
+	m_pVertexBuffer.Reset();
+	HRESULT result = pDevice->CreateBuffer(&bd, &initData, &m_pVertexBuffer);
 	if (FAILED(result))
 	{
 		std::cout << "Error when creating VertexBuffer!" << std::endl;
-		return;
+		return false;
 	}
+	return true;
+}
 
-	//Create index buffer
-	m_AmountIndices = static_cast<uint32_t>(m_SWIndexBuffer.size());
-	bd.Usage = D3D11_USAGE_IMMUTABLE;
-	bd.ByteWidth = sizeof(uint32_t) * m_AmountIndices;
-	bd.BindFlags = D3D11_BIND_INDEX_BUFFER;
-	bd.CPUAccessFlags = 0;
-	bd.MiscFlags = 0;
-	initData.pSysMem = m_SWIndexBuffer.data();
-	result = pDevice->CreateBuffer(&bd, &initData, &m_pIndexBuffer);
-	if (FAILED(result))
-	{
-		std::cout << "Error when creating IndexBuffer!" << std::endl;
+void Mesh::Render(ID3D11DeviceContext* pDeviceContext, uint32_t lod, uint32_t firstInstance, uint32_t instanceCount)
+{
+	if (!m_pEffect || lod >= m_Lods.size() || instanceCount == 0)
 		return;
-	}
-
-	m_pMatWorldViewProjVariable = m_pEffect->GetVariableByName("gWorldViewProj")->AsMatrix();
-	if (!m_pMatWorldViewProjVariable->IsValid())
-		std::cout << "m_pMatWorldViewProjVariable not valid.\n";
-
-	m_pMatWorldVariable = m_pEffect->GetVariableByName("gWorldMatrix")->AsMatrix();
-	if (!m_pMatWorldVariable->IsValid())
-		std::cout << "m_pMatWorldVariable not valid.\n";
-
-	m_pMatViewInverseVariable = m_pEffect->GetVariableByName("gViewInverseMatrix")->AsMatrix();
-	if (!m_pMatViewInverseVariable->IsValid())
-		std::cout << "m_pMatViewInverseVariable not valid.\n";
-
-	m_pDiffuseMapVariable = m_pEffect->GetVariableByName("gDiffuseMap")->AsShaderResource();
-	if (!m_pDiffuseMapVariable->IsValid())
-		std::cout << "m_pDiffuseMapVariable not valid.\n";
-
-	m_pNormalMapVariable = m_pEffect->GetVariableByName("gNormalMap")->AsShaderResource();
-	if (!m_pNormalMapVariable->IsValid())
-		std::cout << "m_pNormalMapVariable not valid.\n";
 
-	m_pSpecularMapVariable = m_pEffect->GetVariableByName("gSpecularMap")->AsShaderResource();
-	if (!m_pSpecularMapVariable->IsValid())
-		std::cout << "m_pSpecularMapVariable not valid.\n";
-
-	m_pGlossinessMapVariable = m_pEffect->GetVariableByName("gGlossinessMap")->AsShaderResource();
-	if (!m_pGlossinessMapVariable->IsValid())
-		std::cout << "m_pGlossinessMapVariable not valid.\n";
-}
+	const bool isPacked{ m_VertexFormat == VertexFormat::packed };
 
-void Mesh::Render(ID3D11DeviceContext* pDeviceContext)
-{
 	//Set vertex buffer
-	constexpr UINT stride = sizeof(Vertex_Input);
+	const UINT stride = isPacked ? sizeof(Vertex_Packed) : sizeof(Vertex_Input);
 	constexpr UINT offset = 0;
 	pDeviceContext->IASetVertexBuffers(0, 1, m_pVertexBuffer.GetAddressOf(), &stride, &offset);
 
@@ -141,33 +351,47 @@ void Mesh::Render(ID3D11DeviceContext* pDeviceContext)
 	pDeviceContext->IASetIndexBuffer(m_pIndexBuffer.Get(), DXGI_FORMAT_R32_UINT, 0);
 
 	//Set the input layout
-	pDeviceContext->IASetInputLayout(m_pVertexLayout.Get());
+	pDeviceContext->IASetInputLayout(isPacked ? m_pPackedVertexLayout.Get() : m_pVertexLayout.Get());
 
 	//Set primitive topology
 	pDeviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
-	//Render a triangle
+	//Render the instances, SV_InstanceID starts at 0 whatever the start instance so the offset goes in a constant
+	m_pInstanceOffsetVariable->SetInt(static_cast<int>(firstInstance));
 	m_pEffect->GetTechnique()->GetPassByIndex(static_cast<int>(m_CullMode))->Apply(0, pDeviceContext);
-	pDeviceContext->DrawIndexed(m_AmountIndices, 0, 0);
+	pDeviceContext->DrawIndexedInstanced(m_Lods[lod].indexCount, instanceCount, m_Lods[lod].indexOffset, 0, 0);
 }
 
-void Mesh::SetWorldViewMatrix(const float* pData) const
+void Mesh::SetViewProjectionMatrix(const float* pData) const
 {
-	m_pMatWorldViewProjVariable->SetMatrix(pData);
-}
+	// Not uploaded, the mesh failed to load
+	if (!m_pEffect)
+		return;
 
-void Mesh::SetWorldMatrix(const float* pData) const
-{
-	m_pMatWorldVariable->SetMatrix(pData);
+	m_pMatViewProjVariable->SetMatrix(pData);
 }
 
 void Mesh::SetViewInverseMatrix(const float* pData) const
 {
+	if (!m_pEffect)
+		return;
+
 	m_pMatViewInverseVariable->SetMatrix(pData);
 }
 
+void Mesh::SetInstanceBuffer(ID3D11ShaderResourceView* pResourceView) const
+{
+	if (!m_pEffect)
+		return;
+
+	m_pInstanceWorldsVariable->SetResource(pResourceView);
+}
+
 void Mesh::SetDiffuseMap(ID3D11ShaderResourceView* pResourceView) const
 {
+	if (!m_pEffect)
+		return;
+
 	if (m_pDiffuseMapVariable->IsValid())
 		m_pDiffuseMapVariable->SetResource(pResourceView);
 	else std::cout << "Invalid DiffuseMap." << std::endl;
@@ -175,6 +399,9 @@ void Mesh::SetDiffuseMap(ID3D11ShaderResourceView* pResourceView) const
 
 void Mesh::SetNormalMap(ID3D11ShaderResourceView* pResourceView) const
 {
+	if (!m_pEffect)
+		return;
+
 	if (m_pNormalMapVariable->IsValid())
 		m_pNormalMapVariable->SetResource(pResourceView);
 	else std::cout << "Invalid NormalMap." << std::endl;
@@ -182,6 +409,9 @@ void Mesh::SetNormalMap(ID3D11ShaderResourceView* pResourceView) const
 
 void Mesh::SetSpecularMap(ID3D11ShaderResourceView* pResourceView) const
 {
+	if (!m_pEffect)
+		return;
+
 	if (m_pSpecularMapVariable->IsValid())
 		m_pSpecularMapVariable->SetResource(pResourceView);
 	else std::cout << "Invalid SpecularMap." << std::endl;
@@ -189,6 +419,9 @@ void Mesh::SetSpecularMap(ID3D11ShaderResourceView* pResourceView) const
 
 void Mesh::SetGlossinessMap(ID3D11ShaderResourceView* pResourceView) const
 {
+	if (!m_pEffect)
+		return;
+
 	if (m_pGlossinessMapVariable->IsValid())
 		m_pGlossinessMapVariable->SetResource(pResourceView);
 	else std::cout << "Invalid GlosinessMap." << std::endl;
@@ -196,6 +429,9 @@ void Mesh::SetGlossinessMap(ID3D11ShaderResourceView* pResourceView) const
 
 void Mesh::SetTextureSamplingState(SampleMode renderTechnique) const
 {
+	if (!m_pEffect)
+		return;
+
 	m_pEffect->SetTechnique(renderTechnique);
 }
 
@@ -204,14 +440,33 @@ void Mesh::SetCullMode(CullMode cullMode)
 	m_CullMode = cullMode;
 }
 
-const std::vector<uint32_t>& Mesh::GetIndexBuffer() const
+void Mesh::SetVertexFormat(ID3D11Device* pDevice, VertexFormat vertexFormat)
+{
+	if (vertexFormat == m_VertexFormat)
+		return;
+
+	m_VertexFormat = vertexFormat;
+	if (!m_pEffect)
+		return;
+
+	m_pEffect->SetVertexFormat(vertexFormat);
+	if (m_pVertexBuffer && !CreateVertexBuffer(pDevice))
+		std::cout << "Error switching the vertex format" << std::endl;
+}
+
+std::span<const uint32_t> Mesh::GetIndexBuffer() const
+{
+	return m_Indices;
+}
+
+std::span<const Vertex_Input> Mesh::GetVertexBuffer() const
 {
-	return m_SWIndexBuffer;
+	return m_Vertices;
 }
 
-const std::vector<Vertex_Input>& Mesh::GetVertexBuffer() const
+std::span<const Vertex_Packed> Mesh::GetPackedVertexBuffer() const
 {
-	return m_SWVertexBuffer;
+	return m_PackedVertices;
 }
 
 Triangle* Mesh::GetTriangle() const
@@ -219,6 +474,20 @@ Triangle* Mesh::GetTriangle() const
 	return m_pTriangle.get();
 }
 
+size_t Mesh::GetCPUBytes() const
+{
+	return m_Vertices.size_bytes() + m_PackedVertices.size() * sizeof(Vertex_Packed) + m_Indices.size_bytes() + m_Meshlets.size() * sizeof(Meshlets::Meshlet)
+		+ m_MeshletTriangles.size() * sizeof(uint32_t) + m_LodMeshletOffsets.size() * sizeof(uint32_t);
+}
+
+size_t Mesh::GetGPUBytes() const
+{
+	if (!m_pVertexBuffer || !m_pIndexBuffer)
+		return 0;
+	const size_t vertexBytes{ m_VertexFormat == VertexFormat::packed ? m_PackedVertices.size() * sizeof(Vertex_Packed) : m_Vertices.size_bytes() };
+	return vertexBytes + size_t(m_AmountIndices) * sizeof(uint32_t);
+}
+
 void Mesh::SetTemplateVertices(const std::vector<Vertex_Input>& vertices) const
 {
 	m_pTriangle->SetLocalVertices(vertices);
@@ -1,32 +1,53 @@
 #pragma once
 #include "pch.h"
+#include <span>
 #include <vector>
 #include "EMath.h"
 
 #include "Effect.h"
 #include "EffectPartialCoverage.h"
 
+#include "Meshlets.h"
 #include "structs.h"
 #include "Triangle.h"
 
+class MappedFile;
+class ThreadPool;
+
 class Mesh final
 {
 public:
+	// Parses the mesh on the CPU only, call Upload on the device thread to create the effect and GPU buffers.
+	// A valid .emesh cache next to the OBJ is mapped instead, the first parse writes it.
+	// The OBJ is parsed on pThreadPool when given, also from one of its own jobs.
+	Mesh(const std::string& filePath, const Elite::FVector3& position, bool isTransparent = false, ThreadPool* pThreadPool = nullptr);
 	Mesh(ID3D11Device* pDevice, const std::string& filePath, const Elite::FVector3& position, bool isTransparent = false);
-	~Mesh() = default;
+	// Generated geometry, the vertices need their tangents already
+	Mesh(std::vector<Vertex_Input> vertices, std::vector<uint32_t> indices, const Elite::FVector3& position, bool isTransparent = false);
+	~Mesh();
 
 	Mesh(const Mesh&) = delete;
 	Mesh(Mesh&&) noexcept = delete;
 	Mesh& operator=(const Mesh&) = delete;
 	Mesh& operator=(Mesh&&) noexcept = delete;
 
+	// Does nothing when the mesh failed to load
+	void Upload(ID3D11Device* pDevice);
+
+	// False when neither the cache nor the OBJ could be parsed, the mesh is empty then
+	[[nodiscard]] bool IsLoaded() const { return m_IsLoaded; }
+	// Hash::Fnv1a of the OBJ the mesh comes from, taken while parsing or stored in the cache
+	[[nodiscard]] uint64_t GetSourceHash() const { return m_SourceHash; }
+	// Position passed at load, a mesh shared through the AssetRegistry keeps the one of its first load.
+	// Instances carry their own position.
 	[[nodiscard]] const Elite::FVector3& GetPosition() const { return m_Position; }
 
-	void Render(ID3D11DeviceContext* pDeviceContext);
+	// Instanced draw, the world matrices are [firstInstance, firstInstance + instanceCount) of the instance buffer
+	void Render(ID3D11DeviceContext* pDeviceContext, uint32_t lod, uint32_t firstInstance, uint32_t instanceCount);
 
-	void SetWorldViewMatrix(const float* pData) const;
-	void SetWorldMatrix(const float* pData) const;
+	void SetViewProjectionMatrix(const float* pData) const;
 	void SetViewInverseMatrix(const float* pData) const;
+	void SetInstanceBuffer(ID3D11ShaderResourceView* pResourceView) const;
 
 	void SetDiffuseMap(ID3D11ShaderResourceView* pResourceView) const;
 	void SetNormalMap(ID3D11ShaderResourceView* pResourceView) const;
@@ -35,33 +56,87 @@ public:
 	void SetTextureSamplingState(SampleMode renderTechnique) const;
 
 	void SetCullMode(CullMode cullMode);
-
-	[[nodiscard]] const std::vector<uint32_t>& GetIndexBuffer() const;
-	[[nodiscard]] const std::vector<Vertex_Input>& GetVertexBuffer() const;
+	// Recreates the GPU vertex buffer in the new format when the mesh is already uploaded
+	void SetVertexFormat(ID3D11Device* pDevice, VertexFormat vertexFormat);
+	[[nodiscard]] VertexFormat GetVertexFormat() const { return m_VertexFormat; }
+
+	[[nodiscard]] std::span<const uint32_t> GetIndexBuffer() const;
+	[[nodiscard]] std::span<const Vertex_Input> GetVertexBuffer() const;
+	[[nodiscard]] std::span<const Vertex_Packed> GetPackedVertexBuffer() const;
+	[[nodiscard]] const Elite::FPoint3& GetBoundsMin() const { return m_BoundsMin; }
+	[[nodiscard]] const Elite::FPoint3& GetBoundsMax() const { return m_BoundsMax; }
+	[[nodiscard]] uint32_t GetLodCount() const { return static_cast<uint32_t>(m_Lods.size()); }
+	[[nodiscard]] const MeshLod& GetLod(uint32_t lod) const { return m_Lods[lod]; }
+	// screenSize is the projected radius of the bounding sphere as a fraction of half the screen height.
+	// Levels switch a bit past their threshold, so a mesh sitting right on one doesn't flip every frame.
+	[[nodiscard]] uint32_t SelectLod(float screenSize, uint32_t currentLod) const;
+	[[nodiscard]] std::span<const Meshlets::Meshlet> GetMeshlets(uint32_t lod) const;
+	// Triangle numbers counted from the first triangle of the level
+	[[nodiscard]] const std::vector<uint32_t>& GetMeshletTriangles() const { return m_MeshletTriangles; }
 	[[nodiscard]] Triangle* GetTriangle() const;
+	[[nodiscard]] size_t GetCPUBytes() const;
+	[[nodiscard]] size_t GetGPUBytes() const;
 	void SetTemplateVertices(const std::vector<Vertex_Input>& localVertices) const;
 
 private:
+	// Screen size below which the next coarser level is used, every level has about half the triangles of the one before
+	static constexpr float m_LodScreenSizes[]{ 0.25f, 0.125f, 0.0625f };
+	static constexpr float m_LodHysteresis{ 0.1f };
+	// Largest surface deviation a level may add, relative to the size of the mesh
+	static constexpr float m_LodMaxError{ 0.05f };
+
 	Elite::FVector3 m_Position;
+	bool m_IsTransparent;
+	bool m_IsLoaded;
+	uint64_t m_SourceHash;
 
 	unique_ptr<BaseEffect> m_pEffect;
 	ComPtr<ID3D11InputLayout> m_pVertexLayout;
+	ComPtr<ID3D11InputLayout> m_pPackedVertexLayout;
 	ComPtr<ID3D11Buffer> m_pVertexBuffer;
 	ComPtr<ID3D11Buffer> m_pIndexBuffer;
 	uint32_t m_AmountIndices;
 
-	ComPtr<ID3DX11EffectMatrixVariable> m_pMatWorldViewProjVariable;
-	ComPtr<ID3DX11EffectMatrixVariable> m_pMatWorldVariable;
+	ComPtr<ID3DX11EffectMatrixVariable> m_pMatViewProjVariable;
 	ComPtr<ID3DX11EffectMatrixVariable> m_pMatViewInverseVariable;
+	ComPtr<ID3DX11EffectShaderResourceVariable> m_pInstanceWorldsVariable;
+	ComPtr<ID3DX11EffectScalarVariable> m_pInstanceOffsetVariable;
 	ComPtr<ID3DX11EffectShaderResourceVariable> m_pDiffuseMapVariable;
 	ComPtr<ID3DX11EffectShaderResourceVariable> m_pNormalMapVariable;
 	ComPtr<ID3DX11EffectShaderResourceVariable> m_pSpecularMapVariable;
 	ComPtr<ID3DX11EffectShaderResourceVariable> m_pGlossinessMapVariable;
 
 	CullMode m_CullMode = CullMode::backface;
+	VertexFormat m_VertexFormat = VertexFormat::packed;
 
 	unique_ptr<Triangle> m_pTriangle;
 	std::vector<uint32_t> m_SWIndexBuffer;
 	std::vector<Vertex_Input> m_SWVertexBuffer;
+
+	// Point either into the vectors above or into the mapped cache
+	unique_ptr<MappedFile> m_pMappedFile;
+	std::span<const uint32_t> m_Indices;
+	std::span<const Vertex_Input> m_Vertices;
+	Elite::FPoint3 m_BoundsMin;
+	Elite::FPoint3 m_BoundsMax;
+
+	// Always built at load, both the software rasterizer and the GPU read whichever format is active
+	std::vector<Vertex_Packed> m_PackedVertices;
+	// Levels of detail, ranges of m_Indices
+	std::vector<MeshLod> m_Lods;
+
+	// Culled as a whole by the software rasterizer, the GPU still draws a level in one go.
+	// The meshlets of level i are [m_LodMeshletOffsets[i], m_LodMeshletOffsets[i + 1]).
+	std::vector<Meshlets::Meshlet> m_Meshlets;
+	std::vector<uint32_t> m_MeshletTriangles;
+	std::vector<uint32_t> m_LodMeshletOffsets;
+
+	[[nodiscard]] bool LoadCache(const std::string& filePath);
+	[[nodiscard]] bool LoadOBJ(const std::string& filePath, const Elite::FVector3& position, ThreadPool* pThreadPool);
+	[[nodiscard]] bool CreateInputLayouts(ID3D11Device* pDevice);
+	[[nodiscard]] bool CreateVertexBuffer(ID3D11Device* pDevice);
+	void ComputeBounds();
+	void BuildLods();
+	void BuildMeshlets();
 };
 
@@ -0,0 +1,114 @@
+#include "pch.h"
+#include "MeshFile.h"
+#include <filesystem>
+#include <fstream>
+#include "Hash.h"
+
+namespace
+{
+	bool GetSourceStamp(const std::string& sourcePath, uint64_t& size, int64_t& writeTime)
+	{
+		std::error_code error;
+		size = std::filesystem::file_size(sourcePath, error);
+		if (error)
+			return false;
+
+		writeTime = std::filesystem::last_write_time(sourcePath, error).time_since_epoch().count();
+		return !error;
+	}
+
+	// The writer aligns every block to DataAlignment, which covers what the mapped arrays need
+	static_assert(MeshFile::DataAlignment % alignof(Vertex_Input) == 0 && MeshFile::DataAlignment % alignof(uint32_t) == 0);
+
+	// After the header, aligned and inside the file, without offset + count * stride (a corrupt offset can wrap it)
+	bool IsValidBlock(uint64_t offset, uint64_t count, uint64_t stride, size_t size)
+	{
+		return offset >= sizeof(MeshFile::Header) && offset % MeshFile::DataAlignment == 0
+			&& offset <= size && count <= (size - offset) / stride;
+	}
+
+	void WritePadding(std::ofstream& file, uint64_t offset)
+	{
+		const char zeros[MeshFile::DataAlignment]{};
+		file.write(zeros, static_cast<std::streamsize>(offset) - file.tellp());
+	}
+}
+
+std::string MeshFile::GetCachePath(const std::string& sourcePath)
+{
+	return std::filesystem::path{ sourcePath }.replace_extension(".emesh").string();
+}
+
+bool MeshFile::Parse(const uint8_t* pData, size_t size, const std::string& sourcePath, const Header*& pHeader)
+{
+	if (size < sizeof(Header))
+		return false;
+
+	pHeader = reinterpret_cast<const Header*>(pData);
+	if (pHeader->magic != Magic || pHeader->version != Version || pHeader->vertexStride != sizeof(Vertex_Input))
+		return false;
+	if (!IsValidBlock(pHeader->vertexOffset, pHeader->vertexCount, sizeof(Vertex_Input), size)
+		|| !IsValidBlock(pHeader->indexOffset, pHeader->indexCount, sizeof(uint32_t), size))
+		return false;
+	if (pHeader->lodCount == 0 || pHeader->lodCount > MaxLods)
+		return false;
+	for (uint32_t lod{}; lod < pHeader->lodCount; ++lod)
+	{
+		if (uint64_t(pHeader->lods[lod].indexOffset) + pHeader->lods[lod].indexCount > pHeader->indexCount)
+			return false;
+	}
+
+	// Only the cache shipped, nothing to compare against
+	uint64_t sourceSize;
+	int64_t sourceWriteTime;
+	if (!GetSourceStamp(sourcePath, sourceSize, sourceWriteTime))
+		return true;
+
+	if (sourceSize != pHeader->sourceSize)
+		return false;
+	if (sourceWriteTime == pHeader->sourceWriteTime)
+		return true;
+
+	uint64_t sourceHash;
+	return Hash::HashFile(sourcePath, sourceHash) && sourceHash == pHeader->sourceHash;
+}
+
+bool MeshFile::Write(const std::string& sourcePath, uint64_t sourceHash, std::span<const Vertex_Input> vertices, std::span<const uint32_t> indices,
+	std::span<const MeshLod> lods, const Elite::FPoint3& boundsMin, const Elite::FPoint3& boundsMax)
+{
+	Header header{};
+	header.magic = Magic;
+	header.version = Version;
+	header.vertexStride = sizeof(Vertex_Input);
+	header.vertexCount = static_cast<uint32_t>(vertices.size());
+	header.indexCount = static_cast<uint32_t>(indices.size());
+	header.lodCount = static_cast<uint32_t>(std::min<size_t>(lods.size(), MaxLods));
+	std::copy_n(lods.begin(), header.lodCount, header.lods);
+	header.sourceHash = sourceHash;
+	if (!GetSourceStamp(sourcePath, header.sourceSize, header.sourceWriteTime))
+		return false;
+
+	for (uint8_t axis{}; axis < 3; ++axis)
+	{
+		header.boundsMin[axis] = boundsMin[axis];
+		header.boundsMax[axis] = boundsMax[axis];
+	}
+
+	header.vertexOffset = (sizeof(Header) + DataAlignment - 1) / DataAlignment * DataAlignment;
+	header.indexOffset = (header.vertexOffset + vertices.size_bytes() + DataAlignment - 1) / DataAlignment * DataAlignment;
+
+	const std::string cachePath{ GetCachePath(sourcePath) };
+	std::ofstream file{ cachePath, std::ios::binary };
+	if (!file.is_open())
+	{
+		std::cout << "Error opening " << cachePath << " for writing" << std::endl;
+		return false;
+	}
+
+	file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+	WritePadding(file, header.vertexOffset);
+	file.write(reinterpret_cast<const char*>(vertices.data()), static_cast<std::streamsize>(vertices.size_bytes()));
+	WritePadding(file, header.indexOffset);
+	file.write(reinterpret_cast<const char*>(indices.data()), static_cast<std::streamsize>(indices.size_bytes()));
+	return file.good();
+}
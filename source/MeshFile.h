@@ -0,0 +1,51 @@
+#pragma once
+#include <span>
+#include <string>
+#include "structs.h"
+
+// The .emesh cache written next to an OBJ: a header, the welded and optimized vertices in the Vertex_Input layout
+// and the index buffer holding every level of detail, so a mapped file can be used as vertex and index buffer directly.
+namespace MeshFile
+{
+	constexpr uint32_t Magic{ 0x48534D45 }; // "EMSH"
+	// Bump whenever the parser, the optimizer or the simplifier output changes, older caches are rebuilt
+	constexpr uint32_t Version{ 5 };
+	constexpr uint32_t DataAlignment{ 16 };
+	constexpr uint32_t MaxLods{ 4 };
+
+	struct Header
+	{
+		uint32_t magic;
+		uint32_t version;
+		uint32_t vertexStride;
+		uint32_t vertexCount;
+		uint32_t indexCount;
+		uint32_t lodCount;
+
+		// Source OBJ the cache was built from
+		uint64_t sourceSize;
+		int64_t sourceWriteTime;
+		uint64_t sourceHash;
+
+		float boundsMin[3];
+		float boundsMax[3];
+
+		uint64_t vertexOffset;
+		uint64_t indexOffset;
+
+		// Every level is a range of the index buffer, lods[0] is the full mesh
+		MeshLod lods[MaxLods];
+	};
+
+	// Resources/vehicle.obj -> Resources/vehicle.emesh
+	[[nodiscard]] std::string GetCachePath(const std::string& sourcePath);
+
+	// Validates the layout and checks the cache against the source: size and write time first,
+	// the content hash only when the time changed (a touched but unchanged file keeps its cache).
+	[[nodiscard]] bool Parse(const uint8_t* pData, size_t size, const std::string& sourcePath, const Header*& pHeader);
+
+	// sourceHash is the Hash::Fnv1a of the OBJ bytes the mesh was parsed from
+	bool Write(const std::string& sourcePath, uint64_t sourceHash, std::span<const Vertex_Input> vertices, std::span<const uint32_t> indices,
+		std::span<const MeshLod> lods, const Elite::FPoint3& boundsMin, const Elite::FPoint3& boundsMax);
+}
+
@@ -0,0 +1,447 @@
+#include "pch.h"
+#include "MeshOptimizer.h"
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <numeric>
+#include "EObjParser.h"
+
+namespace
+{
+	constexpr uint32_t g_InvalidIndex{ UINT32_MAX };
+
+	// Forsyth's LRU cache model and scoring constants
+	constexpr uint32_t g_ForsythCacheSize{ 32 };
+	constexpr float g_LastTriangleScore{ 0.75f };
+	constexpr float g_CacheDecayPower{ 1.5f };
+	constexpr float g_ValenceBoostScale{ 2.f };
+	constexpr float g_ValenceBoostPower{ 0.5f };
+
+	constexpr uint32_t g_OverdrawCacheSize{ 16 };
+	constexpr uint32_t g_MinClusterTriangles{ 16 };
+	constexpr uint32_t g_OverdrawGridSize{ 256 };
+
+	float GetVertexScore(int32_t cachePosition, uint32_t remainingTriangles)
+	{
+		if (remainingTriangles == 0)
+			return -1.f;
+
+		float score{};
+		if (cachePosition >= 0)
+		{
+			// The vertices of the last triangle get a fixed score, so the next one doesn't simply reuse the same edge
+			if (cachePosition < 3)
+				score = g_LastTriangleScore;
+			else
+				score = powf(1.f - static_cast<float>(cachePosition - 3) / (g_ForsythCacheSize - 3), g_CacheDecayPower);
+		}
+
+		// Boost vertices with few triangles left, so lone triangles don't get stranded
+		return score + g_ValenceBoostScale * powf(static_cast<float>(remainingTriangles), -g_ValenceBoostPower);
+	}
+
+	// Cache misses of every triangle with a FIFO cache, the model most hardware is closest to
+	std::vector<uint32_t> SimulateFIFOCache(const std::vector<uint32_t>& indices, uint32_t vertexCount, uint32_t cacheSize)
+	{
+		std::vector<uint32_t> cacheTimestamps(vertexCount, 0);
+		std::vector<uint32_t> misses(indices.size() / 3);
+		uint32_t timestamp{ cacheSize + 1 };
+
+		for (size_t i{}; i < indices.size(); ++i)
+		{
+			// A vertex is still cached when fewer than cacheSize vertices were added after it
+			if (timestamp - cacheTimestamps[indices[i]] > cacheSize)
+			{
+				cacheTimestamps[indices[i]] = timestamp++;
+				++misses[i / 3];
+			}
+		}
+		return misses;
+	}
+
+	Elite::FVector3 GetFaceNormal(const std::vector<Vertex_Input>& vertices, const uint32_t* pTriangle)
+	{
+		const Elite::FPoint3& p0{ vertices[pTriangle[0]].Position.xyz };
+		const Elite::FPoint3& p1{ vertices[pTriangle[1]].Position.xyz };
+		const Elite::FPoint3& p2{ vertices[pTriangle[2]].Position.xyz };
+		// Not normalized, larger triangles weigh more when summed
+		return Elite::Cross(Elite::FVector3{ p1 - p0 }, Elite::FVector3{ p2 - p0 });
+	}
+
+	// +1 when the face normals (p1 - p0) x (p2 - p0) point outward, judged by the authored vertex normals.
+	// Meshes without normals are assumed to be wound outward.
+	float GetWindingSign(const std::vector<Vertex_Input>& vertices, const std::vector<uint32_t>& indices)
+	{
+		float agreement{};
+		for (size_t i{}; i + 2 < indices.size(); i += 3)
+		{
+			const Elite::FVector3 vertexNormal{ vertices[indices[i]].Normal + vertices[indices[i + 1]].Normal + vertices[indices[i + 2]].Normal };
+			agreement += Elite::Dot(GetFaceNormal(vertices, &indices[i]), vertexNormal);
+		}
+		return agreement < 0.f ? -1.f : 1.f;
+	}
+}
+
+void MeshOptimizer::OptimizeVertexCache(std::vector<uint32_t>& indices, uint32_t vertexCount)
+{
+	const uint32_t triangleCount{ static_cast<uint32_t>(indices.size() / 3) };
+	if (triangleCount == 0)
+		return;
+
+	// Triangles per vertex, the first remainingTriangles[v] entries of a vertex are the triangles not emitted yet
+	std::vector<uint32_t> remainingTriangles(vertexCount, 0);
+	for (uint32_t index : indices)
+		++remainingTriangles[index];
+
+	std::vector<uint32_t> adjacencyOffsets(size_t(vertexCount) + 1, 0);
+	for (uint32_t v{}; v < vertexCount; ++v)
+		adjacencyOffsets[v + 1] = adjacencyOffsets[v] + remainingTriangles[v];
+
+	std::vector<uint32_t> adjacency(indices.size());
+	std::vector<uint32_t> fillCursor(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+	for (uint32_t t{}; t < triangleCount; ++t)
+	{
+		for (uint32_t corner{}; corner < 3; ++corner)
+			adjacency[fillCursor[indices[t * 3 + corner]]++] = t;
+	}
+
+	std::vector<int32_t> cachePositions(vertexCount, -1);
+	std::vector<float> vertexScores(vertexCount);
+	for (uint32_t v{}; v < vertexCount; ++v)
+		vertexScores[v] = GetVertexScore(-1, remainingTriangles[v]);
+
+	std::vector<float> triangleScores(triangleCount);
+	for (uint32_t t{}; t < triangleCount; ++t)
+		triangleScores[t] = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] + vertexScores[indices[t * 3 + 2]];
+
+	std::vector<uint8_t> isEmitted(triangleCount, 0);
+	std::vector<uint32_t> result;
+	result.reserve(indices.size());
+
+	uint32_t cache[g_ForsythCacheSize + 3];
+	uint32_t cacheCount{};
+	uint32_t bestTriangle{ static_cast<uint32_t>(std::max_element(triangleScores.begin(), triangleScores.end()) - triangleScores.begin()) };
+	uint32_t scanCursor{};
+
+	for (uint32_t emittedCount{}; emittedCount < triangleCount; ++emittedCount)
+	{
+		// Nothing in the cache has triangles left, continue with the next unemitted triangle in the input order
+		if (bestTriangle == g_InvalidIndex)
+		{
+			while (isEmitted[scanCursor])
+				++scanCursor;
+			bestTriangle = scanCursor;
+		}
+
+		const uint32_t* pTriangle{ &indices[size_t(bestTriangle) * 3] };
+		result.insert(result.end(), pTriangle, pTriangle + 3);
+		isEmitted[bestTriangle] = 1;
+
+		// Remove the triangle from the adjacency of its vertices
+		for (uint32_t corner{}; corner < 3; ++corner)
+		{
+			const uint32_t v{ pTriangle[corner] };
+			uint32_t* pBegin{ &adjacency[adjacencyOffsets[v]] };
+			uint32_t* pEnd{ pBegin + remainingTriangles[v] };
+			std::iter_swap(std::find(pBegin, pEnd, bestTriangle), pEnd - 1);
+			--remainingTriangles[v];
+		}
+
+		// Move the triangle's vertices to the front of the LRU cache
+		uint32_t newCache[g_ForsythCacheSize + 3];
+		uint32_t newCacheCount{};
+		for (uint32_t corner{}; corner < 3; ++corner)
+		{
+			if (std::find(newCache, newCache + newCacheCount, pTriangle[corner]) == newCache + newCacheCount)
+				newCache[newCacheCount++] = pTriangle[corner];
+		}
+		for (uint32_t i{}; i < cacheCount; ++i)
+		{
+			if (std::find(pTriangle, pTriangle + 3, cache[i]) == pTriangle + 3)
+				newCache[newCacheCount++] = cache[i];
+		}
+
+		// Rescore the touched vertices and push the difference to their triangles
+		for (uint32_t i{}; i < newCacheCount; ++i)
+		{
+			const uint32_t v{ newCache[i] };
+			cachePositions[v] = i < g_ForsythCacheSize ? static_cast<int32_t>(i) : -1;
+
+			const float score{ GetVertexScore(cachePositions[v], remainingTriangles[v]) };
+			const float scoreDelta{ score - vertexScores[v] };
+			vertexScores[v] = score;
+
+			for (uint32_t a{ adjacencyOffsets[v] }; a < adjacencyOffsets[v] + remainingTriangles[v]; ++a)
+				triangleScores[adjacency[a]] += scoreDelta;
+		}
+
+		cacheCount = std::min(newCacheCount, g_ForsythCacheSize);
+		std::copy(newCache, newCache + cacheCount, cache);
+
+		// The next triangle is the best one touching the cache
+		bestTriangle = g_InvalidIndex;
+		float bestScore{ -std::numeric_limits<float>::max() };
+		for (uint32_t i{}; i < cacheCount; ++i)
+		{
+			const uint32_t v{ cache[i] };
+			for (uint32_t a{ adjacencyOffsets[v] }; a < adjacencyOffsets[v] + remainingTriangles[v]; ++a)
+			{
+				if (triangleScores[adjacency[a]] > bestScore)
+				{
+					bestScore = triangleScores[adjacency[a]];
+					bestTriangle = adjacency[a];
+				}
+			}
+		}
+	}
+
+	indices.swap(result);
+}
+
+void MeshOptimizer::OptimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<Vertex_Input>& vertices, float threshold)
+{
+	const uint32_t triangleCount{ static_cast<uint32_t>(indices.size() / 3) };
+	if (triangleCount == 0)
+		return;
+
+	const std::vector<uint32_t> misses{ SimulateFIFOCache(indices, static_cast<uint32_t>(vertices.size()), g_OverdrawCacheSize) };
+
+	// Hard boundaries are the triangles missing all 3 vertices, reordering there costs no cache efficiency
+	std::vector<uint32_t> hardBoundaries;
+	for (uint32_t t{}; t < triangleCount; ++t)
+	{
+		if (t == 0 || misses[t] == 3)
+			hardBoundaries.push_back(t);
+	}
+	hardBoundaries.push_back(triangleCount);
+
+	// Soft boundaries split a hard cluster further as long as the part keeps an ACMR within the threshold
+	std::vector<uint32_t> clusterStarts;
+	for (size_t h{}; h + 1 < hardBoundaries.size(); ++h)
+	{
+		const uint32_t begin{ hardBoundaries[h] };
+		const uint32_t end{ hardBoundaries[h + 1] };
+		const uint32_t clusterMisses{ std::accumulate(misses.begin() + begin, misses.begin() + end, 0u) };
+		const float clusterACMR{ static_cast<float>(clusterMisses) / (end - begin) };
+
+		clusterStarts.push_back(begin);
+		uint32_t runningMisses{};
+		uint32_t softBegin{ begin };
+		for (uint32_t t{ begin }; t < end; ++t)
+		{
+			runningMisses += misses[t];
+			const uint32_t runningCount{ t - softBegin + 1 };
+			if (t + 1 < end && runningCount >= g_MinClusterTriangles && static_cast<float>(runningMisses) / runningCount <= clusterACMR * threshold)
+			{
+				clusterStarts.push_back(t + 1);
+				softBegin = t + 1;
+				runningMisses = 0;
+			}
+		}
+	}
+	clusterStarts.push_back(triangleCount);
+
+	// Sort key: how far the cluster sits out along its own normal, outer shells are drawn first and occlude the rest
+	Elite::FVector3 meshCentroid{};
+	for (const Vertex_Input& vertex : vertices)
+		meshCentroid += Elite::FVector3{ vertex.Position.xyz };
+	meshCentroid /= static_cast<float>(std::max<size_t>(vertices.size(), 1));
+
+	const float windingSign{ GetWindingSign(vertices, indices) };
+	const size_t clusterCount{ clusterStarts.size() - 1 };
+	std::vector<float> sortKeys(clusterCount);
+	for (size_t c{}; c < clusterCount; ++c)
+	{
+		Elite::FVector3 centroid{};
+		Elite::FVector3 normal{};
+		for (uint32_t t{ clusterStarts[c] }; t < clusterStarts[c + 1]; ++t)
+		{
+			const uint32_t* pTriangle{ &indices[size_t(t) * 3] };
+			for (uint32_t corner{}; corner < 3; ++corner)
+				centroid += Elite::FVector3{ vertices[pTriangle[corner]].Position.xyz };
+			normal += GetFaceNormal(vertices, pTriangle);
+		}
+		centroid /= static_cast<float>((clusterStarts[c + 1] - clusterStarts[c]) * 3);
+
+		normal *= windingSign;
+		const float normalLength{ Elite::Magnitude(normal) };
+		sortKeys[c] = normalLength > 0.f ? Elite::Dot(centroid - meshCentroid, normal / normalLength) : 0.f;
+	}
+
+	std::vector<uint32_t> clusterOrder(clusterCount);
+	std::iota(clusterOrder.begin(), clusterOrder.end(), 0u);
+	std::stable_sort(clusterOrder.begin(), clusterOrder.end(), [&sortKeys](uint32_t a, uint32_t b) { return sortKeys[a] > sortKeys[b]; });
+
+	std::vector<uint32_t> result;
+	result.reserve(indices.size());
+	for (uint32_t c : clusterOrder)
+		result.insert(result.end(), indices.begin() + size_t(clusterStarts[c]) * 3, indices.begin() + size_t(clusterStarts[c + 1]) * 3);
+
+	indices.swap(result);
+}
+
+void MeshOptimizer::OptimizeVertexFetch(std::vector<Vertex_Input>& vertices, std::vector<uint32_t>& indices)
+{
+	std::vector<uint32_t> remap(vertices.size(), g_InvalidIndex);
+	std::vector<Vertex_Input> result;
+	result.reserve(vertices.size());
+
+	for (uint32_t& index : indices)
+	{
+		if (remap[index] == g_InvalidIndex)
+		{
+			remap[index] = static_cast<uint32_t>(result.size());
+			result.push_back(vertices[index]);
+		}
+		index = remap[index];
+	}
+
+	vertices.swap(result);
+}
+
+MeshOptimizer::VertexCacheStatistics MeshOptimizer::AnalyzeVertexCache(const std::vector<uint32_t>& indices, uint32_t vertexCount, uint32_t cacheSize)
+{
+	const std::vector<uint32_t> misses{ SimulateFIFOCache(indices, vertexCount, cacheSize) };
+	const float transformed{ static_cast<float>(std::accumulate(misses.begin(), misses.end(), 0u)) };
+
+	return VertexCacheStatistics{
+		misses.empty() ? 0.f : transformed / misses.size(),
+		vertexCount == 0 ? 0.f : transformed / vertexCount };
+}
+
+float MeshOptimizer::AnalyzeOverdraw(const std::vector<Vertex_Input>& vertices, const std::vector<uint32_t>& indices)
+{
+	if (vertices.empty() || indices.empty())
+		return 0.f;
+
+	Elite::FPoint3 minimum{ vertices[0].Position.xyz };
+	Elite::FPoint3 maximum{ vertices[0].Position.xyz };
+	for (const Vertex_Input& vertex : vertices)
+	{
+		for (uint8_t axis{}; axis < 3; ++axis)
+		{
+			minimum[axis] = std::min(minimum[axis], vertex.Position[axis]);
+			maximum[axis] = std::max(maximum[axis], vertex.Position[axis]);
+		}
+	}
+
+	float extent{};
+	for (uint8_t axis{}; axis < 3; ++axis)
+		extent = std::max(extent, maximum[axis] - minimum[axis]);
+	const float scale{ extent > 0.f ? (g_OverdrawGridSize - 1) / extent : 0.f };
+
+	const float windingSign{ GetWindingSign(vertices, indices) };
+	std::vector<float> depthBuffer(size_t(g_OverdrawGridSize) * g_OverdrawGridSize);
+	uint64_t shadedPixels{};
+	uint64_t coveredPixels{};
+
+	// Looking down +x, -x, +y, -y, +z and -z. Mirroring u for the negative views keeps the winding consistent.
+	for (int view{}; view < 6; ++view)
+	{
+		const uint8_t depthAxis{ static_cast<uint8_t>(view / 2) };
+		const float direction{ view % 2 == 0 ? 1.f : -1.f };
+		const uint8_t uAxis{ static_cast<uint8_t>((depthAxis + 1) % 3) };
+		const uint8_t vAxis{ static_cast<uint8_t>((depthAxis + 2) % 3) };
+
+		std::fill(depthBuffer.begin(), depthBuffer.end(), std::numeric_limits<float>::max());
+
+		for (size_t i{}; i + 2 < indices.size(); i += 3)
+		{
+			float u[3], v[3], depth[3];
+			for (int corner{}; corner < 3; ++corner)
+			{
+				const Elite::FPoint4& position{ vertices[indices[i + corner]].Position };
+				const float mirroredU{ direction > 0.f ? position[uAxis] - minimum[uAxis] : maximum[uAxis] - position[uAxis] };
+				u[corner] = mirroredU * scale;
+				v[corner] = (position[vAxis] - minimum[vAxis]) * scale;
+				depth[corner] = position[depthAxis] * direction;
+			}
+
+			// A positive area means the face normal points away from the viewer, only front faces are drawn
+			float area{ (u[1] - u[0]) * (v[2] - v[0]) - (u[2] - u[0]) * (v[1] - v[0]) };
+			if (area * windingSign >= 0.f)
+				continue;
+			if (area < 0.f)
+			{
+				std::swap(u[1], u[2]);
+				std::swap(v[1], v[2]);
+				std::swap(depth[1], depth[2]);
+				area = -area;
+			}
+
+			const int minX{ std::max(static_cast<int>(std::floor(std::min({ u[0], u[1], u[2] }))), 0) };
+			const int maxX{ std::min(static_cast<int>(std::ceil(std::max({ u[0], u[1], u[2] }))), static_cast<int>(g_OverdrawGridSize) - 1) };
+			const int minY{ std::max(static_cast<int>(std::floor(std::min({ v[0], v[1], v[2] }))), 0) };
+			const int maxY{ std::min(static_cast<int>(std::ceil(std::max({ v[0], v[1], v[2] }))), static_cast<int>(g_OverdrawGridSize) - 1) };
+
+			for (int y{ minY }; y <= maxY; ++y)
+			{
+				for (int x{ minX }; x <= maxX; ++x)
+				{
+					const float px{ x + 0.5f };
+					const float py{ y + 0.5f };
+					const float w0{ (u[2] - u[1]) * (py - v[1]) - (v[2] - v[1]) * (px - u[1]) };
+					const float w1{ (u[0] - u[2]) * (py - v[2]) - (v[0] - v[2]) * (px - u[2]) };
+					const float w2{ (u[1] - u[0]) * (py - v[0]) - (v[1] - v[0]) * (px - u[0]) };
+					if (w0 < 0.f || w1 < 0.f || w2 < 0.f)
+						continue;
+
+					const float pixelDepth{ (w0 * depth[0] + w1 * depth[1] + w2 * depth[2]) / area };
+					float& storedDepth{ depthBuffer[size_t(y) * g_OverdrawGridSize + x] };
+					if (pixelDepth < storedDepth)
+					{
+						storedDepth = pixelDepth;
+						++shadedPixels;
+					}
+				}
+			}
+		}
+
+		coveredPixels += std::count_if(depthBuffer.begin(), depthBuffer.end(), [](float depth) { return depth != std::numeric_limits<float>::max(); });
+	}
+
+	return coveredPixels == 0 ? 0.f : static_cast<float>(shadedPixels) / coveredPixels;
+}
+
+void MeshOptimizer::Optimize(std::vector<Vertex_Input>& vertices, std::vector<uint32_t>& indices)
+{
+	OptimizeVertexCache(indices, static_cast<uint32_t>(vertices.size()));
+	OptimizeOverdraw(indices, vertices);
+	OptimizeVertexFetch(vertices, indices);
+}
+
+void MeshOptimizer::Benchmark(const std::string& filename)
+{
+	std::vector<Vertex_Input> vertices;
+	std::vector<uint32_t> indices;
+	if (!Elite::ParseOBJ(filename, Elite::FVector3{}, vertices, indices))
+	{
+		std::cout << "Error parsing " << filename << " for benchmarking" << std::endl;
+		return;
+	}
+
+	const uint32_t vertexCount{ static_cast<uint32_t>(vertices.size()) };
+	const VertexCacheStatistics cacheBefore{ AnalyzeVertexCache(indices, vertexCount) };
+	const float overdrawBefore{ AnalyzeOverdraw(vertices, indices) };
+
+	const auto measure = [](const auto& pass)
+	{
+		const auto start{ std::chrono::steady_clock::now() };
+		pass();
+		return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+	};
+	const float cacheMs{ measure([&]() { OptimizeVertexCache(indices, vertexCount); }) };
+	const float overdrawMs{ measure([&]() { OptimizeOverdraw(indices, vertices); }) };
+	const float fetchMs{ measure([&]() { OptimizeVertexFetch(vertices, indices); }) };
+
+	const VertexCacheStatistics cacheAfter{ AnalyzeVertexCache(indices, static_cast<uint32_t>(vertices.size())) };
+	const float overdrawAfter{ AnalyzeOverdraw(vertices, indices) };
+
+	std::cout << std::fixed << std::setprecision(3)
+		<< "Optimized " << filename << ": ACMR " << cacheBefore.acmr << " -> " << cacheAfter.acmr
+		<< ", ATVR " << cacheBefore.atvr << " -> " << cacheAfter.atvr
+		<< ", overdraw " << overdrawBefore << " -> " << overdrawAfter << std::endl
+		<< "  vertex cache " << cacheMs << " ms, overdraw " << overdrawMs << " ms, vertex fetch " << fetchMs << " ms" << std::endl
+		<< std::defaultfloat;
+}
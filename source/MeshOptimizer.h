@@ -0,0 +1,34 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "structs.h"
+
+// Post load reordering of the index and vertex buffers, run in this order:
+// vertex cache (Forsyth), overdraw (cluster sorting, Sander et al.) and vertex fetch (first use order).
+namespace MeshOptimizer
+{
+	struct VertexCacheStatistics
+	{
+		float acmr; // average cache miss ratio, transformed vertices per triangle
+		float atvr; // average transform to vertex ratio, 1 is optimal
+	};
+
+	// Reorders the triangles to maximize post transform cache hits
+	void OptimizeVertexCache(std::vector<uint32_t>& indices, uint32_t vertexCount);
+	// Splits the cache optimized triangles into clusters and sorts them outward facing first.
+	// threshold is the ACMR a cluster may lose for a finer split, 1.05 allows 5%
+	void OptimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<Vertex_Input>& vertices, float threshold = 1.05f);
+	// Reorders the vertices in first use order and remaps the indices, unreferenced vertices are dropped
+	void OptimizeVertexFetch(std::vector<Vertex_Input>& vertices, std::vector<uint32_t>& indices);
+
+	[[nodiscard]] VertexCacheStatistics AnalyzeVertexCache(const std::vector<uint32_t>& indices, uint32_t vertexCount, uint32_t cacheSize = 16);
+	// Shaded pixels per covered pixel, averaged over 6 axis aligned orthographic views
+	[[nodiscard]] float AnalyzeOverdraw(const std::vector<Vertex_Input>& vertices, const std::vector<uint32_t>& indices);
+
+	// Runs all passes, called on every parse so it prints nothing
+	void Optimize(std::vector<Vertex_Input>& vertices, std::vector<uint32_t>& indices);
+
+	// Parses the OBJ, runs every pass and prints the time of each and the statistics before and after
+	void Benchmark(const std::string& filename);
+}
+
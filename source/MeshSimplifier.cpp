@@ -0,0 +1,281 @@
+#include "pch.h"
+#include "MeshSimplifier.h"
+#include "MeshOptimizer.h"
+#include <cmath>
+#include <numeric>
+#include <tuple>
+#include <unordered_map>
+
+namespace
+{
+	// Collapses may not turn a triangle further than this, cos(75 degrees)
+	constexpr float g_MinNormalDot{ 0.25f };
+
+	// A level has to drop at least 10% of the triangles of the level before to be worth its memory
+	constexpr float g_MinLodReduction{ 0.9f };
+
+	// Area weighted sum of squared distances to the planes of the triangles around a vertex.
+	// Divided by the weight it is the mean squared distance, so errors are in mesh units.
+	struct Quadric
+	{
+		double a00, a01, a02, a11, a12, a22;
+		double b0, b1, b2;
+		double c;
+		double weight;
+
+		void AddPlane(const Elite::FVector3& normal, float distance, float area)
+		{
+			a00 += area * normal.x * normal.x;
+			a01 += area * normal.x * normal.y;
+			a02 += area * normal.x * normal.z;
+			a11 += area * normal.y * normal.y;
+			a12 += area * normal.y * normal.z;
+			a22 += area * normal.z * normal.z;
+			b0 += area * normal.x * distance;
+			b1 += area * normal.y * distance;
+			b2 += area * normal.z * distance;
+			c += area * distance * distance;
+			weight += area;
+		}
+
+		void Add(const Quadric& other)
+		{
+			a00 += other.a00; a01 += other.a01; a02 += other.a02;
+			a11 += other.a11; a12 += other.a12; a22 += other.a22;
+			b0 += other.b0; b1 += other.b1; b2 += other.b2;
+			c += other.c;
+			weight += other.weight;
+		}
+
+		[[nodiscard]] float GetError(const Elite::FPoint3& p) const
+		{
+			const double x{ p.x }, y{ p.y }, z{ p.z };
+			const double error{ a00 * x * x + a11 * y * y + a22 * z * z + 2 * (a01 * x * y + a02 * x * z + a12 * y * z)
+				+ 2 * (b0 * x + b1 * y + b2 * z) + c };
+			return weight > 0 ? static_cast<float>(std::sqrt(std::max(error / weight, 0.0))) : 0.f;
+		}
+	};
+
+	struct Collapse
+	{
+		float error;
+		uint32_t from;
+		uint32_t to;
+	};
+
+	const Elite::FPoint3& GetPosition(std::span<const Vertex_Input> vertices, uint32_t index)
+	{
+		return vertices[index].Position.xyz;
+	}
+
+	// Vertices that may not move: on a border edge, on a non manifold edge or sharing their position with another vertex
+	std::vector<bool> FindLockedVertices(std::span<const Vertex_Input> vertices, const std::vector<uint32_t>& indices)
+	{
+		std::vector<bool> isLocked(vertices.size(), false);
+
+		std::unordered_map<uint64_t, uint32_t> edgeTriangles;
+		edgeTriangles.reserve(indices.size());
+		for (size_t i{}; i < indices.size(); i += 3)
+		{
+			for (uint32_t corner{}; corner < 3; ++corner)
+			{
+				const uint32_t a{ indices[i + corner] };
+				const uint32_t b{ indices[i + (corner + 1) % 3] };
+				++edgeTriangles[uint64_t(std::min(a, b)) << 32 | std::max(a, b)];
+			}
+		}
+
+		for (const auto& [edge, triangleCount] : edgeTriangles)
+		{
+			if (triangleCount == 2)
+				continue;
+			isLocked[static_cast<uint32_t>(edge >> 32)] = true;
+			isLocked[static_cast<uint32_t>(edge)] = true;
+		}
+
+		// Seams that don't run along an edge, a pole shared by several UV charts for example
+		const auto isLess = [&](uint32_t lhs, uint32_t rhs)
+			{
+				const Elite::FPoint3& l{ GetPosition(vertices, lhs) };
+				const Elite::FPoint3& r{ GetPosition(vertices, rhs) };
+				return std::tie(l.x, l.y, l.z) < std::tie(r.x, r.y, r.z);
+			};
+		std::vector<uint32_t> order(vertices.size());
+		std::iota(order.begin(), order.end(), 0u);
+		std::sort(order.begin(), order.end(), isLess);
+		for (size_t i{ 1 }; i < order.size(); ++i)
+		{
+			if (isLess(order[i - 1], order[i]))
+				continue;
+			isLocked[order[i - 1]] = true;
+			isLocked[order[i]] = true;
+		}
+		return isLocked;
+	}
+
+	Elite::FVector3 GetNormal(const Elite::FPoint3& p0, const Elite::FPoint3& p1, const Elite::FPoint3& p2)
+	{
+		return Elite::Cross(p1 - p0, p2 - p0);
+	}
+
+	// Moving from onto to may not flip or fold any triangle around from
+	bool IsCollapseValid(std::span<const Vertex_Input> vertices, const std::vector<uint32_t>& indices,
+		const std::vector<uint32_t>& adjacencyOffsets, const std::vector<uint32_t>& adjacency, uint32_t from, uint32_t to)
+	{
+		for (uint32_t i{ adjacencyOffsets[from] }; i < adjacencyOffsets[from + 1]; ++i)
+		{
+			const uint32_t* pTriangle{ &indices[size_t(adjacency[i]) * 3] };
+			if (pTriangle[0] == to || pTriangle[1] == to || pTriangle[2] == to)
+				continue;
+
+			Elite::FPoint3 corners[3];
+			for (uint32_t corner{}; corner < 3; ++corner)
+				corners[corner] = GetPosition(vertices, pTriangle[corner] == from ? to : pTriangle[corner]);
+
+			const Elite::FVector3 oldNormal{ GetNormal(GetPosition(vertices, pTriangle[0]), GetPosition(vertices, pTriangle[1]), GetPosition(vertices, pTriangle[2])) };
+			const Elite::FVector3 newNormal{ GetNormal(corners[0], corners[1], corners[2]) };
+			const float oldLength{ Elite::Magnitude(oldNormal) };
+			const float newLength{ Elite::Magnitude(newNormal) };
+			if (!std::isnormal(newLength) || Elite::Dot(oldNormal, newNormal) < g_MinNormalDot * oldLength * newLength)
+				return false;
+		}
+		return true;
+	}
+}
+
+float MeshSimplifier::Simplify(std::span<const Vertex_Input> vertices, std::span<const uint32_t> indices, size_t targetIndexCount, float maxError,
+	std::vector<uint32_t>& destination)
+{
+	destination.assign(indices.begin(), indices.end());
+	const uint32_t vertexCount{ static_cast<uint32_t>(vertices.size()) };
+
+	std::vector<Quadric> quadrics(vertexCount, Quadric{});
+	for (size_t i{}; i + 2 < destination.size(); i += 3)
+	{
+		const Elite::FPoint3& p0{ GetPosition(vertices, destination[i]) };
+		Elite::FVector3 normal{ GetNormal(p0, GetPosition(vertices, destination[i + 1]), GetPosition(vertices, destination[i + 2])) };
+		const float area{ Elite::Normalize(normal) * 0.5f };
+		if (!std::isnormal(area))
+			continue;
+
+		const float distance{ -Elite::Dot(normal, Elite::FVector3{ p0 }) };
+		for (uint32_t corner{}; corner < 3; ++corner)
+			quadrics[destination[i + corner]].AddPlane(normal, distance, area);
+	}
+
+	const std::vector<bool> isLocked{ FindLockedVertices(vertices, destination) };
+
+	float resultError{};
+	std::vector<uint32_t> adjacencyOffsets(vertexCount + 1);
+	std::vector<uint32_t> adjacency;
+	std::vector<Collapse> collapses;
+	std::vector<uint32_t> remap(vertexCount);
+	std::vector<bool> isTouched(vertexCount);
+
+	// Every pass sorts all edges by error and collapses the cheapest ones that don't touch each other
+	while (destination.size() > targetIndexCount)
+	{
+		std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0u);
+		for (uint32_t index : destination)
+			++adjacencyOffsets[index + 1];
+		for (uint32_t v{}; v < vertexCount; ++v)
+			adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+
+		adjacency.resize(destination.size());
+		{
+			std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+			for (size_t i{}; i < destination.size(); ++i)
+				adjacency[fill[destination[i]]++] = static_cast<uint32_t>(i / 3);
+		}
+
+		// Both directions of every edge, interior edges show up twice (once per triangle), harmless
+		collapses.clear();
+		for (size_t i{}; i < destination.size(); i += 3)
+		{
+			for (uint32_t corner{}; corner < 3; ++corner)
+			{
+				const uint32_t a{ destination[i + corner] };
+				const uint32_t b{ destination[i + (corner + 1) % 3] };
+				if (!isLocked[a])
+					collapses.push_back({ quadrics[a].GetError(GetPosition(vertices, b)), a, b });
+				if (!isLocked[b])
+					collapses.push_back({ quadrics[b].GetError(GetPosition(vertices, a)), b, a });
+			}
+		}
+		std::sort(collapses.begin(), collapses.end(), [](const Collapse& lhs, const Collapse& rhs) { return lhs.error < rhs.error; });
+
+		for (uint32_t v{}; v < vertexCount; ++v)
+			remap[v] = v;
+		std::fill(isTouched.begin(), isTouched.end(), false);
+
+		// Every collapse removes about 2 triangles
+		const size_t trianglesToRemove{ (destination.size() - targetIndexCount) / 3 };
+		size_t collapseCount{};
+		for (const Collapse& collapse : collapses)
+		{
+			if (collapse.error > maxError || collapseCount * 2 >= trianglesToRemove)
+				break;
+			if (isTouched[collapse.from] || isTouched[collapse.to])
+				continue;
+			if (!IsCollapseValid(vertices, destination, adjacencyOffsets, adjacency, collapse.from, collapse.to))
+				continue;
+
+			remap[collapse.from] = collapse.to;
+			quadrics[collapse.to].Add(quadrics[collapse.from]);
+			resultError = std::max(resultError, collapse.error);
+			++collapseCount;
+
+			// The one ring of from changes shape, its vertices wait for the next pass
+			for (uint32_t i{ adjacencyOffsets[collapse.from] }; i < adjacencyOffsets[collapse.from + 1]; ++i)
+			{
+				for (uint32_t corner{}; corner < 3; ++corner)
+					isTouched[destination[size_t(adjacency[i]) * 3 + corner]] = true;
+			}
+		}
+
+		if (collapseCount == 0)
+			break;
+
+		// Remap and drop the triangles that collapsed to a line
+		size_t write{};
+		for (size_t i{}; i < destination.size(); i += 3)
+		{
+			const uint32_t a{ remap[destination[i]] };
+			const uint32_t b{ remap[destination[i + 1]] };
+			const uint32_t c{ remap[destination[i + 2]] };
+			if (a == b || b == c || a == c)
+				continue;
+
+			destination[write++] = a;
+			destination[write++] = b;
+			destination[write++] = c;
+		}
+		destination.resize(write);
+	}
+
+	return resultError;
+}
+
+void MeshSimplifier::BuildLods(std::span<const Vertex_Input> vertices, std::vector<uint32_t>& indices, uint32_t maxLodCount, float maxError,
+	std::vector<MeshLod>& lods)
+{
+	lods.assign(1, MeshLod{ 0, static_cast<uint32_t>(indices.size()) });
+
+	// Every level starts from the full mesh, simplifying the previous level would restart the quadrics there
+	// and let the error of each level add up past maxError
+	const uint32_t baseTriangleCount{ lods.front().indexCount / 3 };
+	std::vector<uint32_t> lodIndices;
+	while (lods.size() < maxLodCount)
+	{
+		const MeshLod previous{ lods.back() };
+		const std::span<const uint32_t> baseIndices{ indices.data(), lods.front().indexCount };
+		const size_t targetIndexCount{ size_t(baseTriangleCount >> lods.size()) * 3 };
+		Simplify(vertices, baseIndices, targetIndexCount, maxError, lodIndices);
+		if (lodIndices.empty() || lodIndices.size() > previous.indexCount * g_MinLodReduction)
+			break;
+
+		MeshOptimizer::OptimizeVertexCache(lodIndices, static_cast<uint32_t>(vertices.size()));
+		lods.push_back(MeshLod{ static_cast<uint32_t>(indices.size()), static_cast<uint32_t>(lodIndices.size()) });
+		indices.insert(indices.end(), lodIndices.begin(), lodIndices.end());
+	}
+}
@@ -0,0 +1,21 @@
+#pragma once
+#include <span>
+#include <vector>
+#include "structs.h"
+
+// Quadric error metric simplification (Garland and Heckbert) by half edge collapses.
+// Vertices only ever move onto one of their neighbours, so every level of detail indexes the original vertex buffer.
+// Vertices on a border of the index topology are locked, the parser splits UV and normal seams so those are borders too.
+namespace MeshSimplifier
+{
+	// Collapses edges until the index count reaches targetIndexCount or the next collapse would move the surface
+	// further than maxError (mesh units). Returns the largest error of the collapses that were done.
+	float Simplify(std::span<const Vertex_Input> vertices, std::span<const uint32_t> indices, size_t targetIndexCount, float maxError,
+		std::vector<uint32_t>& destination);
+
+	// Appends up to maxLodCount - 1 coarser levels to indices, each one simplified from the full mesh (the first lod)
+	// and aiming at half the triangles of the level before, so maxError bounds every level against the original surface.
+	// Stops early when a level can't drop 10% of the triangles within maxError. The levels are vertex cache optimized.
+	void BuildLods(std::span<const Vertex_Input> vertices, std::vector<uint32_t>& indices, uint32_t maxLodCount, float maxError,
+		std::vector<MeshLod>& lods);
+}
@@ -0,0 +1,104 @@
+#include "pch.h"
+#include "MeshTangents.h"
+#include "ThreadPool.h"
+
+using namespace Elite;
+
+namespace
+{
+	constexpr size_t g_MinItemsPerThread{ 16 * 1024 };
+
+	// Splits [0, count) into one contiguous range per pool thread and the caller, serial without a pool or for small meshes
+	template<typename Function>
+	void ForEachRange(size_t count, ThreadPool* pThreadPool, const Function& function)
+	{
+		const size_t threadCount{ pThreadPool ? pThreadPool->GetThreadCount() + size_t{ 1 } : 1 };
+		const size_t rangeCount{ std::max<size_t>(std::min<size_t>(threadCount, count / g_MinItemsPerThread), 1) };
+		if (rangeCount == 1)
+		{
+			function(size_t{}, count);
+			return;
+		}
+
+		const size_t rangeSize{ (count + rangeCount - 1) / rangeCount };
+		pThreadPool->ParallelFor(rangeCount, [count, rangeSize, &function](size_t i)
+			{
+				function(std::min(i * rangeSize, count), std::min((i + 1) * rangeSize, count));
+			});
+	}
+
+	// Zero when the UVs of the triangle are degenerate (collinear or repeated), the 1 / determinant would be infinite
+	FVector3 ComputeTriangleTangent(const std::vector<Vertex_Input>& vertices, const uint32_t* pIndices)
+	{
+		const Vertex_Input& v0{ vertices[pIndices[0]] };
+		const Vertex_Input& v1{ vertices[pIndices[1]] };
+		const Vertex_Input& v2{ vertices[pIndices[2]] };
+
+		const FVector3 edge0{ v1.Position.xyz - v0.Position.xyz };
+		const FVector3 edge1{ v2.Position.xyz - v0.Position.xyz };
+		const FVector2 diffX{ v1.UV.x - v0.UV.x, v2.UV.x - v0.UV.x };
+		const FVector2 diffY{ v1.UV.y - v0.UV.y, v2.UV.y - v0.UV.y };
+
+		const float determinant{ Cross(diffX, diffY) };
+		if (!std::isnormal(determinant))
+			return FVector3{};
+
+		const float r{ 1.f / determinant };
+		FVector3 tangent{ (edge0 * diffY.y - edge1 * diffY.x) * r };
+		tangent.z *= -1.f;
+		return tangent;
+	}
+
+	// Any unit vector perpendicular to the normal, for vertices that only touch degenerate triangles
+	FVector3 GetPerpendicular(const FVector3& normal)
+	{
+		const FVector3 axis{ std::abs(normal.x) < 0.9f ? FVector3{ 1.f, 0.f, 0.f } : FVector3{ 0.f, 1.f, 0.f } };
+		return GetNormalized(Cross(axis, normal));
+	}
+}
+
+void MeshTangents::Compute(std::vector<Vertex_Input>& vertices, const std::vector<uint32_t>& indices, ThreadPool* pThreadPool)
+{
+	const size_t triangleCount{ indices.size() / 3 };
+	const size_t vertexCount{ vertices.size() };
+
+	std::vector<FVector3> triangleTangents(triangleCount);
+	ForEachRange(triangleCount, pThreadPool, [&](size_t begin, size_t end)
+		{
+			for (size_t t{ begin }; t < end; ++t)
+				triangleTangents[t] = ComputeTriangleTangent(vertices, &indices[t * 3]);
+		});
+
+	// Vertex to triangle adjacency, filled in triangle order so every vertex sums its tangents
+	// in the same order as the old serial scatter (bit identical results)
+	std::vector<uint32_t> adjacencyOffsets(vertexCount + 1);
+	for (size_t i{}; i < triangleCount * 3; ++i)
+		++adjacencyOffsets[indices[i] + 1];
+	for (size_t v{}; v < vertexCount; ++v)
+		adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+
+	std::vector<uint32_t> adjacency(triangleCount * 3);
+	{
+		std::vector<uint32_t> cursors(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+		for (size_t i{}; i < triangleCount * 3; ++i)
+			adjacency[cursors[indices[i]]++] = static_cast<uint32_t>(i / 3);
+	}
+
+	ForEachRange(vertexCount, pThreadPool, [&](size_t begin, size_t end)
+		{
+			for (size_t v{ begin }; v < end; ++v)
+			{
+				Vertex_Input& vertex{ vertices[v] };
+				for (uint32_t a{ adjacencyOffsets[v] }; a < adjacencyOffsets[v + 1]; ++a)
+					vertex.Tangent += triangleTangents[adjacency[a]];
+
+				// Without a normal there is nothing to orthogonalize against
+				if (SqrMagnitude(vertex.Normal) > 0.f)
+					vertex.Tangent = Reject(vertex.Tangent, vertex.Normal);
+
+				vertex.Tangent = GetNormalized(vertex.Tangent);
+				if (SqrMagnitude(vertex.Tangent) == 0.f && SqrMagnitude(vertex.Normal) > 0.f)
+					vertex.Tangent = GetPerpendicular(GetNormalized(vertex.Normal));
+			}
+		});
+}
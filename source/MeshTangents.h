@@ -0,0 +1,15 @@
+#pragma once
+#include <vector>
+#include "structs.h"
+
+class ThreadPool;
+
+// Per vertex tangents from the UV layout, run after the vertices are welded.
+// Triangle tangents are computed in parallel, then every vertex gathers the tangents of its own triangles
+// through a vertex to triangle adjacency (CSR), so no two threads ever write the same vertex.
+namespace MeshTangents
+{
+	// Runs on pThreadPool (also from one of its jobs) or serially without one, small meshes use fewer threads so each gets enough work
+	void Compute(std::vector<Vertex_Input>& vertices, const std::vector<uint32_t>& indices, ThreadPool* pThreadPool = nullptr);
+}
+
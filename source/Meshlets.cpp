@@ -0,0 +1,211 @@
+#include "pch.h"
+#include "Meshlets.h"
+#include <cmath>
+
+namespace
+{
+	constexpr uint32_t g_InvalidMeshlet{ UINT32_MAX };
+
+	// The cone gets too wide to ever cull anything when a normal is this close to perpendicular to the axis
+	constexpr float g_MinConeDot{ 0.1f };
+
+	// Faces drawn with CullMode::backface, counter clockwise on screen (FrontCounterClockwise in the effects)
+	Elite::FVector3 GetFrontNormal(const Elite::FPoint3& p0, const Elite::FPoint3& p1, const Elite::FPoint3& p2)
+	{
+		return Elite::Cross(p2 - p0, p1 - p0);
+	}
+
+	Elite::FPoint3 GetCentroid(std::span<const Vertex_Input> vertices, const uint32_t* pIndices)
+	{
+		const Elite::FPoint3& p0{ vertices[pIndices[0]].Position.xyz };
+		const Elite::FPoint3& p1{ vertices[pIndices[1]].Position.xyz };
+		const Elite::FPoint3& p2{ vertices[pIndices[2]].Position.xyz };
+		return Elite::FPoint3{ (p0.x + p1.x + p2.x) / 3.f, (p0.y + p1.y + p2.y) / 3.f, (p0.z + p1.z + p2.z) / 3.f };
+	}
+
+	void ComputeBounds(Meshlets::Meshlet& meshlet, std::span<const Vertex_Input> vertices, std::span<const uint32_t> indices,
+		const uint32_t* pTriangles, const std::vector<uint32_t>& meshletVertices)
+	{
+		// Center of the bounding box, close enough to the minimal sphere for culling
+		Elite::FPoint3 boundsMin{ vertices[meshletVertices[0]].Position.xyz };
+		Elite::FPoint3 boundsMax{ boundsMin };
+		for (uint32_t vertex : meshletVertices)
+		{
+			for (uint8_t axis{}; axis < 3; ++axis)
+			{
+				boundsMin[axis] = std::min(boundsMin[axis], vertices[vertex].Position[axis]);
+				boundsMax[axis] = std::max(boundsMax[axis], vertices[vertex].Position[axis]);
+			}
+		}
+
+		meshlet.center = Elite::FPoint3{ (boundsMin.x + boundsMax.x) * 0.5f, (boundsMin.y + boundsMax.y) * 0.5f, (boundsMin.z + boundsMax.z) * 0.5f };
+		float sqrRadius{};
+		for (uint32_t vertex : meshletVertices)
+			sqrRadius = std::max(sqrRadius, Elite::SqrMagnitude(Elite::FPoint3{ vertices[vertex].Position.xyz } - meshlet.center));
+		meshlet.radius = sqrtf(sqrRadius);
+
+		// Average front normal as the axis, the widest normal sets the cutoff
+		std::vector<Elite::FVector3> normals;
+		normals.reserve(meshlet.triangleCount);
+		Elite::FVector3 axis{};
+		for (uint32_t i{}; i < meshlet.triangleCount; ++i)
+		{
+			const uint32_t* pIndices{ &indices[size_t(pTriangles[i]) * 3] };
+			const Elite::FVector3 normal{ GetFrontNormal(vertices[pIndices[0]].Position.xyz, vertices[pIndices[1]].Position.xyz, vertices[pIndices[2]].Position.xyz) };
+
+			// Degenerate triangles cover no pixels, they don't widen the cone
+			if (!std::isnormal(Elite::SqrMagnitude(normal)))
+				continue;
+
+			normals.push_back(Elite::GetNormalized(normal));
+			axis += normals.back();
+		}
+
+		meshlet.coneAxis = Elite::GetNormalized(axis);
+		meshlet.coneCutoff = 1.f;
+		if (normals.empty() || Elite::SqrMagnitude(meshlet.coneAxis) == 0.f)
+			return;
+
+		float minDot{ 1.f };
+		for (const Elite::FVector3& normal : normals)
+			minDot = std::min(minDot, Elite::Dot(normal, meshlet.coneAxis));
+
+		if (minDot <= g_MinConeDot)
+			return;
+
+		// Every triangle is seen from behind when the view direction is within 90 degrees minus the cone angle of the axis,
+		// cos(90 - angle) = sin(angle)
+		meshlet.coneCutoff = sqrtf(1.f - minDot * minDot);
+	}
+}
+
+void Meshlets::Build(std::span<const Vertex_Input> vertices, std::span<const uint32_t> indices, std::vector<Meshlet>& meshlets, std::vector<uint32_t>& meshletTriangles)
+{
+	const uint32_t triangleCount{ static_cast<uint32_t>(indices.size() / 3) };
+	if (triangleCount == 0)
+		return;
+
+	// Vertex to triangle adjacency (CSR)
+	std::vector<uint32_t> adjacencyOffsets(vertices.size() + 1);
+	for (size_t i{}; i < size_t(triangleCount) * 3; ++i)
+		++adjacencyOffsets[indices[i] + 1];
+	for (size_t v{}; v < vertices.size(); ++v)
+		adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+
+	std::vector<uint32_t> adjacency(size_t(triangleCount) * 3);
+	{
+		std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+		for (size_t i{}; i < adjacency.size(); ++i)
+			adjacency[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+	}
+
+	std::vector<bool> isUsed(triangleCount, false);
+	// Stamped with the meshlet that last used the vertex, so a new meshlet needs no clear
+	std::vector<uint32_t> vertexMeshlet(vertices.size(), g_InvalidMeshlet);
+	std::vector<uint32_t> meshletVertices;
+	meshletVertices.reserve(MaxVertices);
+	meshletTriangles.reserve(meshletTriangles.size() + triangleCount);
+
+	// A triangle repeating a vertex counts it twice, that only ever closes a meshlet a bit early
+	const auto countNewVertices = [&](uint32_t triangle, uint32_t meshletIndex)
+		{
+			uint32_t newVertices{};
+			for (uint32_t corner{}; corner < 3; ++corner)
+			{
+				if (vertexMeshlet[indices[size_t(triangle) * 3 + corner]] != meshletIndex)
+					++newVertices;
+			}
+			return newVertices;
+		};
+
+	// Seeds follow the index buffer order, so the meshlets keep the locality of the vertex cache optimization
+	uint32_t seed{};
+	while (true)
+	{
+		while (seed < triangleCount && isUsed[seed])
+			++seed;
+		if (seed == triangleCount)
+			break;
+
+		const uint32_t meshletIndex{ static_cast<uint32_t>(meshlets.size()) };
+		Meshlet meshlet{};
+		meshlet.triangleOffset = static_cast<uint32_t>(meshletTriangles.size());
+		meshletVertices.clear();
+
+		Elite::FVector3 centroidSum{};
+		uint32_t triangle{ seed };
+		while (true)
+		{
+			isUsed[triangle] = true;
+			meshletTriangles.push_back(triangle);
+			++meshlet.triangleCount;
+			centroidSum += Elite::FVector3{ GetCentroid(vertices, &indices[size_t(triangle) * 3]) };
+			for (uint32_t corner{}; corner < 3; ++corner)
+			{
+				const uint32_t vertex{ indices[size_t(triangle) * 3 + corner] };
+				if (vertexMeshlet[vertex] == meshletIndex)
+					continue;
+
+				vertexMeshlet[vertex] = meshletIndex;
+				meshletVertices.push_back(vertex);
+				++meshlet.vertexCount;
+			}
+
+			if (meshlet.triangleCount == MaxTriangles)
+				break;
+
+			// The neighbour adding the fewest vertices, ties go to the one closest to the meshlet
+			const Elite::FPoint3 center{ centroidSum / static_cast<float>(meshlet.triangleCount) };
+			uint32_t bestTriangle{ g_InvalidMeshlet };
+			uint32_t bestNewVertices{ UINT32_MAX };
+			float bestDistance{ FLT_MAX };
+			for (uint32_t vertex : meshletVertices)
+			{
+				for (uint32_t i{ adjacencyOffsets[vertex] }; i < adjacencyOffsets[vertex + 1]; ++i)
+				{
+					const uint32_t candidate{ adjacency[i] };
+					if (isUsed[candidate])
+						continue;
+
+					const uint32_t newVertices{ countNewVertices(candidate, meshletIndex) };
+					if (meshlet.vertexCount + newVertices > MaxVertices || newVertices > bestNewVertices)
+						continue;
+
+					const float distance{ Elite::SqrMagnitude(GetCentroid(vertices, &indices[size_t(candidate) * 3]) - center) };
+					if (newVertices < bestNewVertices || distance < bestDistance)
+					{
+						bestTriangle = candidate;
+						bestNewVertices = newVertices;
+						bestDistance = distance;
+					}
+				}
+			}
+
+			// Surrounded by used triangles or full, the next seed starts a new meshlet
+			if (bestTriangle == g_InvalidMeshlet)
+				break;
+			triangle = bestTriangle;
+		}
+
+		ComputeBounds(meshlet, vertices, indices, &meshletTriangles[meshlet.triangleOffset], meshletVertices);
+		meshlets.push_back(meshlet);
+	}
+}
+
+bool Meshlets::IsOutsideFrustum(const Meshlet& meshlet, const Elite::FVector4* pPlanes)
+{
+	for (uint32_t i{}; i < 6; ++i)
+	{
+		const Elite::FVector4& plane{ pPlanes[i] };
+		if (plane.x * meshlet.center.x + plane.y * meshlet.center.y + plane.z * meshlet.center.z + plane.w < -meshlet.radius)
+			return true;
+	}
+	return false;
+}
+
+bool Meshlets::IsBackfacing(const Meshlet& meshlet, const Elite::FPoint3& cameraPosition, bool isFlipped)
+{
+	const Elite::FVector3 viewDirection{ meshlet.center - cameraPosition };
+	const Elite::FVector3 axis{ isFlipped ? -meshlet.coneAxis : meshlet.coneAxis };
+	return Elite::Dot(viewDirection, axis) >= meshlet.coneCutoff * Elite::Magnitude(viewDirection) + meshlet.radius;
+}
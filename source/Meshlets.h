@@ -0,0 +1,37 @@
+#pragma once
+#include <span>
+#include <vector>
+#include "structs.h"
+
+// Splits the triangles into small clusters (meshlets) that can be culled as a whole.
+// Meshlets grow greedily over the vertex to triangle adjacency, so they stay compact and their normal cones narrow.
+// The index buffer is left alone, every meshlet lists its triangles in a separate array.
+namespace Meshlets
+{
+	constexpr uint32_t MaxVertices{ 64 };
+	constexpr uint32_t MaxTriangles{ 124 };
+
+	struct Meshlet
+	{
+		// Range in the meshlet triangle array, which holds triangle numbers into the index buffer
+		uint32_t triangleOffset;
+		uint32_t triangleCount;
+		uint32_t vertexCount;
+
+		// Bounding sphere, in mesh space
+		Elite::FPoint3 center;
+		float radius;
+
+		// Normal cone of the front faces, coneCutoff 1 never culls (the normals spread over more than a hemisphere)
+		Elite::FVector3 coneAxis;
+		float coneCutoff;
+	};
+
+	// Appends to meshlets and meshletTriangles, the triangle numbers count from the start of indices
+	void Build(std::span<const Vertex_Input> vertices, std::span<const uint32_t> indices, std::vector<Meshlet>& meshlets, std::vector<uint32_t>& meshletTriangles);
+
+	// pPlanes as given by Elite::ExtractFrustumPlanes
+	[[nodiscard]] bool IsOutsideFrustum(const Meshlet& meshlet, const Elite::FVector4* pPlanes);
+	// True when every triangle faces away from the camera, flipped when the front faces are the ones being culled
+	[[nodiscard]] bool IsBackfacing(const Meshlet& meshlet, const Elite::FPoint3& cameraPosition, bool isFlipped = false);
+}
@@ -0,0 +1,299 @@
+#include "pch.h"
+#include "OcclusionBuffer.h"
+#include <xmmintrin.h>
+#include "Mesh.h"
+#include "RenderQueue.h"
+#include "ThreadPool.h"
+
+namespace
+{
+	// A few steps of float precision around 1, where the depth of everything but the closest meshes ends up
+	constexpr float g_DepthBias{ 1e-6f };
+
+	// Column vectors, so the clip position is the columns weighted by x, y, z and 1
+	struct SimdMatrix
+	{
+		__m128 columns[4];
+
+		explicit SimdMatrix(const Elite::FMatrix4& matrix)
+			: columns{ _mm_loadu_ps(matrix.data[0]), _mm_loadu_ps(matrix.data[1]), _mm_loadu_ps(matrix.data[2]), _mm_loadu_ps(matrix.data[3]) }
+		{
+		}
+
+		[[nodiscard]] Elite::FPoint4 Transform(const Elite::FPoint3& point) const
+		{
+			const __m128 clip{ _mm_add_ps(_mm_add_ps(_mm_mul_ps(columns[0], _mm_set1_ps(point.x)), _mm_mul_ps(columns[1], _mm_set1_ps(point.y))),
+				_mm_add_ps(_mm_mul_ps(columns[2], _mm_set1_ps(point.z)), columns[3])) };
+			Elite::FPoint4 result;
+			_mm_storeu_ps(result.data, clip);
+			return result;
+		}
+	};
+
+	// Clip space to pixels, y down like the software rasterizer, z over w as depth
+	Elite::FPoint3 ToScreen(const Elite::FPoint4& clip)
+	{
+		const float inverseW{ 1.f / clip.w };
+		return Elite::FPoint3{ (clip.x * inverseW + 1.f) * 0.5f * OcclusionBuffer::Width, (1.f - clip.y * inverseW) * 0.5f * OcclusionBuffer::Height,
+			clip.z * inverseW };
+	}
+
+	// Screen rectangle and nearest depth of the corners of a box, false when the box reaches in front of the near plane
+	bool ProjectBox(const SimdMatrix& worldViewProjection, const Elite::FPoint3& boundsMin, const Elite::FPoint3& boundsMax,
+		Elite::FPoint3& screenMin, Elite::FPoint3& screenMax)
+	{
+		screenMin = Elite::FPoint3{ FLT_MAX, FLT_MAX, FLT_MAX };
+		screenMax = Elite::FPoint3{ -FLT_MAX, -FLT_MAX, -FLT_MAX };
+		for (uint32_t corner{}; corner < 8; ++corner)
+		{
+			const Elite::FPoint4 clip{ worldViewProjection.Transform(Elite::FPoint3{ corner & 1 ? boundsMax.x : boundsMin.x,
+				corner & 2 ? boundsMax.y : boundsMin.y, corner & 4 ? boundsMax.z : boundsMin.z }) };
+			if (clip.z < 0.f)
+				return false;
+
+			const Elite::FPoint3 screen{ ToScreen(clip) };
+			for (uint8_t axis{}; axis < 3; ++axis)
+			{
+				screenMin[axis] = std::min(screenMin[axis], screen[axis]);
+				screenMax[axis] = std::max(screenMax[axis], screen[axis]);
+			}
+		}
+		return true;
+	}
+}
+
+OcclusionBuffer::OcclusionBuffer(ThreadPool* pThreadPool)
+	: m_pThreadPool{ pThreadPool }
+	, m_Depth(size_t(Width) * Height, 1.f)
+	, m_CullMode{ CullMode::backface }
+{
+}
+
+void OcclusionBuffer::BeginCull(const RenderQueue& queue, CullMode cullMode)
+{
+	m_CullMode = cullMode;
+	m_pIsRenderClaimed = std::make_shared<std::atomic<bool>>(false);
+	m_RenderJob = m_pThreadPool->Enqueue([this, &queue, pIsClaimed = m_pIsRenderClaimed]()
+		{
+			if (!pIsClaimed->exchange(true))
+				RenderOccluders(queue);
+		});
+}
+
+void OcclusionBuffer::EndCull(RenderQueue& queue)
+{
+	// The pool runs its jobs in order, the occluder job can sit behind a whole mesh load
+	if (!m_pIsRenderClaimed->exchange(true))
+		RenderOccluders(queue);
+	else
+		m_RenderJob.get();
+	m_RenderJob = {};
+
+	// Ranges never straddle two batches, all the instances of a range share the mesh
+	m_IsVisible.assign(queue.GetWorldMatrices().size(), 1);
+	m_InstanceRanges.clear();
+	for (const RenderQueue::Batch& batch : queue.GetBatches())
+	{
+		const uint32_t endInstance{ batch.firstInstance + batch.instanceCount };
+		for (uint32_t first{ batch.firstInstance }; first < endInstance; first += m_InstancesPerJob)
+			m_InstanceRanges.emplace_back(first, std::min(first + m_InstancesPerJob, endInstance));
+	}
+
+	// The batch of a range is the last one starting at or before it
+	const std::span<const RenderQueue::Batch> batches{ queue.GetBatches() };
+	m_pThreadPool->ParallelFor(m_InstanceRanges.size(), [this, &queue, batches](size_t i)
+		{
+			const auto [first, end] = m_InstanceRanges[i];
+			const auto batch{ std::upper_bound(batches.begin(), batches.end(), first,
+				[](uint32_t instance, const RenderQueue::Batch& batch) { return instance < batch.firstInstance; }) - 1 };
+			TestInstances(*batch->pMesh, queue, first, end);
+		});
+
+	queue.RemoveOccluded(m_IsVisible);
+}
+
+void OcclusionBuffer::RenderOccluders(const RenderQueue& queue)
+{
+	// On a pool job or in EndCull, ParallelFor lets either take part in both passes
+	const std::span<const RenderQueue::Occluder> occluders{ queue.GetOccluders() };
+	const std::span<const Elite::FMatrix4> worldViewProjections{ queue.GetWorldViewProjections() };
+	m_Occluders.resize(occluders.size());
+	m_pThreadPool->ParallelFor(occluders.size(), [this, occluders, worldViewProjections](size_t i)
+		{
+			TransformOccluder(*occluders[i].pMesh, worldViewProjections[occluders[i].instance], m_Occluders[i]);
+		});
+
+	m_pThreadPool->ParallelFor(Height / m_BandHeight, [this, &queue](size_t band)
+		{
+			const uint32_t firstRow{ static_cast<uint32_t>(band) * m_BandHeight };
+			RenderBand(queue, firstRow, firstRow + m_BandHeight);
+		});
+}
+
+void OcclusionBuffer::TransformOccluder(const Mesh& mesh, const Elite::FMatrix4& worldViewProjection, TransformedOccluder& occluder) const
+{
+	const SimdMatrix matrix{ worldViewProjection };
+
+	// An occluder off screen is never transformed, the box says so first
+	Elite::FPoint3 screenMin, screenMax;
+	if (!ProjectBox(matrix, mesh.GetBoundsMin(), mesh.GetBoundsMax(), screenMin, screenMax))
+	{
+		screenMin.y = 0.f;
+		screenMax.y = float(Height);
+	}
+	else if (screenMax.y < 0.f || screenMin.y > float(Height) || screenMax.x < 0.f || screenMin.x > float(Width))
+	{
+		occluder.isOnScreen = false;
+		return;
+	}
+	occluder.screenMinY = screenMin.y;
+	occluder.screenMaxY = screenMax.y;
+	occluder.isOnScreen = true;
+
+	// Once per occluder, every band draws from these
+	const std::span<const Vertex_Input> vertices{ mesh.GetVertexBuffer() };
+	occluder.clipPositions.resize(vertices.size());
+	for (size_t i{}; i < vertices.size(); ++i)
+		occluder.clipPositions[i] = matrix.Transform(vertices[i].Position.xyz);
+}
+
+void OcclusionBuffer::RenderBand(const RenderQueue& queue, uint32_t firstRow, uint32_t endRow)
+{
+	std::fill(m_Depth.begin() + size_t(firstRow) * Width, m_Depth.begin() + size_t(endRow) * Width, 1.f);
+
+	const std::span<const RenderQueue::Occluder> occluders{ queue.GetOccluders() };
+	for (size_t i{}; i < occluders.size(); ++i)
+		RenderOccluder(*occluders[i].pMesh, m_Occluders[i], firstRow, endRow);
+}
+
+void OcclusionBuffer::RenderOccluder(const Mesh& mesh, const TransformedOccluder& occluder, uint32_t firstRow, uint32_t endRow)
+{
+	// Most occluders miss most bands
+	if (!occluder.isOnScreen || occluder.screenMaxY < float(firstRow) || occluder.screenMinY > float(endRow))
+		return;
+
+	const std::vector<Elite::FPoint4>& clipPositions{ occluder.clipPositions };
+	const std::span<const uint32_t> indices{ mesh.GetIndexBuffer() };
+	const MeshLod& meshLod{ mesh.GetLod(0) };
+	for (uint32_t i{ meshLod.indexOffset }; i + 2 < meshLod.indexOffset + meshLod.indexCount; i += 3)
+		RenderTriangle(clipPositions[indices[i]], clipPositions[indices[i + 1]], clipPositions[indices[i + 2]], firstRow, endRow);
+}
+
+void OcclusionBuffer::RenderTriangle(const Elite::FPoint4& v0, const Elite::FPoint4& v1, const Elite::FPoint4& v2, uint32_t firstRow, uint32_t endRow)
+{
+	// Clipping would only add occluder area, a triangle through the near plane is left out instead
+	if (v0.z < 0.f || v1.z < 0.f || v2.z < 0.f)
+		return;
+
+	const Elite::FPoint3 screen[3]{ ToScreen(v0), ToScreen(v1), ToScreen(v2) };
+	const int minX{ std::max(int(floorf(std::min({ screen[0].x, screen[1].x, screen[2].x }))), 0) & ~3 };
+	const int maxX{ std::min(int(ceilf(std::max({ screen[0].x, screen[1].x, screen[2].x }))), int(Width)) };
+	const int minY{ std::max(int(floorf(std::min({ screen[0].y, screen[1].y, screen[2].y }))), int(firstRow)) };
+	const int maxY{ std::min(int(ceilf(std::max({ screen[0].y, screen[1].y, screen[2].y }))), int(endRow)) };
+	if (minX >= maxX || minY >= maxY)
+		return;
+
+	// Relative to the corner of the box and in double, far away depths are all close to 1 and the float
+	// rounding of whole screen coordinates would be bigger than the differences between them
+	double x[3], y[3];
+	for (uint32_t i{}; i < 3; ++i)
+	{
+		x[i] = double(screen[i].x) - minX;
+		y[i] = double(screen[i].y) - minY;
+	}
+	const double area{ (x[1] - x[0]) * (y[2] - y[0]) - (y[1] - y[0]) * (x[2] - x[0]) };
+	if (area == 0.0)
+		return;
+
+	// Same winding as the software rasterizer, backface culling keeps the triangles with a negative area
+	if ((m_CullMode == CullMode::backface && area > 0.0) || (m_CullMode == CullMode::frontface && area < 0.0))
+		return;
+
+	// Edge i is opposite vertex i, edge(x, y) = a x + b y + c is positive inside whatever the winding. The bias
+	// moves every edge inwards by half a pixel along both axes, so only pixels that are covered completely pass.
+	// Depth is a plane in screen space, the bias moves it to its farthest point in the pixel.
+	const double sign{ area > 0.0 ? 1.0 : -1.0 };
+	float a[3], b[3], c[3];
+	double depthA{}, depthB{};
+	for (uint32_t i{}; i < 3; ++i)
+	{
+		const uint32_t from{ (i + 1) % 3 };
+		const uint32_t to{ (i + 2) % 3 };
+		const double edgeA{ sign * (y[from] - y[to]) };
+		const double edgeB{ sign * (x[to] - x[from]) };
+		a[i] = float(edgeA);
+		b[i] = float(edgeB);
+		c[i] = float(-(edgeA * x[from] + edgeB * y[from]) - 0.5 * (std::abs(edgeA) + std::abs(edgeB)));
+		depthA += edgeA * screen[i].z / std::abs(area);
+		depthB += edgeB * screen[i].z / std::abs(area);
+	}
+	const float depthC{ float(screen[0].z - depthA * x[0] - depthB * y[0] + 0.5 * (std::abs(depthA) + std::abs(depthB))) + g_DepthBias };
+
+	const __m128 zero{ _mm_setzero_ps() };
+	const __m128 columnOffsets{ _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f) };
+	const __m128 edgeA[3]{ _mm_set1_ps(a[0]), _mm_set1_ps(a[1]), _mm_set1_ps(a[2]) };
+	const __m128 planeA{ _mm_set1_ps(float(depthA)) };
+	for (int row{ minY }; row < maxY; ++row)
+	{
+		const float centerY{ float(row - minY) + 0.5f };
+		const __m128 edgeRow[3]{ _mm_set1_ps(b[0] * centerY + c[0]), _mm_set1_ps(b[1] * centerY + c[1]), _mm_set1_ps(b[2] * centerY + c[2]) };
+		const __m128 planeRow{ _mm_set1_ps(float(depthB) * centerY + depthC) };
+		float* pRow{ m_Depth.data() + size_t(row) * Width };
+
+		// Four pixels at a time, the buffer is a multiple of four wide and minX is aligned to four
+		for (int column{ minX }; column < maxX; column += 4)
+		{
+			const __m128 centerX{ _mm_add_ps(_mm_set1_ps(float(column - minX)), columnOffsets) };
+			__m128 isCovered{ _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(edgeA[0], centerX), edgeRow[0]), zero) };
+			isCovered = _mm_and_ps(isCovered, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(edgeA[1], centerX), edgeRow[1]), zero));
+			isCovered = _mm_and_ps(isCovered, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(edgeA[2], centerX), edgeRow[2]), zero));
+			if (_mm_movemask_ps(isCovered) == 0)
+				continue;
+
+			const __m128 depth{ _mm_loadu_ps(pRow + column) };
+			const __m128 triangleDepth{ _mm_min_ps(depth, _mm_add_ps(_mm_mul_ps(planeA, centerX), planeRow)) };
+			_mm_storeu_ps(pRow + column, _mm_or_ps(_mm_and_ps(isCovered, triangleDepth), _mm_andnot_ps(isCovered, depth)));
+		}
+	}
+}
+
+void OcclusionBuffer::TestInstances(const Mesh& mesh, const RenderQueue& queue, uint32_t firstInstance, uint32_t endInstance)
+{
+	const std::span<const Elite::FMatrix4> worldViewProjections{ queue.GetWorldViewProjections() };
+	for (uint32_t i{ firstInstance }; i < endInstance; ++i)
+		m_IsVisible[i] = IsVisible(mesh, worldViewProjections[i]);
+}
+
+bool OcclusionBuffer::IsVisible(const Mesh& mesh, const Elite::FMatrix4& worldViewProjection) const
+{
+	// The mesh box turns with the instance, so it is tighter than the box of the scene hierarchy
+	Elite::FPoint3 screenMin, screenMax;
+	if (!ProjectBox(SimdMatrix{ worldViewProjection }, mesh.GetBoundsMin(), mesh.GetBoundsMax(), screenMin, screenMax))
+		return true;
+
+	// Every pixel the box touches, part of a pixel is enough to show up
+	const int minX{ std::max(int(floorf(screenMin.x)), 0) };
+	const int maxX{ std::min(int(ceilf(screenMax.x)), int(Width)) };
+	const int minY{ std::max(int(floorf(screenMin.y)), 0) };
+	const int maxY{ std::min(int(ceilf(screenMax.y)), int(Height)) };
+	if (minX >= maxX || minY >= maxY)
+		return true;
+
+	// Visible as soon as one pixel has nothing in front of the nearest corner
+	const __m128 nearestDepth{ _mm_set1_ps(screenMin.z) };
+	const __m128 columns{ _mm_setr_ps(0.f, 1.f, 2.f, 3.f) };
+	const __m128 firstColumn{ _mm_set1_ps(float(minX)) };
+	const __m128 endColumn{ _mm_set1_ps(float(maxX)) };
+	for (int y{ minY }; y < maxY; ++y)
+	{
+		const float* pRow{ m_Depth.data() + size_t(y) * Width };
+		for (int x{ minX & ~3 }; x < maxX; x += 4)
+		{
+			const __m128 column{ _mm_add_ps(_mm_set1_ps(float(x)), columns) };
+			const __m128 isInside{ _mm_and_ps(_mm_cmpge_ps(column, firstColumn), _mm_cmplt_ps(column, endColumn)) };
+			if (_mm_movemask_ps(_mm_and_ps(isInside, _mm_cmpge_ps(_mm_loadu_ps(pRow + x), nearestDepth))) != 0)
+				return true;
+		}
+	}
+	return false;
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <atomic>
+#include <future>
+#include <memory>
+#include <vector>
+#include "structs.h"
+
+class Mesh;
+class RenderQueue;
+class ThreadPool;
+
+// Small depth buffer of the nearest occluders, rasterized on the CPU so the instances they hide never reach the GPU.
+// An occluder only writes the pixels it covers completely, at the farthest depth it has inside them, and an instance
+// is only culled when its projected box lies behind the buffer everywhere. Occluders are drawn from the full mesh, a
+// simplified level can reach past its silhouette. The test can miss occlusion, but it never removes something that
+// would have shown up on screen.
+class OcclusionBuffer final
+{
+public:
+	static constexpr uint32_t Width{ 256 };
+	static constexpr uint32_t Height{ 128 };
+
+	explicit OcclusionBuffer(ThreadPool* pThreadPool);
+	~OcclusionBuffer() = default;
+
+	OcclusionBuffer(const OcclusionBuffer&) = delete;
+	OcclusionBuffer(OcclusionBuffer&&) noexcept = delete;
+	OcclusionBuffer& operator=(const OcclusionBuffer&) = delete;
+	OcclusionBuffer& operator=(OcclusionBuffer&&) noexcept = delete;
+
+	// Starts drawing the occluders of the queue on a worker thread and returns right away: every occluder is
+	// transformed once, then each band of rows rasterizes all of them. The queue must stay as it is until EndCull.
+	// Only the faces the cull mode keeps occlude, like on the GPU.
+	void BeginCull(const RenderQueue& queue, CullMode cullMode);
+	// Draws the occluders itself when no worker has picked them up yet (the pool may be busy loading assets), then tests
+	// the queued instances against the buffer, helped by the workers, and drops the hidden ones
+	void EndCull(RenderQueue& queue);
+
+	// Nearest occluder depth (z over w) per pixel, 1 where nothing was drawn
+	[[nodiscard]] const std::vector<float>& GetDepth() const { return m_Depth; }
+
+private:
+	static constexpr uint32_t m_BandHeight{ 32 };
+	static constexpr uint32_t m_InstancesPerJob{ 256 };
+
+	// An occluder in clip space, shared by every band
+	struct TransformedOccluder
+	{
+		std::vector<Elite::FPoint4> clipPositions;
+		// Rows the mesh box covers, the whole screen when it reaches in front of the near plane
+		float screenMinY;
+		float screenMaxY;
+		bool isOnScreen;
+	};
+
+	ThreadPool* m_pThreadPool;
+	std::vector<float> m_Depth;
+	// One per occluder of the queue, the lists keep their memory from frame to frame
+	std::vector<TransformedOccluder> m_Occluders;
+	std::vector<uint8_t> m_IsVisible;
+	// [first, end) instances of one batch per test
+	std::vector<std::pair<uint32_t, uint32_t>> m_InstanceRanges;
+	std::future<void> m_RenderJob;
+	// Set by whoever draws the occluders of this frame, the job or EndCull. A fresh one per frame, so a job still
+	// queued from an earlier frame finds its own flag taken and returns without touching anything.
+	std::shared_ptr<std::atomic<bool>> m_pIsRenderClaimed;
+	CullMode m_CullMode;
+
+	void RenderOccluders(const RenderQueue& queue);
+	void TransformOccluder(const Mesh& mesh, const Elite::FMatrix4& worldViewProjection, TransformedOccluder& occluder) const;
+	void RenderBand(const RenderQueue& queue, uint32_t firstRow, uint32_t endRow);
+	void RenderOccluder(const Mesh& mesh, const TransformedOccluder& occluder, uint32_t firstRow, uint32_t endRow);
+	void RenderTriangle(const Elite::FPoint4& v0, const Elite::FPoint4& v1, const Elite::FPoint4& v2, uint32_t firstRow, uint32_t endRow);
+	void TestInstances(const Mesh& mesh, const RenderQueue& queue, uint32_t firstInstance, uint32_t endInstance);
+	[[nodiscard]] bool IsVisible(const Mesh& mesh, const Elite::FMatrix4& worldViewProjection) const;
+};
@@ -0,0 +1,132 @@
+#include "pch.h"
+#include "RenderQueue.h"
+#include <cstring>
+#include "ECamera.h"
+#include "Mesh.h"
+#include "Scene.h"
+
+namespace
+{
+	// Opaque key, most significant first: material (11 bits), mesh (14), level of detail (2), depth (36).
+	// Transparent key: the top bit, then the inverted depth (32), material, mesh and level of detail.
+	constexpr uint64_t g_TransparentBit{ 1ull << 63 };
+	constexpr uint32_t g_MaterialShift{ 52 };
+	constexpr uint32_t g_MeshShift{ 38 };
+	constexpr uint32_t g_LodShift{ 36 };
+	constexpr uint32_t g_TransparentDepthShift{ 27 };
+
+	// The bits of a positive float sort like the float itself
+	uint32_t GetDepthBits(float depth)
+	{
+		depth = std::max(depth, 0.f);
+		uint32_t bits;
+		std::memcpy(&bits, &depth, sizeof(float));
+		return bits;
+	}
+}
+
+void RenderQueue::Build(Scene& scene, const Elite::Camera& camera)
+{
+	m_Items.clear();
+	m_Batches.clear();
+	m_WorldMatrices.clear();
+	m_WorldViewProjections.clear();
+	m_VisibleInstances.clear();
+	m_OccluderCandidates.clear();
+	m_Occluders.clear();
+	m_OccludedCount = 0;
+
+	Elite::FMatrix4 worldToView{ camera.GetWorldToView() };
+	const Elite::FMatrix4& projection{ camera.GetProjectionMatrix() };
+	const Elite::FMatrix4& viewProjection{ camera.GetViewProjection() };
+	const Elite::FVector3 cameraPosition{ camera.GetPosition() };
+
+	scene.Cull(camera.GetFrustumPlanes(), m_VisibleInstances);
+	const std::span<MeshInstance> instances{ scene.GetInstances() };
+	m_CulledCount = static_cast<uint32_t>(instances.size() - m_VisibleInstances.size());
+	for (uint32_t i : m_VisibleInstances)
+	{
+		MeshInstance& instance{ instances[i] };
+		if (!instance.pMesh || instance.pMesh->GetLodCount() == 0)
+			continue;
+
+		instance.UpdateTransforms(viewProjection, camera.GetVersion());
+
+		// Bounding sphere of the bounding box, in world space
+		const Mesh& mesh{ *instance.pMesh };
+		const Elite::FVector3 halfExtent{ (mesh.GetBoundsMax() - mesh.GetBoundsMin()) * 0.5f };
+		const Elite::FPoint3 center{ (instance.world * Elite::FPoint4{ mesh.GetBoundsMin() + halfExtent }).xyz };
+		const float radius{ Elite::Magnitude(halfExtent) };
+
+		// Projected radius over half the screen height, the camera inside the sphere always gets the full mesh
+		const float distance{ Elite::Magnitude(Elite::FVector3{ center } - cameraPosition) };
+		const float screenSize{ distance > radius ? radius * projection.data[1][1] / distance : FLT_MAX };
+		instance.lod = mesh.SelectLod(screenSize, instance.lod);
+
+		const uint32_t depthBits{ GetDepthBits((worldToView * Elite::FPoint4{ center }).z) };
+		const uint64_t material{ instance.material % Scene::MaxMaterials };
+		const uint64_t key{ scene.GetMaterial(instance.material).isTransparent
+			? g_TransparentBit | uint64_t(~depthBits) << g_TransparentDepthShift | material << 16 | uint64_t(instance.meshId) << 2 | instance.lod
+			: material << g_MaterialShift | uint64_t(instance.meshId) << g_MeshShift | uint64_t(instance.lod) << g_LodShift | depthBits };
+		m_Items.push_back(Item{ key, i });
+	}
+
+	std::sort(m_Items.begin(), m_Items.end(), [](const Item& lhs, const Item& rhs) { return lhs.key < rhs.key; });
+
+	m_WorldMatrices.reserve(m_Items.size());
+	m_WorldViewProjections.reserve(m_Items.size());
+	for (const Item& item : m_Items)
+	{
+		const MeshInstance& instance{ instances[item.instance] };
+		const bool isTransparent{ (item.key & g_TransparentBit) != 0 };
+		if (m_Batches.empty() || m_Batches.back().pMesh != instance.pMesh || m_Batches.back().material != instance.material
+			|| m_Batches.back().lod != instance.lod || m_Batches.back().isTransparent != isTransparent)
+		{
+			m_Batches.push_back(Batch{ instance.pMesh, instance.material, instance.lod, isTransparent, static_cast<uint32_t>(m_WorldMatrices.size()), 0 });
+		}
+
+		// The depth is the low half of an opaque key
+		if (instance.isOccluder && !isTransparent)
+			m_OccluderCandidates.emplace_back(static_cast<uint32_t>(item.key), Occluder{ instance.pMesh, static_cast<uint32_t>(m_WorldMatrices.size()) });
+
+		++m_Batches.back().instanceCount;
+		m_WorldMatrices.push_back(instance.world);
+		m_WorldViewProjections.push_back(instance.worldViewProjection);
+	}
+
+	const size_t occluderCount{ std::min(m_OccluderCandidates.size(), size_t(m_MaxOccluders)) };
+	std::partial_sort(m_OccluderCandidates.begin(), m_OccluderCandidates.begin() + occluderCount, m_OccluderCandidates.end(),
+		[](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+	for (size_t i{}; i < occluderCount; ++i)
+		m_Occluders.push_back(m_OccluderCandidates[i].second);
+}
+
+void RenderQueue::RemoveOccluded(std::span<const uint8_t> isVisible)
+{
+	uint32_t instanceCount{};
+	uint32_t batchCount{};
+	for (const Batch& batch : m_Batches)
+	{
+		Batch compacted{ batch };
+		compacted.firstInstance = instanceCount;
+		for (uint32_t i{ batch.firstInstance }; i < batch.firstInstance + batch.instanceCount; ++i)
+		{
+			if (!isVisible[i])
+				continue;
+
+			m_WorldMatrices[instanceCount] = m_WorldMatrices[i];
+			m_WorldViewProjections[instanceCount++] = m_WorldViewProjections[i];
+		}
+
+		compacted.instanceCount = instanceCount - compacted.firstInstance;
+		if (compacted.instanceCount > 0)
+			m_Batches[batchCount++] = compacted;
+	}
+
+	m_OccludedCount = static_cast<uint32_t>(m_WorldMatrices.size()) - instanceCount;
+	m_WorldMatrices.resize(instanceCount);
+	m_WorldViewProjections.resize(instanceCount);
+	m_Batches.resize(batchCount);
+	// Their draw indices are stale now, they were only needed to fill the buffer
+	m_Occluders.clear();
+}
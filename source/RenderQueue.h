@@ -0,0 +1,83 @@
+#pragma once
+#include <span>
+#include <vector>
+#include "structs.h"
+
+class Mesh;
+class Scene;
+
+namespace Elite
+{
+	class Camera;
+}
+
+// What gets drawn this frame. Opaque instances are sorted by material, mesh and level of detail so state changes
+// are rare and instances of the same mesh end up next to each other, then front to back for the depth test.
+// Transparent instances come last, back to front. Runs of the same mesh form one batch, a single instanced draw.
+class RenderQueue final
+{
+public:
+	struct Batch
+	{
+		Mesh* pMesh;
+		uint32_t material;
+		uint32_t lod;
+		bool isTransparent;
+		// Range in GetWorldMatrices
+		uint32_t firstInstance;
+		uint32_t instanceCount;
+	};
+
+	// Instance of GetWorldMatrices that hides what is behind it, always drawn from the full mesh (level 0)
+	struct Occluder
+	{
+		Mesh* pMesh;
+		uint32_t instance;
+	};
+
+	RenderQueue() = default;
+	~RenderQueue() = default;
+
+	RenderQueue(const RenderQueue&) = delete;
+	RenderQueue(RenderQueue&&) noexcept = delete;
+	RenderQueue& operator=(const RenderQueue&) = delete;
+	RenderQueue& operator=(RenderQueue&&) noexcept = delete;
+
+	// Culls the instances against the view frustum through the scene hierarchy, picks their level of detail and sorts what is left
+	void Build(Scene& scene, const Elite::Camera& camera);
+	// Drops the queued instances whose flag is 0 (indexed like GetWorldMatrices) and the batches left empty
+	void RemoveOccluded(std::span<const uint8_t> isVisible);
+
+	[[nodiscard]] std::span<const Batch> GetBatches() const { return m_Batches; }
+	// World matrix of every queued instance in draw order, uploaded once for all the batches
+	[[nodiscard]] std::span<const Elite::FMatrix4> GetWorldMatrices() const { return m_WorldMatrices; }
+	// Same order, cached by the instances so only what moved or a moving camera costs a multiply
+	[[nodiscard]] std::span<const Elite::FMatrix4> GetWorldViewProjections() const { return m_WorldViewProjections; }
+	// Hidden or outside the frustum
+	[[nodiscard]] uint32_t GetCulledCount() const { return m_CulledCount; }
+	// The opaque occluders of the scene that made it into the queue, nearest first
+	[[nodiscard]] std::span<const Occluder> GetOccluders() const { return m_Occluders; }
+	// Removed by the last RemoveOccluded
+	[[nodiscard]] uint32_t GetOccludedCount() const { return m_OccludedCount; }
+
+private:
+	// Rasterizing more costs more than the little extra they hide
+	static constexpr uint32_t m_MaxOccluders{ 8 };
+
+	struct Item
+	{
+		uint64_t key;
+		uint32_t instance;
+	};
+
+	std::vector<uint32_t> m_VisibleInstances;
+	std::vector<Item> m_Items;
+	std::vector<Batch> m_Batches;
+	std::vector<Elite::FMatrix4> m_WorldMatrices;
+	std::vector<Elite::FMatrix4> m_WorldViewProjections;
+	// Every opaque occluder in the queue with its depth, the nearest end up in m_Occluders
+	std::vector<std::pair<uint32_t, Occluder>> m_OccluderCandidates;
+	std::vector<Occluder> m_Occluders;
+	uint32_t m_CulledCount{};
+	uint32_t m_OccludedCount{};
+};
@@ -3,10 +3,18 @@
 //---------------------------------------
 // Global Variables
 //---------------------------------------
-float4x4 gWorldViewProj : WorldViewProjection;
-float4x4 gWorldMatrix : WorldMatrix;
+float4x4 gViewProj : ViewProjection;
 float4x4 gViewInverseMatrix : ViewInverseMatrix;
 
+// World matrix per instance, uploaded as FMatrix4 (columns first) so row_major gives the same matrix SetMatrix does.
+// SV_InstanceID restarts at 0 every draw, gInstanceOffset is where the draw's range starts.
+StructuredBuffer<row_major float4x4> gInstanceWorlds : InstanceWorlds;
+uint gInstanceOffset : InstanceOffset;
+
+// Packed positions are unorm16 relative to the mesh bounds
+float3 gBoundsMin : BoundsMin;
+float3 gBoundsExtent : BoundsExtent;
+
 Texture2D gDiffuseMap : DiffuseMap;
 Texture2D gNormalMap : NormalMap;
 Texture2D gSpecularMap : SpecularMap;
@@ -24,6 +32,15 @@ struct VS_INPUT
 	float3 ViewDirection : VIEWDIR;
 };
 
+// Vertex_Packed, the view direction is not stored
+struct VS_PACKED_INPUT
+{
+	float4 Position : POSITION;	// R16G16B16A16_UNORM, w unused
+	float2 UV : TEXCOORD;		// R16G16_FLOAT
+	float2 Normal : NORMAL;		// R16G16_SNORM octahedral
+	float2 Tangent : TANGENT;	// R16G16_SNORM octahedral
+};
+
 struct VS_OUTPUT
 {
 	float4 Position : SV_POSITION;
@@ -125,18 +142,40 @@ RasterizerState gRasterizerStateNoCulling
 //---------------------------------------
 // Vertex Shader
 //---------------------------------------
-VS_OUTPUT VS(VS_INPUT input)
+VS_OUTPUT TransformVertex(float3 position, float2 uv, float3 normal, float3 tangent, uint instanceID)
 {
+	float4x4 world = gInstanceWorlds[gInstanceOffset + instanceID];
+
 	VS_OUTPUT output = (VS_OUTPUT)0;
-	output.Position = mul(float4(input.Position, 1.0f), gWorldViewProj);
-	output.WorldPosition = mul(float4(input.Position, 1.f), gWorldMatrix);
-	output.UV = input.UV;
-	output.Normal = normalize(mul(input.Normal, (float3x3) gWorldMatrix));
-	output.Tangent = normalize(mul(input.Tangent, (float3x3) gWorldMatrix));
+	output.WorldPosition = mul(float4(position, 1.f), world);
+	output.Position = mul(output.WorldPosition, gViewProj);
+	output.UV = uv;
+	output.Normal = normalize(mul(normal, (float3x3) world));
+	output.Tangent = normalize(mul(tangent, (float3x3) world));
 
 	return output;
 }
 
+VS_OUTPUT VS(VS_INPUT input, uint instanceID : SV_InstanceID)
+{
+	return TransformVertex(input.Position, input.UV, input.Normal, input.Tangent, instanceID);
+}
+
+// Inverse of VertexPacking::EncodeOctahedral
+float3 DecodeOctahedral(float2 encoded)
+{
+	float3 direction = float3(encoded, 1.0f - abs(encoded.x) - abs(encoded.y));
+	float fold = saturate(-direction.z);
+	direction.xy += direction.xy >= 0.0f ? -fold : fold;
+	return normalize(direction);
+}
+
+VS_OUTPUT VS_PACKED(VS_PACKED_INPUT input, uint instanceID : SV_InstanceID)
+{
+	float3 position = gBoundsMin + input.Position.xyz * gBoundsExtent;
+	return TransformVertex(position, input.UV, DecodeOctahedral(input.Normal), DecodeOctahedral(input.Tangent), instanceID);
+}
+
 //---------------------------------------
 // Pixel Shaders
 //---------------------------------------
@@ -259,4 +298,97 @@ technique11 AnisotropicTechnique
 		SetGeometryShader(NULL);
 		SetPixelShader(CompileShader(ps_5_0, PSLinear()));
 	}
+}
+// Point FILTER, packed vertices
+technique11 PointPackedTechnique
+{
+	pass P0
+	{
+		SetRasterizerState(gRasterizerStateBackCulling);
+		SetDepthStencilState(gDepthStencilState, 0);
+		SetBlendState(gBlendState, float4(0.f, 0.f, 0.f, 0.f), 0xFFFFFFFF);
+		SetVertexShader(CompileShader(vs_5_0, VS_PACKED()));
+		SetGeometryShader(NULL);
+		SetPixelShader(CompileShader(ps_5_0, PSPoint()));
+	}
+	pass P1
+	{
+		SetRasterizerState(gRasterizerStateFrontCulling);
+		SetDepthStencilState(gDepthStencilState, 0);
+		SetBlendState(gBlendState, float4(0.f, 0.f, 0.f, 0.f), 0xFFFFFFFF);
+		SetVertexShader(CompileShader(vs_5_0, VS_PACKED()));
+		SetGeometryShader(NULL);
+		SetPixelShader(CompileShader(ps_5_0, PSLinear()));
+	}
+	pass P2
+	{
+		SetRasterizerState(gRasterizerStateNoCulling);
+		SetDepthStencilState(gDepthStencilState, 0);
+		SetBlendState(gBlendState, float4(0.f, 0.f, 0.f, 0.f), 0xFFFFFFFF);
+		SetVertexShader(CompileShader(vs_5_0, VS_PACKED()));
+		SetGeometryShader(NULL);
+		SetPixelShader(CompileShader(ps_5_0, PSLinear()));
+	}
+}
+// LINEAR FILTER, packed vertices
+technique11 LinearPackedTechnique
+{
+	pass P0
+	{
+		SetRasterizerState(gRasterizerStateBackCulling);
+		SetDepthStencilState(gDepthStencilState, 0);
+		SetBlendState(gBlendState, float4(0.f, 0.f, 0.f, 0.f), 0xFFFFFFFF);
+		SetVertexShader(CompileShader(vs_5_0, VS_PACKED()));
+		SetGeometryShader(NULL);
+		SetPixelShader(CompileShader(ps_5_0, PSLinear()));
+	}
+	pass P1
+	{
+		SetRasterizerState(gRasterizerStateFrontCulling);
+		SetDepthStencilState(gDepthStencilState, 0);
+		SetBlendState(gBlendState, float4(0.f, 0.f, 0.f, 0.f), 0xFFFFFFFF);
+		SetVertexShader(CompileShader(vs_5_0, VS_PACKED()));
+		SetGeometryShader(NULL);
+		SetPixelShader(CompileShader(ps_5_0, PSLinear()));
+	}
+	pass P2
+	{
+		SetRasterizerState(gRasterizerStateNoCulling);
+		SetDepthStencilState(gDepthStencilState, 0);
+		SetBlendState(gBlendState, float4(0.f, 0.f, 0.f, 0.f), 0xFFFFFFFF);
+		SetVertexShader(CompileShader(vs_5_0, VS_PACKED()));
+		SetGeometryShader(NULL);
+		SetPixelShader(CompileShader(ps_5_0, PSLinear()));
+	}
+}
+// ANISOTROPIC FILTER, packed vertices
+technique11 AnisotropicPackedTechnique
+{
+	pass P0
+	{
+		SetRasterizerState(gRasterizerStateBackCulling);
+		SetDepthStencilState(gDepthStencilState, 0);
+		SetBlendState(gBlendState, float4(0.f, 0.f, 0.f, 0.f), 0xFFFFFFFF);
+		SetVertexShader(CompileShader(vs_5_0, VS_PACKED()));
+		SetGeometryShader(NULL);
+		SetPixelShader(CompileShader(ps_5_0, PSAnisotropic()));
+	}
+	pass P1
+	{
+		SetRasterizerState(gRasterizerStateFrontCulling);
+		SetDepthStencilState(gDepthStencilState, 0);
+		SetBlendState(gBlendState, float4(0.f, 0.f, 0.f, 0.f), 0xFFFFFFFF);
+		SetVertexShader(CompileShader(vs_5_0, VS_PACKED()));
+		SetGeometryShader(NULL);
+		SetPixelShader(CompileShader(ps_5_0, PSLinear()));
+	}
+	pass P2
+	{
+		SetRasterizerState(gRasterizerStateNoCulling);
+		SetDepthStencilState(gDepthStencilState, 0);
+		SetBlendState(gBlendState, float4(0.f, 0.f, 0.f, 0.f), 0xFFFFFFFF);
+		SetVertexShader(CompileShader(vs_5_0, VS_PACKED()));
+		SetGeometryShader(NULL);
+		SetPixelShader(CompileShader(ps_5_0, PSLinear()));
+	}
 }
\ No newline at end of file
@@ -0,0 +1,123 @@
+#include "pch.h"
+#include "Scene.h"
+#include "Mesh.h"
+
+void MeshInstance::UpdateTransforms(const Elite::FMatrix4& viewProjection, uint32_t currentViewProjectionVersion)
+{
+	if (isWorldDirty)
+	{
+		// Translation times rotation without the multiply
+		world = Elite::FMatrix4{ Elite::MakeRotationY(yaw), position };
+	}
+	else if (viewProjectionVersion == currentViewProjectionVersion)
+		return;
+
+	worldViewProjection = viewProjection * world;
+	viewProjectionVersion = currentViewProjectionVersion;
+	isWorldDirty = false;
+}
+
+uint32_t Scene::AddMaterial(Material material)
+{
+	if (m_Materials.size() == MaxMaterials)
+	{
+		std::cout << "Too many materials, using material 0 instead." << std::endl;
+		return 0;
+	}
+
+	m_Materials.push_back(std::move(material));
+	return static_cast<uint32_t>(m_Materials.size() - 1);
+}
+
+uint32_t Scene::AddInstance(Mesh* pMesh, uint32_t material, const Elite::FVector3& position, float yaw)
+{
+	m_Instances.push_back(MeshInstance{ pMesh, GetMeshId(pMesh), material, position, yaw, 0, true, false });
+	m_IsBvhStale = true;
+	return static_cast<uint32_t>(m_Instances.size() - 1);
+}
+
+void Scene::SetMesh(uint32_t instance, Mesh* pMesh)
+{
+	MeshInstance& meshInstance{ m_Instances[instance] };
+	meshInstance.pMesh = pMesh;
+	meshInstance.meshId = GetMeshId(pMesh);
+	meshInstance.lod = 0;
+	if (!m_IsBvhStale)
+		m_Bvh.Update(instance, GetBounds(meshInstance));
+}
+
+void Scene::SetPosition(uint32_t instance, const Elite::FVector3& position)
+{
+	MeshInstance& meshInstance{ m_Instances[instance] };
+	meshInstance.position = position;
+	meshInstance.isWorldDirty = true;
+	if (!m_IsBvhStale)
+		m_Bvh.Update(instance, GetBounds(meshInstance));
+}
+
+void Scene::SetYaw(uint32_t instance, float yaw)
+{
+	// The bounds cover every yaw, only the matrices change
+	m_Instances[instance].yaw = yaw;
+	m_Instances[instance].isWorldDirty = true;
+}
+
+void Scene::SetVisible(uint32_t instance, bool isVisible)
+{
+	m_Instances[instance].isVisible = isVisible;
+}
+
+void Scene::SetOccluder(uint32_t instance, bool isOccluder)
+{
+	m_Instances[instance].isOccluder = isOccluder;
+}
+
+void Scene::Cull(const Elite::FVector4* pPlanes, std::vector<uint32_t>& instances)
+{
+	if (m_IsBvhStale || m_Bvh.GetUpdateCount() > m_Bvh.GetItemCount())
+	{
+		std::vector<Bvh::Bounds> bounds;
+		bounds.reserve(m_Instances.size());
+		for (const MeshInstance& instance : m_Instances)
+			bounds.push_back(GetBounds(instance));
+		m_Bvh.Build(bounds);
+		m_IsBvhStale = false;
+	}
+	else
+		m_Bvh.Refit();
+
+	const size_t first{ instances.size() };
+	m_Bvh.Cull(pPlanes, instances);
+	instances.erase(std::remove_if(instances.begin() + first, instances.end(), [this](uint32_t instance) { return !m_Instances[instance].isVisible; }),
+		instances.end());
+}
+
+Bvh::Bounds Scene::GetBounds(const MeshInstance& instance) const
+{
+	const Elite::FPoint3 origin{ instance.position };
+	if (!instance.pMesh)
+		return Bvh::Bounds{ origin, origin };
+
+	// Instances only turn around y, a cylinder around the origin of the mesh covers every yaw so turning never refits
+	const Elite::FPoint3& boundsMin{ instance.pMesh->GetBoundsMin() };
+	const Elite::FPoint3& boundsMax{ instance.pMesh->GetBoundsMax() };
+	const float maxX{ std::max(std::abs(boundsMin.x), std::abs(boundsMax.x)) };
+	const float maxZ{ std::max(std::abs(boundsMin.z), std::abs(boundsMax.z)) };
+	const float radius{ sqrtf(maxX * maxX + maxZ * maxZ) };
+	return Bvh::Bounds{
+		Elite::FPoint3{ origin.x - radius, origin.y + boundsMin.y, origin.z - radius },
+		Elite::FPoint3{ origin.x + radius, origin.y + boundsMax.y, origin.z + radius } };
+}
+
+uint32_t Scene::GetMeshId(Mesh* pMesh)
+{
+	const auto it{ m_MeshIds.find(pMesh) };
+	if (it != m_MeshIds.end())
+		return it->second;
+
+	// Past the limit the ids wrap around, those meshes just don't batch as well
+	const uint32_t meshId{ static_cast<uint32_t>(m_Meshes.size()) % MaxMeshes };
+	m_Meshes.push_back(pMesh);
+	m_MeshIds.emplace(pMesh, meshId);
+	return meshId;
+}
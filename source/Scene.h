@@ -0,0 +1,99 @@
+#pragma once
+#include <span>
+#include <unordered_map>
+#include <vector>
+#include "Bvh.h"
+#include "structs.h"
+
+class Mesh;
+class Texture;
+
+// Textures of a surface, missing maps are left as they are in the effect (FireFX only has a diffuse map)
+struct Material
+{
+	std::shared_ptr<Texture> pDiffuseMap;
+	std::shared_ptr<Texture> pNormalMap;
+	std::shared_ptr<Texture> pSpecularMap;
+	std::shared_ptr<Texture> pGlossinessMap;
+	// Drawn after everything opaque, back to front, and skipped by the software rasterizer
+	bool isTransparent;
+};
+
+struct MeshInstance
+{
+	Mesh* pMesh;
+	// Small number per mesh handed out by the scene, sorts cheaper than the pointer
+	uint32_t meshId;
+	uint32_t material;
+	// Set through the scene, which marks the cached matrices dirty
+	Elite::FVector3 position;
+	float yaw;
+	// Level of detail of the last frame, the selection is relative to it
+	uint32_t lod;
+	bool isVisible;
+	// Drawn into the occlusion buffer when it is among the nearest, big solid meshes make good occluders
+	bool isOccluder;
+
+	// Rebuilt by UpdateTransforms, the world matrix when the instance moved or turned, the world-view-projection
+	// when either side changed. An instance that stays put in front of a still camera costs nothing.
+	Elite::FMatrix4 world{ Elite::FMatrix4::Identity() };
+	Elite::FMatrix4 worldViewProjection{ Elite::FMatrix4::Identity() };
+	bool isWorldDirty{ true };
+	uint32_t viewProjectionVersion{};
+
+	// The version of the camera, it changes whenever the view-projection does
+	void UpdateTransforms(const Elite::FMatrix4& viewProjection, uint32_t viewProjectionVersion);
+};
+
+// Every mesh instance in the world. The meshes and textures are owned elsewhere (loader, registry, streamer),
+// the scene only holds what is needed to draw them. A bounding volume hierarchy over the instances culls them
+// against the view, moving an instance only refits the part of the tree above it.
+class Scene final
+{
+public:
+	// The render queue packs these into its sort key
+	static constexpr uint32_t MaxMaterials{ 1 << 11 };
+	static constexpr uint32_t MaxMeshes{ 1 << 14 };
+
+	Scene() = default;
+	~Scene() = default;
+
+	Scene(const Scene&) = delete;
+	Scene(Scene&&) noexcept = delete;
+	Scene& operator=(const Scene&) = delete;
+	Scene& operator=(Scene&&) noexcept = delete;
+
+	[[nodiscard]] uint32_t AddMaterial(Material material);
+	uint32_t AddInstance(Mesh* pMesh, uint32_t material, const Elite::FVector3& position, float yaw = 0.f);
+	// Swaps the mesh of an instance, the streamer replaces the placeholder this way
+	void SetMesh(uint32_t instance, Mesh* pMesh);
+	void SetPosition(uint32_t instance, const Elite::FVector3& position);
+	void SetYaw(uint32_t instance, float yaw);
+	void SetVisible(uint32_t instance, bool isVisible);
+	void SetOccluder(uint32_t instance, bool isOccluder);
+
+	// Appends the visible instances whose bounds touch the frustum (normalized planes, inside positive)
+	void Cull(const Elite::FVector4* pPlanes, std::vector<uint32_t>& instances);
+
+	[[nodiscard]] const Material& GetMaterial(uint32_t material) const { return m_Materials[material]; }
+	[[nodiscard]] const MeshInstance& GetInstance(uint32_t instance) const { return m_Instances[instance]; }
+	// For the per frame state (level of detail, cached matrices), moving and turning go through the setters so the hierarchy and matrices follow
+	[[nodiscard]] std::span<MeshInstance> GetInstances() { return m_Instances; }
+	[[nodiscard]] std::span<const MeshInstance> GetInstances() const { return m_Instances; }
+	// Every mesh that was ever given to an instance, once
+	[[nodiscard]] const std::vector<Mesh*>& GetMeshes() const { return m_Meshes; }
+
+private:
+	std::vector<Material> m_Materials;
+	std::vector<MeshInstance> m_Instances;
+	// m_Meshes[id] is the mesh with that id
+	std::vector<Mesh*> m_Meshes;
+	std::unordered_map<Mesh*, uint32_t> m_MeshIds;
+
+	// Rebuilt when instances were added or once the refits add up to moving every instance
+	Bvh m_Bvh;
+	bool m_IsBvhStale{};
+
+	[[nodiscard]] uint32_t GetMeshId(Mesh* pMesh);
+	[[nodiscard]] Bvh::Bounds GetBounds(const MeshInstance& instance) const;
+};
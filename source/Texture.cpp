@@ -1,17 +1,132 @@
 #include "pch.h"
 #include "Texture.h"
 #include "SDL_image.h"
+#include "BlockCompression.h"
+#include "Hash.h"
+#include "MappedFile.h"
+#include "TextureFile.h"
+#include <atomic>
 
-Texture::Texture(const std::string& filePath, ID3D11Device* pDevice)
+namespace
 {
-	m_pSurface = IMG_Load(filePath.c_str());
+	// Small direct mapped cache of decoded 4x4 blocks, one per sampling thread
+	struct CachedBlock
+	{
+		uint32_t textureId;
+		uint32_t blockIndex;
+		uint32_t texels[BlockCompression::TexelsPerBlock];
+	};
+
+	constexpr uint32_t g_BlockCacheSize{ 128 };
+	thread_local CachedBlock g_BlockCache[g_BlockCacheSize]{};
+
+	// Ids start at 1 so the zero initialized cache entries never match a texture
+	std::atomic<uint32_t> g_NextTextureId{ 1 };
+}
+
+Texture::Texture(const std::string& filePath, ID3D11Device* pDevice, TextureFormat format, AddressMode addressMode)
+	: Texture{ filePath, format, addressMode }
+{
+	Upload(pDevice);
+}
+
+Texture::Texture(const std::string& filePath, TextureFormat format, AddressMode addressMode)
+	: m_pSurface{ nullptr }
+	, m_FilePath{ filePath }
+	, m_Format{ format }
+	, m_BlocksWide{}
+	, m_TextureId{ g_NextTextureId++ }
+	, m_SourceHash{}
+	, m_pBlockData{ nullptr }
+	, m_pTexels{ nullptr }
+	, m_AddressMode{ addressMode }
+	, m_Width{}
+	, m_Height{}
+{
+	if (!TextureFile::IsCookedUpToDate(filePath) || !LoadCooked(TextureFile::GetCookedPath(filePath)))
+		LoadImage(filePath);
+
+	m_FixedScaleU = static_cast<float>(m_Width) * static_cast<float>(1 << m_FixedPointShift);
+	m_FixedScaleV = static_cast<float>(m_Height) * static_cast<float>(1 << m_FixedPointShift);
+	m_IsPowerOfTwo = (m_Width & (m_Width - 1)) == 0 && (m_Height & (m_Height - 1)) == 0;
+	m_BlocksWide = BlockCompression::GetBlockCount(m_Width);
+}
+
+void Texture::LoadImage(const std::string& filePath)
+{
+	// Decoded from the mapping, so the bytes are only read once for both the hash and the image
+	const MappedFile file{ filePath };
+	if (file.IsValid())
+	{
+		m_SourceHash = Hash::Fnv1a(file.GetData(), file.GetSize());
+		m_pSurface = IMG_Load_RW(SDL_RWFromConstMem(file.GetData(), static_cast<int>(file.GetSize())), 1);
+	}
+	if (!m_pSurface)
+	{
+		std::cout << "Error loading texture " << filePath << std::endl;
+		return;
+	}
+
+	m_Width = static_cast<uint32_t>(m_pSurface->w);
+	m_Height = static_cast<uint32_t>(m_pSurface->h);
+
+	// Block compression is only done offline by --cook, an image without an up to date .etex is used as is
+	if (BlockCompression::IsBlockCompressed(m_Format))
+	{
+		std::cout << "Texture " << filePath << " is not cooked, keeping it as RGBA8 (run --cook to block compress it)" << std::endl;
+		m_Format = TextureFormat::rgba8;
+	}
+
+	m_MipData.push_back(D3D11_SUBRESOURCE_DATA{ m_pSurface->pixels, static_cast<UINT>(m_pSurface->pitch), static_cast<UINT>(m_pSurface->h * m_pSurface->pitch) });
+}
+
+bool Texture::LoadCooked(const std::string& cookedPath)
+{
+	auto pMappedFile{ make_unique<MappedFile>(cookedPath) };
+	if (!pMappedFile->IsValid())
+		return false;
+
+	const TextureFile::Header* pHeader;
+	const TextureFile::MipHeader* pMips;
+	if (!TextureFile::Parse(pMappedFile->GetData(), pMappedFile->GetSize(), pHeader, pMips))
+	{
+		std::cout << "Invalid cooked texture " << cookedPath << ", falling back to " << m_FilePath << std::endl;
+		return false;
+	}
+
+	// Cooked for another format, the source image is loaded instead
+	if (static_cast<TextureFormat>(pHeader->format) != m_Format)
+	{
+		std::cout << "Cooked texture " << cookedPath << " has another format, falling back to " << m_FilePath << std::endl;
+		return false;
+	}
+
+	m_Width = pHeader->width;
+	m_Height = pHeader->height;
+	m_SourceHash = Hash::Fnv1a(pMappedFile->GetData(), pMappedFile->GetSize());
+	for (uint32_t i{}; i < pHeader->mipCount; ++i)
+		m_MipData.push_back(D3D11_SUBRESOURCE_DATA{ pMappedFile->GetData() + pMips[i].offset, pMips[i].rowPitch, pMips[i].size });
+
+	if (BlockCompression::IsBlockCompressed(m_Format))
+		m_pBlockData = static_cast<const uint8_t*>(m_MipData[0].pSysMem);
+	else
+		m_pTexels = static_cast<const uint32_t*>(m_MipData[0].pSysMem);
+
+	m_pMappedFile = std::move(pMappedFile);
+	return true;
+}
+
+void Texture::Upload(ID3D11Device* pDevice)
+{
+	if (m_MipData.empty())
+		return;
 
 	D3D11_TEXTURE2D_DESC desc;
-	desc.Width = m_pSurface->w;
-	desc.Height = m_pSurface->h;
-	desc.MipLevels = 1;
+	desc.Width = m_Width;
+	desc.Height = m_Height;
+	desc.MipLevels = static_cast<UINT>(m_MipData.size());
 	desc.ArraySize = 1;
-	desc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+	desc.Format = BlockCompression::GetDXGIFormat(m_Format);
 	desc.SampleDesc.Count = 1;
 	desc.SampleDesc.Quality = 0;
 	desc.Usage = D3D11_USAGE_DEFAULT;
@@ -19,28 +134,22 @@ Texture::Texture(const std::string& filePath, ID3D11Device* pDevice)
 	desc.CPUAccessFlags = 0;
 	desc.MiscFlags = 0;
 
-	D3D11_SUBRESOURCE_DATA initData;
-	initData.pSysMem = m_pSurface->pixels;
-	initData.SysMemPitch = static_cast<UINT>(m_pSurface->pitch);
-	initData.SysMemSlicePitch = static_cast<UINT>(m_pSurface->h * m_pSurface->pitch);
-
-
-	HRESULT result = pDevice->CreateTexture2D(&desc, &initData, &m_pTexture);
+	HRESULT result = pDevice->CreateTexture2D(&desc, m_MipData.data(), &m_pTexture);
 	if (FAILED(result))
 	{
-		std::cout << "Error creating Texture2D with file " << filePath << std::endl;
+		std::cout << "Error creating Texture2D with file " << m_FilePath << std::endl;
 		return;
 	}
 
 	D3D11_SHADER_RESOURCE_VIEW_DESC SRVDesc{};
-	SRVDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+	SRVDesc.Format = desc.Format;
 	SRVDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
-	SRVDesc.Texture2D.MipLevels = 1;
+	SRVDesc.Texture2D.MipLevels = desc.MipLevels;
 
 	result = pDevice->CreateShaderResourceView(m_pTexture.Get(), &SRVDesc, &m_pTextureResourceView);
 	if (FAILED(result))
 	{
-		std::cout << "Error creating ShaderResourceView with file " << filePath << std::endl;
+		std::cout << "Error creating ShaderResourceView with file " << m_FilePath << std::endl;
 		return;
 	}
 }
@@ -60,18 +169,123 @@ ID3D11Texture2D* Texture::GetTexture() const
 	return m_pTexture.Get();
 }
 
+size_t Texture::GetCPUBytes() const
+{
+	if (m_pMappedFile)
+		return m_pMappedFile->GetSize();
+	if (m_pSurface)
+		return size_t(m_pSurface->pitch) * m_pSurface->h;
+	return 0;
+}
+
+size_t Texture::GetGPUBytes() const
+{
+	if (!m_pTexture)
+		return 0;
+
+	size_t bytes{};
+	for (const D3D11_SUBRESOURCE_DATA& mip : m_MipData)
+		bytes += mip.SysMemSlicePitch;
+	return bytes;
+}
+
+void Texture::SetAddressMode(AddressMode addressMode)
+{
+	m_AddressMode = addressMode;
+}
+
 Elite::RGBColor Texture::Sample(const Elite::FVector2& uv) const
 {
 	Uint8 r;
 	Uint8 g;
 	Uint8 b;
 
-	SDL_GetRGB(static_cast<uint32_t*>(m_pSurface->pixels)[PixelToIndex(uv)], m_pSurface->format, &r, &g, &b);
+	if (m_pSurface)
+	{
+		SDL_GetRGB(static_cast<uint32_t*>(m_pSurface->pixels)[PixelToIndex(uv)], m_pSurface->format, &r, &g, &b);
+		return Elite::RGBColor{ r / 255.f, g / 255.f, b / 255.f };
+	}
+
+	if (!m_pBlockData && !m_pTexels)
+		return Elite::RGBColor{};
+
+	uint32_t x, y;
+	PixelToTexel(uv, x, y);
+	const uint32_t texel{ m_pBlockData ? FetchBlockTexel(x, y) : m_pTexels[x + y * m_Width] };
+	r = static_cast<Uint8>(texel);
+	g = static_cast<Uint8>(texel >> 8);
+	b = static_cast<Uint8>(texel >> 16);
+
+	if (m_Format == TextureFormat::bc5)
+	{
+		// BC5 only stores x and y of the normal, rebuild z and pack it back into [0, 1]
+		const float nx{ r / 127.5f - 1.f };
+		const float ny{ g / 127.5f - 1.f };
+		const float nz{ sqrtf(std::max(1.f - nx * nx - ny * ny, 0.f)) };
+		return Elite::RGBColor{ r / 255.f, g / 255.f, (nz + 1.f) * 0.5f };
+	}
 
 	return Elite::RGBColor{ r / 255.f, g / 255.f, b / 255.f };
 }
 
 Uint32 Texture::PixelToIndex(const Elite::FVector2& uv) const
 {
-	return (Uint32(std::floor(uv.x * m_pSurface->w)) + Uint32(std::floor(uv.y * m_pSurface->h) * m_pSurface->w));
+	uint32_t x, y;
+	PixelToTexel(uv, x, y);
+	return x + y * m_Width;
+}
+
+void Texture::PixelToTexel(const Elite::FVector2& uv, uint32_t& x, uint32_t& y) const
+{
+	// Arithmetic shift of the fixed point value floors, also for negative UVs
+	const int64_t u{ static_cast<int64_t>(uv.x * m_FixedScaleU) >> m_FixedPointShift };
+	const int64_t v{ static_cast<int64_t>(uv.y * m_FixedScaleV) >> m_FixedPointShift };
+
+	x = AddressTexel(u, m_Width);
+	y = AddressTexel(v, m_Height);
+}
+
+uint32_t Texture::FetchBlockTexel(uint32_t x, uint32_t y) const
+{
+	const uint32_t blockIndex{ (y / BlockCompression::BlockDimension) * m_BlocksWide + x / BlockCompression::BlockDimension };
+	CachedBlock& cachedBlock{ g_BlockCache[((blockIndex << 2) + m_TextureId) & (g_BlockCacheSize - 1)] };
+
+	if (cachedBlock.textureId != m_TextureId || cachedBlock.blockIndex != blockIndex)
+	{
+		BlockCompression::DecodeBlock(m_Format, m_pBlockData + size_t(blockIndex) * BlockCompression::GetBlockSize(m_Format), cachedBlock.texels);
+		cachedBlock.textureId = m_TextureId;
+		cachedBlock.blockIndex = blockIndex;
+	}
+
+	return cachedBlock.texels[(y % BlockCompression::BlockDimension) * BlockCompression::BlockDimension + x % BlockCompression::BlockDimension];
+}
+
+uint32_t Texture::AddressTexel(int64_t texel, uint32_t size) const
+{
+	const int64_t signedSize{ static_cast<int64_t>(size) };
+
+	switch (m_AddressMode)
+	{
+	case AddressMode::wrap:
+		if (m_IsPowerOfTwo)
+			return static_cast<uint32_t>(texel & (signedSize - 1));
+		texel %= signedSize;
+		return static_cast<uint32_t>(texel < 0 ? texel + signedSize : texel);
+
+	case AddressMode::clamp:
+		return static_cast<uint32_t>(Elite::Clamp<int64_t>(texel, 0, signedSize - 1));
+
+	case AddressMode::mirror:
+	{
+		const int64_t period{ 2 * signedSize };
+		if (m_IsPowerOfTwo)
+			texel &= period - 1;
+		else
+			texel = (texel % period + period) % period;
+		return static_cast<uint32_t>(texel < signedSize ? texel : period - 1 - texel);
+	}
+
+	default:
+		return 0;
+	}
 }
@@ -1,9 +1,17 @@
 #pragma once
+#include <vector>
+#include "structs.h"
+
+class MappedFile;
 
 class Texture final
 {
 public:
-	Texture(const std::string& filePath, ID3D11Device* pDevice);
+	// Decodes the image on the CPU only, call Upload on the device thread to create the GPU resources.
+	// An up to date cooked .etex next to the image is mapped instead of decoding the image.
+	// Block compressed formats need the cooked file, without one the image is kept as RGBA8.
+	explicit Texture(const std::string& filePath, TextureFormat format = TextureFormat::rgba8, AddressMode addressMode = AddressMode::wrap);
+	Texture(const std::string& filePath, ID3D11Device* pDevice, TextureFormat format = TextureFormat::rgba8, AddressMode addressMode = AddressMode::wrap);
 	~Texture();
 
 	Texture(const Texture& other) noexcept = delete;
@@ -11,15 +19,59 @@ public:
 	Texture& operator=(const Texture& other) noexcept = delete;
 	Texture& operator=(Texture&& other) noexcept = delete;
 
+	void Upload(ID3D11Device* pDevice);
+
 	[[nodiscard]] ID3D11ShaderResourceView* GetResourceView() const;
 	[[nodiscard]] ID3D11Texture2D* GetTexture() const;
 
+	void SetAddressMode(AddressMode addressMode);
+	[[nodiscard]] AddressMode GetAddressMode() const { return m_AddressMode; }
+	[[nodiscard]] TextureFormat GetFormat() const { return m_Format; }
+	[[nodiscard]] const std::string& GetFilePath() const { return m_FilePath; }
+	// False when neither the cooked file nor the image could be loaded
+	[[nodiscard]] bool IsLoaded() const { return !m_MipData.empty(); }
+	// Hash::Fnv1a of the file the texture was decoded from, the image or the cooked .etex
+	[[nodiscard]] uint64_t GetSourceHash() const { return m_SourceHash; }
+
+	[[nodiscard]] size_t GetCPUBytes() const;
+	[[nodiscard]] size_t GetGPUBytes() const;
+
 	[[nodiscard]] Elite::RGBColor Sample(const Elite::FVector2& uv) const;
 	[[nodiscard]] Uint32 PixelToIndex(const Elite::FVector2& uv) const;
 
 private:
+	// UVs are converted to 16.16 fixed point so the integer texel is a shift away (no std::floor per sample)
+	static constexpr int m_FixedPointShift{ 16 };
+
 	ComPtr<ID3D11Texture2D> m_pTexture;
 	ComPtr<ID3D11ShaderResourceView> m_pTextureResourceView;
 	SDL_Surface* m_pSurface;
+	std::string m_FilePath;
+
+	// Block compressed formats only come from a cooked file, the blocks are decoded on demand when sampling
+	TextureFormat m_Format;
+	uint32_t m_BlocksWide;
+	uint32_t m_TextureId;
+	uint64_t m_SourceHash;
+
+	// Cooked textures are sampled and uploaded straight from the mapping, the pointers below point into it
+	unique_ptr<MappedFile> m_pMappedFile;
+	const uint8_t* m_pBlockData;
+	const uint32_t* m_pTexels;
+	std::vector<D3D11_SUBRESOURCE_DATA> m_MipData;
+
+	AddressMode m_AddressMode;
+	uint32_t m_Width;
+	uint32_t m_Height;
+	float m_FixedScaleU;
+	float m_FixedScaleV;
+	bool m_IsPowerOfTwo;
+
+	void LoadImage(const std::string& filePath);
+	[[nodiscard]] bool LoadCooked(const std::string& cookedPath);
+
+	void PixelToTexel(const Elite::FVector2& uv, uint32_t& x, uint32_t& y) const;
+	[[nodiscard]] uint32_t AddressTexel(int64_t texel, uint32_t size) const;
+	[[nodiscard]] uint32_t FetchBlockTexel(uint32_t x, uint32_t y) const;
 };
 
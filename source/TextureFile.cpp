@@ -0,0 +1,209 @@
+#include "pch.h"
+#include "TextureFile.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+#include "SDL_image.h"
+#include "BlockCompression.h"
+
+namespace
+{
+	// 2x2 box filter, odd dimensions repeat the last row or column
+	void Downsample(const std::vector<uint32_t>& source, uint32_t width, uint32_t height, std::vector<uint32_t>& destination)
+	{
+		const uint32_t mipWidth{ std::max(width / 2, 1u) };
+		const uint32_t mipHeight{ std::max(height / 2, 1u) };
+		destination.resize(size_t(mipWidth) * mipHeight);
+
+		for (uint32_t y{}; y < mipHeight; ++y)
+		{
+			const uint32_t y0{ std::min(y * 2, height - 1) };
+			const uint32_t y1{ std::min(y * 2 + 1, height - 1) };
+			for (uint32_t x{}; x < mipWidth; ++x)
+			{
+				const uint32_t x0{ std::min(x * 2, width - 1) };
+				const uint32_t x1{ std::min(x * 2 + 1, width - 1) };
+				const uint32_t texels[4]{ source[y0 * width + x0], source[y0 * width + x1], source[y1 * width + x0], source[y1 * width + x1] };
+
+				uint32_t result{};
+				for (uint32_t c{}; c < 4; ++c)
+				{
+					uint32_t sum{ 2 };
+					for (uint32_t texel : texels)
+						sum += (texel >> (c * 8)) & 0xFF;
+					result |= (sum / 4) << (c * 8);
+				}
+				destination[y * mipWidth + x] = result;
+			}
+		}
+	}
+
+	// Levels down to 1x1
+	uint32_t GetMaxMipCount(uint32_t width, uint32_t height)
+	{
+		uint32_t mipCount{ 1 };
+		for (uint32_t size{ std::max(width, height) }; size > 1; size /= 2)
+			++mipCount;
+		return mipCount;
+	}
+}
+
+std::string TextureFile::GetCookedPath(const std::string& sourcePath)
+{
+	return std::filesystem::path{ sourcePath }.replace_extension(".etex").string();
+}
+
+bool TextureFile::IsCookedUpToDate(const std::string& sourcePath)
+{
+	std::error_code error;
+	const auto cookedTime{ std::filesystem::last_write_time(GetCookedPath(sourcePath), error) };
+	if (error)
+		return false;
+
+	const auto sourceTime{ std::filesystem::last_write_time(sourcePath, error) };
+	return error || cookedTime >= sourceTime;
+}
+
+bool TextureFile::Parse(const uint8_t* pData, size_t size, const Header*& pHeader, const MipHeader*& pMips)
+{
+	if (size < sizeof(Header))
+		return false;
+
+	pHeader = reinterpret_cast<const Header*>(pData);
+	if (pHeader->magic != Magic || pHeader->version != Version || pHeader->format >= static_cast<uint32_t>(TextureFormat::SIZE))
+		return false;
+	if (pHeader->mipCount == 0 || size < sizeof(Header) + sizeof(MipHeader) * pHeader->mipCount)
+		return false;
+
+	const TextureFormat format{ static_cast<TextureFormat>(pHeader->format) };
+	uint32_t width{ pHeader->width };
+	uint32_t height{ pHeader->height };
+	if (width == 0 || height == 0 || pHeader->mipCount > GetMaxMipCount(width, height))
+		return false;
+
+	// Every level has to hold exactly what its dimensions need, the sampler and the upload index into it unchecked
+	pMips = reinterpret_cast<const MipHeader*>(pData + sizeof(Header));
+	for (uint32_t i{}; i < pHeader->mipCount; ++i)
+	{
+		uint64_t rowPitch{ uint64_t(width) * sizeof(uint32_t) };
+		uint64_t levelSize{ rowPitch * height };
+		if (BlockCompression::IsBlockCompressed(format))
+		{
+			rowPitch = uint64_t(BlockCompression::GetBlockCount(width)) * BlockCompression::GetBlockSize(format);
+			levelSize = rowPitch * BlockCompression::GetBlockCount(height);
+		}
+
+		if (pMips[i].rowPitch != rowPitch || pMips[i].size != levelSize || pMips[i].offset % DataAlignment != 0)
+			return false;
+		// offset + size could wrap around
+		if (pMips[i].offset > size || pMips[i].size > size - pMips[i].offset)
+			return false;
+
+		width = std::max(width / 2, 1u);
+		height = std::max(height / 2, 1u);
+	}
+	return true;
+}
+
+bool TextureFile::ParseFormat(const std::string& name, TextureFormat& format)
+{
+	constexpr const char* formatNames[]{ "rgba8", "bc1", "bc3", "bc5" };
+	for (uint32_t i{}; i < static_cast<uint32_t>(TextureFormat::SIZE); ++i)
+	{
+		if (name == formatNames[i])
+		{
+			format = static_cast<TextureFormat>(i);
+			return true;
+		}
+	}
+	return false;
+}
+
+bool TextureFile::Cook(const std::string& sourcePath, TextureFormat format)
+{
+	SDL_Surface* pSurface = IMG_Load(sourcePath.c_str());
+	if (!pSurface)
+	{
+		std::cout << "Error loading " << sourcePath << " for cooking" << std::endl;
+		return false;
+	}
+
+	SDL_Surface* pRGBASurface = SDL_ConvertSurfaceFormat(pSurface, SDL_PIXELFORMAT_RGBA32, 0);
+	SDL_FreeSurface(pSurface);
+	if (!pRGBASurface)
+	{
+		std::cout << "Error converting " << sourcePath << " to RGBA8" << std::endl;
+		return false;
+	}
+
+	uint32_t width{ static_cast<uint32_t>(pRGBASurface->w) };
+	uint32_t height{ static_cast<uint32_t>(pRGBASurface->h) };
+	std::vector<uint32_t> texels(size_t(width) * height);
+	for (uint32_t y{}; y < height; ++y)
+		std::memcpy(&texels[size_t(y) * width], static_cast<const uint8_t*>(pRGBASurface->pixels) + size_t(y) * pRGBASurface->pitch, width * sizeof(uint32_t));
+	SDL_FreeSurface(pRGBASurface);
+
+	// Same rule as the runtime conversion, D3D11 needs the top level of a BC texture to be a multiple of 4
+	if (BlockCompression::IsBlockCompressed(format) && (width % BlockCompression::BlockDimension != 0 || height % BlockCompression::BlockDimension != 0))
+	{
+		std::cout << "Texture " << sourcePath << " is not a multiple of 4 texels, cooking it as RGBA8" << std::endl;
+		format = TextureFormat::rgba8;
+	}
+
+	const Header header{ Magic, Version, width, height, static_cast<uint32_t>(format), GetMaxMipCount(width, height) };
+
+	std::vector<MipHeader> mips(header.mipCount);
+	std::vector<std::vector<uint8_t>> mipData(header.mipCount);
+	uint64_t offset{ sizeof(Header) + sizeof(MipHeader) * header.mipCount };
+
+	std::vector<uint32_t> nextTexels;
+	for (uint32_t level{}; level < header.mipCount; ++level)
+	{
+		if (BlockCompression::IsBlockCompressed(format))
+		{
+			BlockCompression::Encode(format, texels.data(), width, height, width, mipData[level]);
+			mips[level].rowPitch = BlockCompression::GetBlockCount(width) * BlockCompression::GetBlockSize(format);
+		}
+		else
+		{
+			mipData[level].resize(texels.size() * sizeof(uint32_t));
+			std::memcpy(mipData[level].data(), texels.data(), mipData[level].size());
+			mips[level].rowPitch = width * sizeof(uint32_t);
+		}
+
+		offset = (offset + DataAlignment - 1) / DataAlignment * DataAlignment;
+		mips[level].offset = offset;
+		mips[level].size = static_cast<uint32_t>(mipData[level].size());
+		offset += mips[level].size;
+
+		if (level + 1 < header.mipCount)
+		{
+			Downsample(texels, width, height, nextTexels);
+			texels.swap(nextTexels);
+			width = std::max(width / 2, 1u);
+			height = std::max(height / 2, 1u);
+		}
+	}
+
+	const std::string cookedPath{ GetCookedPath(sourcePath) };
+	std::ofstream file{ cookedPath, std::ios::binary };
+	if (!file.is_open())
+	{
+		std::cout << "Error opening " << cookedPath << " for writing" << std::endl;
+		return false;
+	}
+
+	file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+	file.write(reinterpret_cast<const char*>(mips.data()), sizeof(MipHeader) * mips.size());
+	for (uint32_t level{}; level < header.mipCount; ++level)
+	{
+		const std::streamoff padding{ static_cast<std::streamoff>(mips[level].offset) - file.tellp() };
+		const char zeros[DataAlignment]{};
+		file.write(zeros, padding);
+		file.write(reinterpret_cast<const char*>(mipData[level].data()), mipData[level].size());
+	}
+
+	std::cout << "Cooked " << sourcePath << " -> " << cookedPath << " (" << header.mipCount << " mips)" << std::endl;
+	return file.good();
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <string>
+#include "structs.h"
+
+// The .etex container: a header, one MipHeader per level and the level data in the exact layout the
+// texture uses at runtime (RGBA8 rows or BC blocks), so a loaded file can be sampled and uploaded in place.
+namespace TextureFile
+{
+	constexpr uint32_t Magic{ 0x58455445 }; // "ETEX"
+	constexpr uint32_t Version{ 1 };
+	constexpr uint32_t DataAlignment{ 16 };
+
+	struct Header
+	{
+		uint32_t magic;
+		uint32_t version;
+		uint32_t width;
+		uint32_t height;
+		uint32_t format;
+		uint32_t mipCount;
+	};
+
+	struct MipHeader
+	{
+		uint64_t offset;
+		uint32_t rowPitch;
+		uint32_t size;
+	};
+
+	// Resources/vehicle_diffuse.png -> Resources/vehicle_diffuse.etex
+	[[nodiscard]] std::string GetCookedPath(const std::string& sourcePath);
+	// True when the cooked file exists and is at least as recent as the source (or the source is gone)
+	[[nodiscard]] bool IsCookedUpToDate(const std::string& sourcePath);
+
+	// Validates the header and the mip table: every level lies inside the file and has exactly the size
+	// its dimensions and format need. pMips points into pData.
+	[[nodiscard]] bool Parse(const uint8_t* pData, size_t size, const Header*& pHeader, const MipHeader*& pMips);
+
+	[[nodiscard]] bool ParseFormat(const std::string& name, TextureFormat& format);
+
+	// Offline conversion: decodes the image, builds the full mip chain and writes it next to the source
+	bool Cook(const std::string& sourcePath, TextureFormat format);
+}
+
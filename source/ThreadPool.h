@@ -0,0 +1,119 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+class ThreadPool final
+{
+public:
+	explicit ThreadPool(uint32_t threadCount = std::max(std::thread::hardware_concurrency(), 2u) - 1);
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool(ThreadPool&&) noexcept = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+	ThreadPool& operator=(ThreadPool&&) noexcept = delete;
+
+	template<typename Function>
+	[[nodiscard]] std::future<std::invoke_result_t<Function>> Enqueue(Function&& function);
+
+	// Runs function(i) for every i in [0, count) on the calling thread and the idle workers, returns once all are done.
+	// The caller takes items too and never waits on a job that is still queued, so jobs of this pool can call it
+	// without deadlocking or starting more threads than the pool has. The first exception thrown is rethrown.
+	template<typename Function>
+	void ParallelFor(size_t count, const Function& function);
+
+	[[nodiscard]] uint32_t GetThreadCount() const { return static_cast<uint32_t>(m_Threads.size()); }
+
+private:
+	std::vector<std::thread> m_Threads;
+	std::queue<std::function<void()>> m_Jobs;
+	std::mutex m_Mutex;
+	std::condition_variable m_JobAvailable;
+	bool m_IsStopping;
+
+	void WorkerLoop();
+};
+
+template<typename Function>
+std::future<std::invoke_result_t<Function>> ThreadPool::Enqueue(Function&& function)
+{
+	// std::function needs a copyable callable, so the task lives in a shared_ptr
+	auto pTask = std::make_shared<std::packaged_task<std::invoke_result_t<Function>()>>(std::forward<Function>(function));
+	std::future<std::invoke_result_t<Function>> result = pTask->get_future();
+	{
+		std::lock_guard lock{ m_Mutex };
+		m_Jobs.emplace([pTask]() { (*pTask)(); });
+	}
+	m_JobAvailable.notify_one();
+	return result;
+}
+
+template<typename Function>
+void ThreadPool::ParallelFor(size_t count, const Function& function)
+{
+	if (count == 0)
+		return;
+
+	// Shared with the helper jobs, one that only starts after this returned finds no item left and never calls function
+	struct State
+	{
+		std::atomic<size_t> next;
+		std::atomic<size_t> done;
+		size_t count;
+		const Function* pFunction;
+		std::exception_ptr pError;
+		std::mutex mutex;
+		std::condition_variable finished;
+	};
+	auto pState = std::make_shared<State>();
+	pState->count = count;
+	pState->pFunction = &function;
+
+	const auto run = [](State& state)
+	{
+		for (size_t i{ state.next++ }; i < state.count; i = state.next++)
+		{
+			try
+			{
+				(*state.pFunction)(i);
+			}
+			catch (...)
+			{
+				std::lock_guard lock{ state.mutex };
+				if (!state.pError)
+					state.pError = std::current_exception();
+			}
+
+			if (++state.done == state.count)
+			{
+				std::lock_guard lock{ state.mutex };
+				state.finished.notify_all();
+			}
+		}
+	};
+
+	const size_t helperCount{ std::min<size_t>(count - 1, m_Threads.size()) };
+	if (helperCount > 0)
+	{
+		{
+			std::lock_guard lock{ m_Mutex };
+			for (size_t i{}; i < helperCount; ++i)
+				m_Jobs.emplace([pState, run]() { run(*pState); });
+		}
+		m_JobAvailable.notify_all();
+	}
+
+	run(*pState);
+
+	std::unique_lock lock{ pState->mutex };
+	pState->finished.wait(lock, [&pState]() { return pState->done == pState->count; });
+	if (pState->pError)
+		std::rethrow_exception(pState->pError);
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include "structs.h"
+
+// Eight Vertex_Input side by side, a register per component (see EMathBatch.h), for the stages that run on a batch of vertices
+struct Vertex_Input8
+{
+	Elite::FPoint4x8 Position{};
+	Elite::FVector2x8 UV{};
+	Elite::FVector3x8 Normal{};
+	Elite::FVector3x8 Tangent{};
+	Elite::FVector3x8 viewDirection{};
+};
+
+// Conversion between arrays of Vertex_Input and Vertex_Input8. A batch can hold fewer than 8 vertices:
+// loading repeats the last vertex in the lanes left over so they stay valid numbers, storing skips them.
+namespace VertexBatch
+{
+	constexpr uint32_t Size{ 8 };
+
+	namespace Detail
+	{
+		template<typename Getter>
+		inline Elite::FFloat8 Gather(const Vertex_Input* pVertices, uint32_t count, const Getter& get)
+		{
+			float lanes[Size];
+			for (uint32_t i{}; i < Size; ++i)
+				lanes[i] = get(pVertices[std::min(i, count - 1)]);
+			return Elite::FFloat8::Load(lanes);
+		}
+
+		template<typename Getter>
+		inline void Scatter(const Elite::FFloat8& values, Vertex_Input* pVertices, uint32_t count, const Getter& get)
+		{
+			float lanes[Size];
+			values.Store(lanes);
+			for (uint32_t i{}; i < count; ++i)
+				get(pVertices[i]) = lanes[i];
+		}
+	}
+
+	// count is 1 to 8
+	[[nodiscard]] inline Vertex_Input8 Load(const Vertex_Input* pVertices, uint32_t count)
+	{
+		using Detail::Gather;
+		Vertex_Input8 batch;
+		batch.Position = Elite::FPoint4x8{
+			Gather(pVertices, count, [](const Vertex_Input& v) { return v.Position.x; }),
+			Gather(pVertices, count, [](const Vertex_Input& v) { return v.Position.y; }),
+			Gather(pVertices, count, [](const Vertex_Input& v) { return v.Position.z; }),
+			Gather(pVertices, count, [](const Vertex_Input& v) { return v.Position.w; }) };
+		batch.UV = Elite::FVector2x8{
+			Gather(pVertices, count, [](const Vertex_Input& v) { return v.UV.x; }),
+			Gather(pVertices, count, [](const Vertex_Input& v) { return v.UV.y; }) };
+		batch.Normal = Elite::FVector3x8{
+			Gather(pVertices, count, [](const Vertex_Input& v) { return v.Normal.x; }),
+			Gather(pVertices, count, [](const Vertex_Input& v) { return v.Normal.y; }),
+			Gather(pVertices, count, [](const Vertex_Input& v) { return v.Normal.z; }) };
+		batch.Tangent = Elite::FVector3x8{
+			Gather(pVertices, count, [](const Vertex_Input& v) { return v.Tangent.x; }),
+			Gather(pVertices, count, [](const Vertex_Input& v) { return v.Tangent.y; }),
+			Gather(pVertices, count, [](const Vertex_Input& v) { return v.Tangent.z; }) };
+		batch.viewDirection = Elite::FVector3x8{
+			Gather(pVertices, count, [](const Vertex_Input& v) { return v.viewDirection.x; }),
+			Gather(pVertices, count, [](const Vertex_Input& v) { return v.viewDirection.y; }),
+			Gather(pVertices, count, [](const Vertex_Input& v) { return v.viewDirection.z; }) };
+		return batch;
+	}
+
+	// Writes the first count lanes, count is 1 to 8
+	inline void Store(const Vertex_Input8& batch, Vertex_Input* pVertices, uint32_t count)
+	{
+		using Detail::Scatter;
+		Scatter(batch.Position.x, pVertices, count, [](Vertex_Input& v) -> float& { return v.Position.x; });
+		Scatter(batch.Position.y, pVertices, count, [](Vertex_Input& v) -> float& { return v.Position.y; });
+		Scatter(batch.Position.z, pVertices, count, [](Vertex_Input& v) -> float& { return v.Position.z; });
+		Scatter(batch.Position.w, pVertices, count, [](Vertex_Input& v) -> float& { return v.Position.w; });
+		Scatter(batch.UV.x, pVertices, count, [](Vertex_Input& v) -> float& { return v.UV.x; });
+		Scatter(batch.UV.y, pVertices, count, [](Vertex_Input& v) -> float& { return v.UV.y; });
+		Scatter(batch.Normal.x, pVertices, count, [](Vertex_Input& v) -> float& { return v.Normal.x; });
+		Scatter(batch.Normal.y, pVertices, count, [](Vertex_Input& v) -> float& { return v.Normal.y; });
+		Scatter(batch.Normal.z, pVertices, count, [](Vertex_Input& v) -> float& { return v.Normal.z; });
+		Scatter(batch.Tangent.x, pVertices, count, [](Vertex_Input& v) -> float& { return v.Tangent.x; });
+		Scatter(batch.Tangent.y, pVertices, count, [](Vertex_Input& v) -> float& { return v.Tangent.y; });
+		Scatter(batch.Tangent.z, pVertices, count, [](Vertex_Input& v) -> float& { return v.Tangent.z; });
+		Scatter(batch.viewDirection.x, pVertices, count, [](Vertex_Input& v) -> float& { return v.viewDirection.x; });
+		Scatter(batch.viewDirection.y, pVertices, count, [](Vertex_Input& v) -> float& { return v.viewDirection.y; });
+		Scatter(batch.viewDirection.z, pVertices, count, [](Vertex_Input& v) -> float& { return v.viewDirection.z; });
+	}
+}
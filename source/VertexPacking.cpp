@@ -0,0 +1,163 @@
+#include "pch.h"
+#include "VertexPacking.h"
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+	constexpr float UnormMax{ 65535.0f };
+	constexpr float SnormMax{ 32767.0f };
+
+	float SignNotZero(float value)
+	{
+		return value >= 0.0f ? 1.0f : -1.0f;
+	}
+
+	uint16_t ToUnorm16(float value)
+	{
+		return static_cast<uint16_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * UnormMax));
+	}
+
+	int16_t ToSnorm16(float value)
+	{
+		return static_cast<int16_t>(std::lround(std::clamp(value, -1.0f, 1.0f) * SnormMax));
+	}
+
+	// Same conversion as DXGI_FORMAT_R16_SNORM, -32768 and -32767 both map to -1
+	float FromSnorm16(int16_t value)
+	{
+		return std::max(static_cast<float>(value) / SnormMax, -1.0f);
+	}
+
+	void PackDirection(const Elite::FVector3& direction, int16_t* pPacked)
+	{
+		const Elite::FVector2 encoded{ VertexPacking::EncodeOctahedral(direction) };
+		pPacked[0] = ToSnorm16(encoded.x);
+		pPacked[1] = ToSnorm16(encoded.y);
+	}
+
+	Elite::FVector3 UnpackDirection(const int16_t* pPacked)
+	{
+		return VertexPacking::DecodeOctahedral(Elite::FVector2{ FromSnorm16(pPacked[0]), FromSnorm16(pPacked[1]) });
+	}
+}
+
+Vertex_Packed VertexPacking::Pack(const Vertex_Input& vertex, const Elite::FPoint3& boundsMin, const Elite::FVector3& boundsExtent)
+{
+	Vertex_Packed packed{};
+	for (uint8_t axis{}; axis < 3; ++axis)
+	{
+		// A flat axis keeps every vertex on the minimum
+		const float scale{ boundsExtent[axis] > 0.0f ? 1.0f / boundsExtent[axis] : 0.0f };
+		packed.Position[axis] = ToUnorm16((vertex.Position[axis] - boundsMin[axis]) * scale);
+	}
+	packed.UV[0] = FloatToHalf(vertex.UV.x);
+	packed.UV[1] = FloatToHalf(vertex.UV.y);
+	PackDirection(vertex.Normal, packed.Normal);
+	PackDirection(vertex.Tangent, packed.Tangent);
+	return packed;
+}
+
+Vertex_Input VertexPacking::Unpack(const Vertex_Packed& vertex, const Elite::FPoint3& boundsMin, const Elite::FVector3& boundsExtent)
+{
+	Vertex_Input unpacked{};
+	for (uint8_t axis{}; axis < 3; ++axis)
+		unpacked.Position[axis] = boundsMin[axis] + static_cast<float>(vertex.Position[axis]) / UnormMax * boundsExtent[axis];
+	unpacked.Position.w = 1.0f;
+	unpacked.UV = Elite::FVector2{ HalfToFloat(vertex.UV[0]), HalfToFloat(vertex.UV[1]) };
+	unpacked.Normal = UnpackDirection(vertex.Normal);
+	unpacked.Tangent = UnpackDirection(vertex.Tangent);
+	return unpacked;
+}
+
+void VertexPacking::Pack(std::span<const Vertex_Input> vertices, const Elite::FPoint3& boundsMin, const Elite::FPoint3& boundsMax, std::vector<Vertex_Packed>& packedVertices)
+{
+	const Elite::FVector3 boundsExtent{ boundsMax - boundsMin };
+
+	packedVertices.resize(vertices.size());
+	for (size_t i{}; i < vertices.size(); ++i)
+		packedVertices[i] = Pack(vertices[i], boundsMin, boundsExtent);
+}
+
+uint16_t VertexPacking::FloatToHalf(float value)
+{
+	uint32_t bits;
+	std::memcpy(&bits, &value, sizeof(float));
+
+	const uint32_t sign{ (bits >> 16) & 0x8000 };
+	const int32_t exponent{ static_cast<int32_t>((bits >> 23) & 0xFF) - 127 + 15 };
+	uint32_t mantissa{ bits & 0x007FFFFF };
+
+	// NaN stays NaN, infinity and overflow clamp to infinity
+	if (((bits >> 23) & 0xFF) == 0xFF)
+		return static_cast<uint16_t>(sign | 0x7C00 | (mantissa ? 0x200 : 0));
+	if (exponent >= 31)
+		return static_cast<uint16_t>(sign | 0x7C00);
+
+	// Too small for a normal half, shift the implicit 1 into a denormal
+	if (exponent <= 0)
+	{
+		if (exponent < -10)
+			return static_cast<uint16_t>(sign);
+
+		mantissa |= 0x00800000;
+		const uint32_t shift{ static_cast<uint32_t>(14 - exponent) };
+		const uint32_t rounded{ (mantissa + (1u << (shift - 1)) - 1 + ((mantissa >> shift) & 1)) >> shift };
+		return static_cast<uint16_t>(sign | rounded);
+	}
+
+	// Round to nearest even, a mantissa carry correctly bumps the exponent
+	const uint32_t half{ (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13) };
+	const uint32_t rounded{ half + ((mantissa & 0x1FFF) > 0x1000 || ((mantissa & 0x1FFF) == 0x1000 && (half & 1))) };
+	return static_cast<uint16_t>(sign | rounded);
+}
+
+float VertexPacking::HalfToFloat(uint16_t value)
+{
+	const uint32_t sign{ static_cast<uint32_t>(value & 0x8000) << 16 };
+	const uint32_t exponent{ (static_cast<uint32_t>(value) >> 10) & 0x1F };
+	const uint32_t mantissa{ value & 0x03FFu };
+
+	uint32_t bits;
+	if (exponent == 0x1F)
+		bits = sign | 0x7F800000 | (mantissa << 13);
+	else if (exponent != 0)
+		bits = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+	else if (mantissa == 0)
+		bits = sign;
+	else
+	{
+		// Denormal, 2^-24 is exact in a float
+		const float denormal{ static_cast<float>(mantissa) * 5.9604644775390625e-8f };
+		return sign ? -denormal : denormal;
+	}
+
+	float result;
+	std::memcpy(&result, &bits, sizeof(float));
+	return result;
+}
+
+Elite::FVector2 VertexPacking::EncodeOctahedral(const Elite::FVector3& normal)
+{
+	const float length{ std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z) };
+	if (length <= 0.0f)
+		return Elite::FVector2{ 0.0f, 0.0f };
+
+	const float x{ normal.x / length };
+	const float y{ normal.y / length };
+	if (normal.z >= 0.0f)
+		return Elite::FVector2{ x, y };
+
+	return Elite::FVector2{ (1.0f - std::abs(y)) * SignNotZero(x), (1.0f - std::abs(x)) * SignNotZero(y) };
+}
+
+Elite::FVector3 VertexPacking::DecodeOctahedral(const Elite::FVector2& encoded)
+{
+	Elite::FVector3 normal{ encoded.x, encoded.y, 1.0f - std::abs(encoded.x) - std::abs(encoded.y) };
+
+	// Unfold the lower hemisphere, same branchless form as the shader
+	const float fold{ std::max(-normal.z, 0.0f) };
+	normal.x += normal.x >= 0.0f ? -fold : fold;
+	normal.y += normal.y >= 0.0f ? -fold : fold;
+	return Elite::GetNormalized(normal);
+}
@@ -0,0 +1,21 @@
+#pragma once
+#include <span>
+#include <vector>
+#include "structs.h"
+
+// Conversion between Vertex_Input (60 bytes) and Vertex_Packed (20 bytes).
+// The same decoding runs in VS_PACKED (PosCol3D.fx, FireFX.fx) and in the software vertex fetch.
+namespace VertexPacking
+{
+	// Positions are stored relative to the bounds, both vertex paths need the bounds to decode
+	[[nodiscard]] Vertex_Packed Pack(const Vertex_Input& vertex, const Elite::FPoint3& boundsMin, const Elite::FVector3& boundsExtent);
+	[[nodiscard]] Vertex_Input Unpack(const Vertex_Packed& vertex, const Elite::FPoint3& boundsMin, const Elite::FVector3& boundsExtent);
+	void Pack(std::span<const Vertex_Input> vertices, const Elite::FPoint3& boundsMin, const Elite::FPoint3& boundsMax, std::vector<Vertex_Packed>& packedVertices);
+
+	[[nodiscard]] uint16_t FloatToHalf(float value);
+	[[nodiscard]] float HalfToFloat(uint16_t value);
+	// Unit vector to the [-1, 1] square, the lower hemisphere is folded over the diagonals
+	[[nodiscard]] Elite::FVector2 EncodeOctahedral(const Elite::FVector3& normal);
+	[[nodiscard]] Elite::FVector3 DecodeOctahedral(const Elite::FVector2& encoded);
+}
+
@@ -13,7 +13,20 @@
 #include "ERenderer.h"
 
 //My includes
+#include <chrono>
+#include <cstring>
+#include "Bvh.h"
 #include "ECamera.h"
+#include "EFastMath.h"
+#include "TextureFile.h"
+#include "EObjParser.h"
+#include "Mesh.h"
+#include "MeshOptimizer.h"
+#include "OcclusionBuffer.h"
+#include "RenderQueue.h"
+#include "Scene.h"
+#include "ThreadPool.h"
+#include "VertexBatch.h"
 
 void ShutDown(SDL_Window* pWindow)
 {
@@ -24,14 +37,482 @@ void ShutDown(SDL_Window* pWindow)
 void DisplayControls()
 {
 	using std::cout, std::endl;
-	cout << "Controls:\n\tSwitch Renderer: E\n\tSwitch CullMode: C\n\tSwitch SampleFilter: F\n\tToggle Rotation: R\n\tToggle FireFX (DirectX only): T" << endl;
+	cout << "Controls:\n\tSwitch Renderer: E\n\tSwitch CullMode: C\n\tSwitch SampleFilter: F\n\tToggle Rotation: R\n\tToggle FireFX (DirectX only): T\n\tSwitch VertexFormat: V\n\tStream in a Vehicle: L\n\tToggle Meshlet Culling (Software only): M\n\tSpawn a Fleet of Vehicles: K\n\tToggle Occlusion Culling (DirectX only): O\n\tToggle Fast Math (Software only): X" << endl;
+}
+
+// Offline texture conversion, writes a .etex next to every image: --cook <image> <rgba8|bc1|bc3|bc5> [<image> <format> ...]
+int CookTextures(int argc, char* args[])
+{
+	if (argc == 0 || argc % 2 != 0)
+	{
+		std::cout << "Usage: --cook <image> <rgba8|bc1|bc3|bc5> [<image> <format> ...]" << std::endl;
+		return 1;
+	}
+
+	bool isSucceeded = true;
+	for (int i{}; i < argc; i += 2)
+	{
+		TextureFormat format;
+		if (!TextureFile::ParseFormat(args[i + 1], format))
+		{
+			std::cout << "Unknown texture format " << args[i + 1] << std::endl;
+			isSucceeded = false;
+			continue;
+		}
+
+		if (!TextureFile::Cook(args[i], format))
+			isSucceeded = false;
+	}
+	return isSucceeded ? 0 : 1;
+}
+
+// Occlusion culling without a window or GPU, a mesh in front of rows of copies of it: --bench-occlusion <obj> [rows]
+int BenchmarkOcclusion(const std::string& filePath, uint32_t rows)
+{
+	Mesh mesh{ filePath, Elite::FVector3{ 0.f, 0.f, 50.f } };
+	if (mesh.GetLodCount() == 0)
+	{
+		std::cout << "Error loading " << filePath << " for benchmarking" << std::endl;
+		return 1;
+	}
+
+	// Laid out like a fleet spawned in the viewer, every instance can occlude
+	constexpr uint32_t columns{ 32 };
+	constexpr float spacing{ 20.f };
+	Scene scene;
+	const uint32_t material{ scene.AddMaterial(Material{}) };
+	scene.SetOccluder(scene.AddInstance(&mesh, material, mesh.GetPosition()), true);
+	for (uint32_t i{}; i < columns * rows; ++i)
+	{
+		const float column{ float(i % columns) - float(columns - 1) / 2.f };
+		const float row{ float(i / columns + 1) };
+		scene.SetOccluder(scene.AddInstance(&mesh, material, mesh.GetPosition() + Elite::FVector3{ column * spacing, 0.f, row * spacing }), true);
+	}
+
+	const Elite::Camera camera{ 640.f, 480.f };
+	ThreadPool threadPool;
+	RenderQueue queue;
+	OcclusionBuffer occlusionBuffer{ &threadPool };
+
+	constexpr uint32_t frames{ 100 };
+	for (const bool isOcclusionCulling : { false, true })
+	{
+		const auto start{ std::chrono::steady_clock::now() };
+		for (uint32_t i{}; i < frames; ++i)
+		{
+			queue.Build(scene, camera);
+			if (isOcclusionCulling)
+			{
+				occlusionBuffer.BeginCull(queue, CullMode::backface);
+				occlusionBuffer.EndCull(queue);
+			}
+		}
+		const float seconds{ std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count() / frames };
+
+		std::cout << "Occlusion culling " << (isOcclusionCulling ? "ON: " : "OFF: ") << queue.GetWorldMatrices().size() << " instances in "
+			<< queue.GetBatches().size() << " draws, " << queue.GetCulledCount() << " culled, " << queue.GetOccludedCount() << " occluded, "
+			<< seconds * 1000.f << " ms" << std::endl;
+	}
+	return 0;
+}
+
+// The BVH frustum cull against testing every box, for 1k, 10k, ... up to maxCount random boxes around the camera,
+// once after Build and once after moving a tenth of them: --bench-bvh [maxCount]
+int BenchmarkBvh(uint32_t maxCount)
+{
+	uint32_t seed{ 1 };
+	const auto random{ [&seed]() { seed = seed * 1664525u + 1013904223u; return float(seed >> 8) / float(1 << 24); } };
+	const auto randomBounds{ [&random]()
+	{
+		const Elite::FPoint3 min{ random() * 200.f - 100.f, random() * 200.f - 100.f, random() * 200.f - 100.f };
+		return Bvh::Bounds{ min, min + Elite::FVector3{ random() * 2.f, random() * 2.f, random() * 2.f } };
+	} };
+
+	const Elite::Camera camera{ 640.f, 480.f };
+	const Elite::FVector4* pPlanes{ camera.GetFrustumPlanes() };
+	// Same arithmetic as the BVH, in the same order, so both agree on boxes that just touch a plane
+	const auto isOutside{ [pPlanes](const Bvh::Bounds& bounds)
+	{
+		const Elite::FVector3 center{ (bounds.min.x + bounds.max.x) * 0.5f, (bounds.min.y + bounds.max.y) * 0.5f, (bounds.min.z + bounds.max.z) * 0.5f };
+		const Elite::FVector3 extent{ (bounds.max.x - bounds.min.x) * 0.5f, (bounds.max.y - bounds.min.y) * 0.5f, (bounds.max.z - bounds.min.z) * 0.5f };
+		for (uint32_t i{}; i < 6; ++i)
+		{
+			const Elite::FVector4& plane{ pPlanes[i] };
+			const float distance{ (plane.x * center.x + plane.y * center.y) + (plane.z * center.z + plane.w) };
+			const float reach{ (std::abs(plane.x) * extent.x + std::abs(plane.y) * extent.y) + std::abs(plane.z) * extent.z };
+			if (distance + reach < 0.f)
+				return true;
+		}
+		return false;
+	} };
+
+	// 64 bits so the last step past maxCount can't wrap around, every size run still fits the uint32_t items
+	bool isSucceeded{ true };
+	for (uint64_t count{ 1000 }; count <= maxCount; count *= 10)
+	{
+		std::vector<Bvh::Bounds> bounds(count);
+		for (Bvh::Bounds& box : bounds)
+			box = randomBounds();
+
+		Bvh bvh;
+		auto start{ std::chrono::steady_clock::now() };
+		bvh.Build(bounds);
+		const float buildMs{ std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count() };
+
+		float refitMs{};
+		for (const bool isMoved : { false, true })
+		{
+			if (isMoved)
+			{
+				for (uint32_t i{}; i < count; i += 10)
+					bounds[i] = randomBounds();
+				start = std::chrono::steady_clock::now();
+				for (uint32_t i{}; i < count; i += 10)
+					bvh.Update(i, bounds[i]);
+				bvh.Refit();
+				refitMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+			}
+
+			std::vector<uint32_t> items;
+			start = std::chrono::steady_clock::now();
+			bvh.Cull(pPlanes, items);
+			const float cullMs{ std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count() };
+
+			std::vector<uint32_t> expected;
+			start = std::chrono::steady_clock::now();
+			for (uint32_t i{}; i < count; ++i)
+			{
+				if (!isOutside(bounds[i]))
+					expected.push_back(i);
+			}
+			const float bruteForceMs{ std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count() };
+
+			std::sort(items.begin(), items.end());
+			const bool isMatching{ items == expected };
+			isSucceeded = isSucceeded && isMatching;
+			std::cout << count << " boxes" << (isMoved ? " (10% moved): " : ": ") << items.size() << " visible, "
+				<< (isMatching ? "matches" : "DIFFERS FROM") << " brute force (" << expected.size() << "), "
+				<< (isMoved ? "refit " : "build ") << (isMoved ? refitMs : buildMs) << " ms, cull " << cullMs << " ms, brute force " << bruteForceMs << " ms" << std::endl;
+		}
+	}
+	return isSucceeded ? 0 : 1;
+}
+
+// The float math against the plain templates in double, then its speed, then the same for the fast math of the
+// software pixel loop against the exact functions, and the batch masks and vertex batches against scalar results.
+// Exits with 1 when a batch differs: --bench-math [iterations]
+// Build with ELITE_MATH_SCALAR defined for the timings of the templates in float.
+int BenchmarkMath(uint32_t iterations)
+{
+	using namespace Elite;
+#ifdef ELITE_MATH_USE_SIMD
+	std::cout << "Float math: SIMD" << std::endl;
+#else
+	std::cout << "Float math: scalar" << std::endl;
+#endif
+
+	// Shifted diagonal so every matrix is well away from singular
+	constexpr uint32_t count{ 1024 };
+	uint32_t seed{ 1 };
+	const auto random{ [&seed]() { seed = seed * 1664525u + 1013904223u; return float(seed >> 8) / float(1 << 24) * 4.f - 2.f; } };
+	std::vector<FMatrix4> matrices(count);
+	std::vector<FPoint4> points(count);
+	for (uint32_t i{}; i < count; ++i)
+	{
+		for (int c{}; c < 4; ++c)
+		{
+			for (int r{}; r < 4; ++r)
+				matrices[i].data[c][r] = random() + (c == r ? 4.f : 0.f);
+		}
+		points[i] = FPoint4{ random(), random(), random() };
+	}
+
+	const auto toDouble{ [](const FMatrix4& m)
+	{
+		DMatrix4 d;
+		for (int c{}; c < 4; ++c)
+		{
+			for (int r{}; r < 4; ++r)
+				d.data[c][r] = m.data[c][r];
+		}
+		return d;
+	} };
+	double multiplyError{}, inverseError{}, transposeError{}, transformError{};
+	for (uint32_t i{}; i < count; ++i)
+	{
+		FMatrix4 lm{ matrices[i] };
+		const FMatrix4& rm{ matrices[(i + 1) % count] };
+		DMatrix4 dlm{ toDouble(lm) };
+		const DMatrix4 product{ dlm * toDouble(rm) };
+		const DMatrix4 inverse{ Inverse(dlm) };
+		const FMatrix4 fProduct{ lm * rm };
+		const FMatrix4 fInverse{ Inverse(lm) };
+		const FMatrix4 fTranspose{ Transpose(lm) };
+		for (int c{}; c < 4; ++c)
+		{
+			for (int r{}; r < 4; ++r)
+			{
+				multiplyError = std::max(multiplyError, std::abs(fProduct.data[c][r] - product.data[c][r]));
+				inverseError = std::max(inverseError, std::abs(fInverse.data[c][r] - inverse.data[c][r]));
+				transposeError = std::max(transposeError, double(std::abs(fTranspose.data[c][r] - lm.data[r][c])));
+			}
+		}
+
+		const FPoint4& p{ points[i] };
+		const DPoint4 transformed{ dlm * DPoint4{ p.x, p.y, p.z, p.w } };
+		const FPoint4 fTransformed{ lm * p };
+		for (int j{}; j < 4; ++j)
+			transformError = std::max(transformError, std::abs(fTransformed.data[j] - transformed.data[j]));
+	}
+	std::cout << "Largest error against double: multiply " << multiplyError << ", inverse " << inverseError << ", transpose " << transposeError
+		<< ", transform " << transformError << std::endl;
+
+	const auto measure{ [iterations](const char* pName, const auto& operation)
+	{
+		const auto start{ std::chrono::steady_clock::now() };
+		for (uint32_t i{}; i < iterations; ++i)
+			operation(i);
+		const float nanoseconds{ std::chrono::duration<float, std::nano>(std::chrono::steady_clock::now() - start).count() / (float(iterations) * count) };
+		std::cout << pName << ": " << nanoseconds << " ns" << std::endl;
+	} };
+
+	// Written back so none of it is optimized away
+	std::vector<FMatrix4> results(count);
+	std::vector<FPoint4> transformedPoints(count);
+	measure("Multiply", [&](uint32_t iteration)
+	{
+		for (uint32_t i{}; i < count; ++i)
+			results[i] = matrices[i] * matrices[(i + iteration) % count];
+	});
+	measure("Inverse", [&](uint32_t iteration)
+	{
+		for (uint32_t i{}; i < count; ++i)
+			results[i] = Inverse(matrices[(i + iteration) % count]);
+	});
+	measure("Transform", [&](uint32_t iteration)
+	{
+		FMatrix4 m{ matrices[iteration % count] };
+		for (uint32_t i{}; i < count; ++i)
+			transformedPoints[i] = m * points[i];
+	});
+
+	// Relative errors, the specular power at the highest exponent of the pixel shader
+	double rsqrtError{}, reciprocalError{}, powError{};
+	for (uint32_t i{ 1 }; i <= 1000000; ++i)
+	{
+		const float x{ float(i) * 1e-6f };
+		const double exactRsqrt{ 1.0 / std::sqrt(double(x)) };
+		const double exactPow{ std::pow(double(x), 25.0) };
+		rsqrtError = std::max(rsqrtError, std::abs(FastRsqrt(x) - exactRsqrt) / exactRsqrt);
+		reciprocalError = std::max(reciprocalError, std::abs(FastReciprocal(x) - 1.0 / x) * x);
+		if (exactPow > 1e-30)
+			powError = std::max(powError, std::abs(FastPow(x, 25.f) - exactPow) / exactPow);
+	}
+	std::cout << "Largest relative error of the fast math on (0, 1]: rsqrt " << rsqrtError << ", reciprocal " << reciprocalError
+		<< ", pow(x, 25) " << powError << std::endl;
+
+	std::vector<float> values(count);
+	std::vector<float> fastValues(count);
+	for (uint32_t i{}; i < count; ++i)
+		values[i] = float(i + 1) / count;
+	measure("powf", [&](uint32_t iteration)
+	{
+		const float exponent{ float(iteration % 25 + 1) };
+		for (uint32_t i{}; i < count; ++i)
+			fastValues[i] = std::powf(values[i], exponent);
+	});
+	measure("FastPow", [&](uint32_t iteration)
+	{
+		const float exponent{ float(iteration % 25 + 1) };
+		for (uint32_t i{}; i < count; ++i)
+			fastValues[i] = FastPow(values[i], exponent);
+	});
+	measure("GetNormalized", [&](uint32_t)
+	{
+		for (uint32_t i{}; i < count; ++i)
+			transformedPoints[i].xyz = FPoint3{ GetNormalized(FVector3{ points[i].xyz }) };
+	});
+	measure("GetNormalizedFast", [&](uint32_t)
+	{
+		for (uint32_t i{}; i < count; ++i)
+			transformedPoints[i].xyz = FPoint3{ GetNormalizedFast(FVector3{ points[i].xyz }) };
+	});
+
+	// The color math of the software pixel shader, from the material samples to the packed pixel
+	const auto random01{ [&random]() { return random() * 0.25f + 0.5f; } };
+	std::vector<RGBColor> diffuse(count), specular(count);
+	std::vector<float> lambert(count), highlight(count);
+	std::vector<float> diffuseChannels(count * 3), specularChannels(count * 3); // r, g and b blocks, for the batches
+	for (uint32_t i{}; i < count; ++i)
+	{
+		diffuse[i] = RGBColor{ random01(), random01(), random01() };
+		specular[i] = RGBColor{ random01(), random01(), random01() };
+		lambert[i] = random01() * 2.f;
+		highlight[i] = random01();
+		for (uint32_t channel{}; channel < 3; ++channel)
+		{
+			diffuseChannels[channel * count + i] = (&diffuse[i].r)[channel];
+			specularChannels[channel * count + i] = (&specular[i].r)[channel];
+		}
+	}
+	constexpr RGBColor radiance{ RGBColor{ 1.f, 1.f, 1.f } * (7.f / float(E_PI)) };
+	constexpr RGBColor ambient{ 0.025f, 0.025f, 0.025f };
+
+	std::vector<uint32_t> pixels(count), simdPixels(count), batchPixels(count);
+	const auto shade{ [&](std::vector<uint32_t>& output)
+	{
+		for (uint32_t i{}; i < count; ++i)
+		{
+			RGBColor color{ diffuse[i] * (radiance * lambert[i]) + ambient };
+			color += specular[i] * highlight[i];
+			color.MaxToOne();
+			output[i] = GetSDL_ARGBColor(color);
+		}
+	} };
+	const auto shadeSimd{ [&](std::vector<uint32_t>& output)
+	{
+		for (uint32_t i{}; i < count; ++i)
+		{
+			RGBColor4 color{ MultiplyAdd(diffuse[i], RGBColor4{ radiance } * lambert[i], ambient) };
+			color = MultiplyAdd(specular[i], highlight[i], color);
+			color.MaxToOne();
+			output[i] = GetSDL_ARGBColor(color);
+		}
+	} };
+	const auto shadeBatch{ [&](std::vector<uint32_t>& output)
+	{
+		for (uint32_t i{}; i < count; i += 8)
+		{
+			const RGBColorx8 diffuse8{ FFloat8::Load(&diffuseChannels[i]), FFloat8::Load(&diffuseChannels[count + i]), FFloat8::Load(&diffuseChannels[2 * count + i]) };
+			const RGBColorx8 specular8{ FFloat8::Load(&specularChannels[i]), FFloat8::Load(&specularChannels[count + i]), FFloat8::Load(&specularChannels[2 * count + i]) };
+			RGBColorx8 color{ MultiplyAdd(diffuse8, RGBColorx8{ radiance } * FFloat8::Load(&lambert[i]), RGBColorx8{ ambient }) };
+			color = MultiplyAdd(specular8, FFloat8::Load(&highlight[i]), color);
+			color.MaxToOne();
+			GetSDL_ARGBColor(color, &output[i]);
+		}
+	} };
+
+	// Only the rounding of the fused multiply-adds differs, that can move a channel by one step
+	shade(pixels);
+	shadeSimd(simdPixels);
+	shadeBatch(batchPixels);
+	int colorError{};
+	for (uint32_t i{}; i < count; ++i)
+	{
+		for (int shift{}; shift < 24; shift += 8)
+		{
+			const int channel{ int(pixels[i] >> shift & 0xFF) };
+			colorError = std::max({ colorError, std::abs(int(simdPixels[i] >> shift & 0xFF) - channel), std::abs(int(batchPixels[i] >> shift & 0xFF) - channel) });
+		}
+	}
+	std::cout << "Largest channel difference of the SIMD colors: " << colorError << std::endl;
+
+	// Masks and Select lane by lane against the scalar comparisons, equal lanes included so <= and == get both answers
+	uint32_t maskErrors{};
+	for (uint32_t i{}; i < count; ++i)
+	{
+		float lhs[8], rhs[8], selected[8];
+		int lessBits{}, lessEqualBits{};
+		for (int lane{}; lane < 8; ++lane)
+		{
+			lhs[lane] = float(int(random() * 2.f));
+			rhs[lane] = float(int(random() * 2.f));
+			lessBits |= int(lhs[lane] < rhs[lane]) << lane;
+			lessEqualBits |= int(lhs[lane] <= rhs[lane]) << lane;
+		}
+		const FFloat8 lhs8{ FFloat8::Load(lhs) };
+		const FFloat8 rhs8{ FFloat8::Load(rhs) };
+		const FMask8 isLess{ lhs8 < rhs8 };
+		const FMask8 isLessEqual{ lhs8 <= rhs8 };
+		if (GetBits(isLess) != lessBits || GetBits(!isLess) != (~lessBits & 0xFF) || GetBits(!!isLess) != lessBits
+			|| GetBits(isLess & !isLessEqual) != 0 || GetBits(isLess | !isLessEqual) != (lessBits | (~lessEqualBits & 0xFF))
+			|| Any(isLess) != (lessBits != 0) || All(isLessEqual) != (lessEqualBits == 0xFF) || !All(isLessEqual | !isLessEqual))
+		{
+			++maskErrors;
+		}
+
+		Select(isLess, lhs8, rhs8).Store(selected);
+		for (int lane{}; lane < 8; ++lane)
+		{
+			if (selected[lane] != (lhs[lane] < rhs[lane] ? lhs[lane] : rhs[lane]))
+				++maskErrors;
+		}
+	}
+
+	// Vertices through a batch and back, full and partial: the lanes past count repeat the last vertex, storing leaves
+	// the vertices past count alone
+	uint32_t vertexErrors{};
+	std::vector<Vertex_Input> vertices(VertexBatch::Size);
+	for (Vertex_Input& vertex : vertices)
+	{
+		vertex.Position = FPoint4{ random(), random(), random(), random() };
+		vertex.UV = FVector2{ random(), random() };
+		vertex.Normal = FVector3{ random(), random(), random() };
+		vertex.Tangent = FVector3{ random(), random(), random() };
+		vertex.viewDirection = FVector3{ random(), random(), random() };
+	}
+	// Bit for bit, the operator== of the math types allows a few ulps
+	const auto isEqual{ [](const Vertex_Input& lhs, const Vertex_Input& rhs)
+	{
+		return std::memcmp(&lhs.Position, &rhs.Position, sizeof(lhs.Position)) == 0 && std::memcmp(&lhs.UV, &rhs.UV, sizeof(lhs.UV)) == 0
+			&& std::memcmp(&lhs.Normal, &rhs.Normal, sizeof(lhs.Normal)) == 0 && std::memcmp(&lhs.Tangent, &rhs.Tangent, sizeof(lhs.Tangent)) == 0
+			&& std::memcmp(&lhs.viewDirection, &rhs.viewDirection, sizeof(lhs.viewDirection)) == 0;
+	} };
+	for (const uint32_t batchCount : { 1u, 5u, 8u })
+	{
+		const Vertex_Input8 batch{ VertexBatch::Load(vertices.data(), batchCount) };
+
+		std::vector<Vertex_Input> lanes(VertexBatch::Size);
+		VertexBatch::Store(batch, lanes.data(), VertexBatch::Size);
+		for (uint32_t lane{}; lane < VertexBatch::Size; ++lane)
+		{
+			if (!isEqual(lanes[lane], vertices[std::min(lane, batchCount - 1)]))
+				++vertexErrors;
+		}
+
+		std::vector<Vertex_Input> stored(VertexBatch::Size);
+		VertexBatch::Store(batch, stored.data(), batchCount);
+		for (uint32_t i{}; i < VertexBatch::Size; ++i)
+		{
+			if (!isEqual(stored[i], i < batchCount ? vertices[i] : Vertex_Input{}))
+				++vertexErrors;
+		}
+	}
+	std::cout << "Batch mismatches against scalar: masks and Select " << maskErrors << ", vertex round trip " << vertexErrors << std::endl;
+
+	measure("Shade RGBColor", [&](uint32_t) { shade(pixels); });
+	measure("Shade RGBColor4", [&](uint32_t) { shadeSimd(simdPixels); });
+	measure("Shade RGBColorx8", [&](uint32_t) { shadeBatch(batchPixels); });
+	return maskErrors == 0 && vertexErrors == 0 ? 0 : 1;
 }
 
 int main(int argc, char* args[])
 {
-	//Unreferenced parameters
-	(void)argc;
-	(void)args;
+	if (argc > 1 && std::string{ args[1] } == "--cook")
+		return CookTextures(argc - 2, args + 2);
+
+	// Parse throughput of the OBJ parsers: --bench-obj <file> [iterations]
+	if (argc > 2 && std::string{ args[1] } == "--bench-obj")
+	{
+		Elite::BenchmarkOBJParser(args[2], argc > 3 ? static_cast<uint32_t>(std::max(std::atoi(args[3]), 1)) : 10);
+		return 0;
+	}
+
+	// Vertex cache and overdraw statistics of the mesh optimizer: --bench-optimizer <file>
+	if (argc > 2 && std::string{ args[1] } == "--bench-optimizer")
+	{
+		MeshOptimizer::Benchmark(args[2]);
+		return 0;
+	}
+
+	if (argc > 2 && std::string{ args[1] } == "--bench-occlusion")
+		return BenchmarkOcclusion(args[2], argc > 3 ? static_cast<uint32_t>(std::max(std::atoi(args[3]), 0)) : 8);
+
+	if (argc > 1 && std::string{ args[1] } == "--bench-bvh")
+		return BenchmarkBvh(argc > 2 ? static_cast<uint32_t>(std::max(std::atoi(args[2]), 1000)) : 1000000);
+
+	if (argc > 1 && std::string{ args[1] } == "--bench-math")
+		return BenchmarkMath(argc > 2 ? static_cast<uint32_t>(std::max(std::atoi(args[2]), 1)) : 1000);
 
 	//Create window + surfaces
 	SDL_Init(SDL_INIT_VIDEO);
@@ -95,6 +576,30 @@ int main(int argc, char* args[])
 						pRenderer->ToggleFireFX();
 						break;
 
+					case SDL_SCANCODE_V:
+						pRenderer->SwitchVertexFormat();
+						break;
+
+					case SDL_SCANCODE_L:
+						pRenderer->StreamVehicle();
+						break;
+
+					case SDL_SCANCODE_M:
+						pRenderer->ToggleMeshletCulling();
+						break;
+
+					case SDL_SCANCODE_K:
+						pRenderer->SpawnFleet();
+						break;
+
+					case SDL_SCANCODE_O:
+						pRenderer->ToggleOcclusionCulling();
+						break;
+
+					case SDL_SCANCODE_X:
+						pRenderer->ToggleFastMath();
+						break;
+
 					default:
 						break;
 					}
@@ -112,6 +617,7 @@ int main(int argc, char* args[])
 		{
 			printTimer = 0.f;
 			std::cout << "FPS: " << pTimer->GetFPS() << std::endl;
+			pRenderer->PrintStatistics();
 		}
 
 		//--------- Update ---------
@@ -19,6 +19,7 @@
 //Elite headers
 #include "EMath.h"
 #include "ERGBColor.h"
+#include "ERGBColorSIMD.h"
 
 //Smart Pointers
 #include <memory>
@@ -9,11 +9,44 @@ struct Vertex_Input
 	Elite::FVector3 viewDirection{};
 };
 
+// Compact layout of Vertex_Input, see VertexPacking for the encoding.
+// Position is unorm16 relative to the mesh bounds (w unused), UV is half float, normal and tangent are octahedral snorm16.
+struct Vertex_Packed
+{
+	uint16_t Position[4]{};
+	uint16_t UV[2]{};
+	int16_t Normal[2]{};
+	int16_t Tangent[2]{};
+};
+static_assert(sizeof(Vertex_Packed) == 20, "Vertex_Packed must match the packed D3D input layout");
+
+// One level of detail, a range of the index buffer. Every level indexes the same vertices, level 0 is the full mesh.
+struct MeshLod
+{
+	uint32_t indexOffset{};
+	uint32_t indexCount{};
+};
+
 enum class SampleMode
 {
 	point, linear, anisotropic, SIZE
 };
 
+enum class AddressMode
+{
+	wrap, clamp, mirror, SIZE
+};
+
+enum class TextureFormat
+{
+	rgba8, bc1, bc3, bc5, SIZE
+};
+
+enum class VertexFormat
+{
+	full, packed, SIZE
+};
+
 enum class CullMode
 {
 	backface, frontface, none, SIZE